@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Catalog.h"
+#include "Cart.h"
+
+static const size_t CATALOG_SIZE = 10000;
+
+// Builds a catalog where every fourth item is sold by weight and every
+// eighth carries a discount
+static void fillCatalog( Catalog& catalog, std::vector<std::string>& skus )
+{
+    char buffer[32];
+
+    for(size_t i = 0; i < CATALOG_SIZE; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+
+        if(i % 4 == 0)
+        {
+            catalog.setPerPoundPrice( skus[i], 2.49 );
+        }
+        else
+        {
+            catalog.setItemPrice( skus[i], 1.00 + (i % 50) * 0.10 );
+            if(i % 8 == 1)
+            {
+                catalog.applyGetXForYDiscount( skus[i], 3, 2.00 );
+            }
+        }
+    }
+}
+
+// A basket where most items appear on several records, as with orders that
+// list each unit separately
+static std::vector<ScanRecord> makeBasket( const std::vector<std::string>& skus, size_t count )
+{
+    std::vector<ScanRecord> records;
+    std::mt19937 generator( 42 );
+    std::uniform_int_distribution<size_t> distribution( 0, count / 4 );
+
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t item = distribution( generator ) * 7 % CATALOG_SIZE;
+        if(item % 4 == 0)
+        {
+            records.push_back( { skus[item], INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 0.5 } );
+        }
+        else
+        {
+            records.push_back( { skus[item], INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 } );
+        }
+    }
+
+    return records;
+}
+
+static void BM_SingleScans( benchmark::State& state )
+{
+    Catalog catalog;
+    std::vector<std::string> skus;
+    fillCatalog( catalog, skus );
+    std::vector<ScanRecord> records = makeBasket( skus, static_cast<size_t>( state.range(0) ) );
+
+    for(auto _ : state)
+    {
+        Cart cart( catalog );
+        for(const ScanRecord& record : records)
+        {
+            if(record.type == FIXED_PRICE_ITEM)
+            {
+                cart.addToCart( record.sku, static_cast<int>( record.amount ) );
+            }
+            else
+            {
+                cart.addToCart( record.sku, record.amount );
+            }
+        }
+        benchmark::DoNotOptimize( cart.getPreTaxTotalMoney() );
+    }
+}
+
+static void BM_BatchScan( benchmark::State& state )
+{
+    Catalog catalog;
+    std::vector<std::string> skus;
+    fillCatalog( catalog, skus );
+    std::vector<ScanRecord> records = makeBasket( skus, static_cast<size_t>( state.range(0) ) );
+    std::vector<ReturnCode_t> codes( records.size() );
+
+    for(auto _ : state)
+    {
+        Cart cart( catalog );
+        cart.addToCartBatch( records.data(), records.size(), codes.data() );
+        benchmark::DoNotOptimize( cart.getPreTaxTotalMoney() );
+    }
+}
+
+BENCHMARK(BM_SingleScans)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_BatchScan)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Catalog.h"
+#include "Cart.h"
+
+static const size_t CATALOG_SIZE = 300000;
+static const size_t BASKET_SIZE = 50;
+
+// Configures a full catalog through the API, as a lane does when it starts
+static void fillCatalog( Catalog& catalog, std::vector<std::string>& skus )
+{
+    char buffer[32];
+
+    for(size_t i = 0; i < CATALOG_SIZE; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+
+        if(i % 4 == 0)
+        {
+            catalog.setPerPoundPrice( skus[i], 2.49 );
+        }
+        else
+        {
+            catalog.setItemPrice( skus[i], 1.00 + (i % 50) * 0.10 );
+        }
+    }
+}
+
+// Prices a small basket, which is all a lane needs before serving its first customer
+static Money priceBasket( const Catalog& catalog, const std::vector<std::string>& skus )
+{
+    Cart cart( catalog );
+
+    for(size_t i = 0; i < BASKET_SIZE; i++)
+    {
+        size_t position = (i * 104729) % CATALOG_SIZE;
+        if(position % 4 == 0)
+        {
+            cart.addToCart( skus[position], 1.5 );
+        }
+        else
+        {
+            cart.addToCart( skus[position], 1 );
+        }
+    }
+
+    return cart.getPreTaxTotalMoney();
+}
+
+static void BM_StartupFromApiCalls( benchmark::State& state )
+{
+    for(auto _ : state)
+    {
+        Catalog catalog;
+        std::vector<std::string> skus;
+
+        fillCatalog( catalog, skus );
+        benchmark::DoNotOptimize( priceBasket( catalog, skus ) );
+    }
+}
+
+static void BM_StartupFromImage( benchmark::State& state )
+{
+    std::string path = "catalog_image_bench.bin";
+    std::vector<std::string> skus;
+    {
+        Catalog catalog;
+        fillCatalog( catalog, skus );
+        catalog.saveImage( path );
+    }
+
+    for(auto _ : state)
+    {
+        Catalog catalog;
+
+        catalog.openImage( path );
+        benchmark::DoNotOptimize( priceBasket( catalog, skus ) );
+    }
+
+    std::remove( path.c_str() );
+}
+
+BENCHMARK(BM_StartupFromApiCalls)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartupFromImage)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "Catalog.h"
+#include "CatalogLoader.h"
+
+// Builds a price file where every fourth item is sold by weight and every
+// eighth carries a discount, the same mix as the scanning benchmarks
+static std::string makePriceFile( size_t count )
+{
+    std::string contents;
+    char buffer[96];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(i % 4 == 0)
+        {
+            std::snprintf( buffer, sizeof(buffer), "0%011zu,lb,2.49\n", i * 7919 );
+        }
+        else if(i % 8 == 1)
+        {
+            std::snprintf( buffer, sizeof(buffer), "0%011zu,each,%.2f,,xfor,3,2.00\n", i * 7919, 1.00 + (i % 50) * 0.10 );
+        }
+        else
+        {
+            std::snprintf( buffer, sizeof(buffer), "0%011zu,each,%.2f\n", i * 7919, 1.00 + (i % 50) * 0.10 );
+        }
+
+        contents += buffer;
+    }
+
+    return contents;
+}
+
+// Configures the catalog one call at a time from the contents of a price file
+static void BM_CallPerSetting( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    std::string contents = makePriceFile( count );
+
+    for(auto _ : state)
+    {
+        Catalog catalog;
+        std::istringstream input( contents );
+        std::string line;
+        char sku[32];
+        char type[8];
+        double price = 0;
+
+        while(std::getline( input, line ))
+        {
+            std::sscanf( line.c_str(), "%31[^,],%7[^,],%lf", sku, type, &price );
+            if(type[0] == 'l')
+            {
+                catalog.setPerPoundPrice( sku, price );
+            }
+            else
+            {
+                catalog.setItemPrice( sku, price );
+                if(line.find( "xfor" ) != std::string::npos)
+                {
+                    catalog.applyGetXForYDiscount( sku, 3, 2.00 );
+                }
+            }
+        }
+        benchmark::DoNotOptimize( catalog.resolveSku( "000000000000" ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() * count );
+}
+
+static void BM_CatalogLoader( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    std::string contents = makePriceFile( count );
+
+    for(auto _ : state)
+    {
+        Catalog catalog;
+        CatalogLoader loader( catalog );
+        std::istringstream input( contents );
+
+        loader.setThreadCount( static_cast<unsigned>( state.range(1) ) );
+        loader.loadStream( input, 0 );
+        benchmark::DoNotOptimize( catalog.resolveSku( "000000000000" ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() * count );
+}
+
+BENCHMARK(BM_CallPerSetting)->Arg(10000)->Arg(300000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CatalogLoader)->ArgsProduct({ { 10000, 300000 }, { 1, 4 } })->Unit(benchmark::kMillisecond);
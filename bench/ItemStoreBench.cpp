@@ -0,0 +1,188 @@
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "CartItem.h"
+#include "ItemStore.h"
+#include "PricingKernel.h"
+
+// Every eighth item carries a discount, the rest are sold at their price
+static CatalogItem<int> makeItem( size_t i )
+{
+    CatalogItem<int> item;
+
+    item.setPrice( 1.00 + (i % 100) * 0.25 );
+    if(i % 8 == 0)
+    {
+        item.applyBuyXGetYDiscount( 2, 1, 0.5 );
+    }
+
+    return item;
+}
+
+// Baseline matching the previous layout, where the total was found by walking
+// a map of SKUs to separately allocated cart items
+static void BM_MapOfPointersTotal( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    std::map<std::string, CartItem<int>*> items;
+    char buffer[32];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+
+        CartItem<int>* item = new CartItem<int>();
+        item->setPrice( 1.00 + (i % 100) * 0.25 );
+        if(i % 8 == 0)
+        {
+            item->applyBuyXGetYDiscount( 2, 1, 0.5 );
+        }
+        item->addToCart( static_cast<int>( i % 5 ) + 1 );
+
+        items[buffer] = item;
+    }
+
+    for(auto _ : state)
+    {
+        double total = 0.0;
+        for(auto& entry : items)
+        {
+            double line = 0.0;
+            entry.second->computePreTax( &line );
+            total += line;
+        }
+        benchmark::DoNotOptimize( total );
+    }
+
+    for(auto& entry : items)
+    {
+        delete entry.second;
+    }
+}
+
+// The second argument selects the pricing kernel, unsupported kernels fall back to scalar
+static void BM_ItemStoreTotal( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    PricingKernel_t kernel = static_cast<PricingKernel_t>( state.range(1) );
+    ItemStore<int> items;
+    std::vector<Quantity> amounts( count );
+    std::vector<Money> totals( count );
+
+    for(size_t i = 0; i < count; i++)
+    {
+        items.append( makeItem(i) );
+        amounts[i] = static_cast<Quantity>( i % 5 ) + 1;
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( items.computeTotals( amounts.data(), totals.data(), count, kernel ) );
+    }
+
+    if(!isPricingKernelSupported( kernel ))
+    {
+        state.SetLabel( "unsupported, ran scalar" );
+    }
+}
+
+// Weight based items need their cost rounded to the Money unit, which the scalar
+// kernel does with a 128 bit division for every line
+static void BM_ItemStoreWeightTotal( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    PricingKernel_t kernel = static_cast<PricingKernel_t>( state.range(1) );
+    ItemStore<double> items;
+    std::vector<Quantity> amounts( count );
+    std::vector<Money> totals( count );
+
+    for(size_t i = 0; i < count; i++)
+    {
+        CatalogItem<double> item;
+        item.setPrice( 1.99 + (i % 100) * 0.25 );
+        if(i % 8 == 0)
+        {
+            item.applyBuyXGetYDiscount( 2.0, 1.0, 0.5 );
+        }
+
+        items.append( item );
+        amounts[i] = static_cast<Quantity>( 250 + (i % 37) * 113 );
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( items.computeTotals( amounts.data(), totals.data(), count, kernel ) );
+    }
+
+    if(!isPricingKernelSupported( kernel ))
+    {
+        state.SetLabel( "unsupported, ran scalar" );
+    }
+}
+
+// Pricing single lines of discounted items as they are scanned, with the first argument giving the
+// number of items given a price table of 32 counts. Every line is within the table range.
+static void BM_ItemStoreLinePreTax( benchmark::State& state )
+{
+    const size_t count = 4096;
+    ItemStore<int> items;
+
+    items.setPriceTables( 32, static_cast<size_t>( state.range(0) ) );
+    for(size_t i = 0; i < count; i++)
+    {
+        CatalogItem<int> item;
+        item.setPrice( 1.00 + (i % 100) * 0.25 );
+        if(i % 2 == 0)
+        {
+            item.applyBuyXGetYDiscount( 2, 1, 0.5, 12 );
+        }
+        else
+        {
+            item.applyGetXforPriceDiscount( 3, 2.00 + (i % 100) * 0.5, 9 );
+        }
+        items.append( item );
+    }
+
+    uint32_t index = 0;
+    Quantity amount = 0;
+    Money line = 0;
+    for(auto _ : state)
+    {
+        index = (index + 2731) % count;
+        amount = (amount + 7) % 33;
+        items.computePreTax( index, amount, &line );
+        benchmark::DoNotOptimize( line );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+}
+
+// Pricing a single line of an item offering a limited bundle, an unlimited bundle and a buy x get y
+// discount together, for the given amount
+static void BM_StackedLinePreTax( benchmark::State& state )
+{
+    ItemStore<int> items;
+    CatalogItem<int> item;
+
+    item.setPrice( 1.99 );
+    item.addGetXforPriceDiscount( 3, 5.00, 9 );
+    item.addGetXforPriceDiscount( 4, 6.99 );
+    item.addBuyXGetYDiscount( 2, 1, 0.5 );
+    items.append( item );
+
+    Money line = 0;
+    for(auto _ : state)
+    {
+        items.computePreTax( 0, state.range(0), &line );
+        benchmark::DoNotOptimize( line );
+    }
+}
+
+BENCHMARK(BM_MapOfPointersTotal)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_ItemStoreTotal)->ArgsProduct({ { 1000, 10000, 100000 }, { SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL } });
+BENCHMARK(BM_ItemStoreWeightTotal)->ArgsProduct({ { 1000, 10000, 100000 }, { SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL } });
+BENCHMARK(BM_ItemStoreLinePreTax)->Arg(0)->Arg(4096);
+BENCHMARK(BM_StackedLinePreTax)->Arg(4)->Arg(100)->Arg(10000)->Arg(1000000);
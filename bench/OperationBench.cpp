@@ -0,0 +1,229 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Types.h"
+#include "CartItem.h"
+#include "PointOfSale.h"
+
+// Per call costs of the public API, kept stable so that the JSON output of one release can be compared with the next
+
+static std::vector<std::string> makeSkus( size_t count )
+{
+    std::vector<std::string> skus;
+    char buffer[32];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+    }
+
+    return skus;
+}
+
+// Amount scanned for each type of item, a count of items or a weight in pounds
+template <class T>
+static T scanAmount();
+
+template <>
+int scanAmount<int>()
+{
+    return 1;
+}
+
+template <>
+double scanAmount<double>()
+{
+    return 1.25;
+}
+
+// Prices an item of the given type, with the given discount
+template <class T>
+static void configureItem( PointOfSale& sale, const std::string& sku, DiscountType_t discount );
+
+template <>
+void configureItem<int>( PointOfSale& sale, const std::string& sku, DiscountType_t discount )
+{
+    sale.setItemPrice( sku, 1.99 );
+    if(discount == X_FOR_FLAT)
+    {
+        sale.applyGetXForYDiscount( sku, 3, 5.00, 9 );
+    }
+    else if(discount == BUY_X_GET_Y_FOR_Z_LIMIT_W)
+    {
+        sale.applyBuyXGetYAtDiscount( sku, 2, 1, 0.5, 6 );
+    }
+}
+
+template <>
+void configureItem<double>( PointOfSale& sale, const std::string& sku, DiscountType_t discount )
+{
+    // bundles for a flat price are only offered on fixed price items by PointOfSale
+    sale.setPerPoundPrice( sku, 3.49 );
+    if(discount == BUY_X_GET_Y_FOR_Z_LIMIT_W)
+    {
+        sale.applyBuyXGetYAtDiscount( sku, 2.0, 1.0, 0.5, 6.0 );
+    }
+}
+
+// Setting the price of a new SKU, building a catalog of the given size from empty
+static void BM_SetItemPriceNew( benchmark::State& state )
+{
+    std::vector<std::string> skus = makeSkus( static_cast<size_t>( state.range(0) ) );
+
+    for(auto _ : state)
+    {
+        PointOfSale sale;
+        for(const std::string& sku : skus)
+        {
+            sale.setItemPrice( sku, 1.99 );
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+// Changing the price of a SKU already in a catalog of the given size
+static void BM_SetItemPriceUpdate( benchmark::State& state )
+{
+    std::vector<std::string> skus = makeSkus( static_cast<size_t>( state.range(0) ) );
+    PointOfSale sale;
+    for(const std::string& sku : skus)
+    {
+        sale.setItemPrice( sku, 1.99 );
+    }
+
+    size_t position = 0;
+    for(auto _ : state)
+    {
+        position = (position + 104729) % skus.size();
+        benchmark::DoNotOptimize( sale.setItemPrice( skus[position], 2.49 ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+}
+
+// Adding an item to, and removing it from, a cart already holding the given number of lines
+template <class T>
+static void BM_AddRemove( benchmark::State& state )
+{
+    size_t lines = static_cast<size_t>( state.range(0) );
+    DiscountType_t discount = static_cast<DiscountType_t>( state.range(1) );
+    std::vector<std::string> skus = makeSkus( lines + 1 );
+    PointOfSale sale;
+
+    for(size_t i = 0; i < skus.size(); i++)
+    {
+        configureItem<T>( sale, skus[i], discount );
+        if(i < lines)
+        {
+            sale.addToCart( skus[i], scanAmount<T>() );
+        }
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( sale.addToCart( skus[lines], scanAmount<T>() ) );
+        benchmark::DoNotOptimize( sale.removeFromCart( skus[lines], scanAmount<T>() ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() * 2 );
+}
+
+// Totalling a cart of the given number of lines, each scanned several times so that its discount applies
+template <class T>
+static void BM_PreTaxTotal( benchmark::State& state )
+{
+    size_t lines = static_cast<size_t>( state.range(0) );
+    DiscountType_t discount = static_cast<DiscountType_t>( state.range(1) );
+    std::vector<std::string> skus = makeSkus( lines );
+    PointOfSale sale;
+
+    for(const std::string& sku : skus)
+    {
+        configureItem<T>( sale, sku, discount );
+        for(int scan = 0; scan < 4; scan++)
+        {
+            sale.addToCart( sku, scanAmount<T>() );
+        }
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( sale.getPreTaxTotal() );
+    }
+}
+
+// Scanning a whole cart of the given number of lines into a new transaction and totalling it
+template <class T>
+static void BM_CheckoutTotal( benchmark::State& state )
+{
+    size_t lines = static_cast<size_t>( state.range(0) );
+    DiscountType_t discount = static_cast<DiscountType_t>( state.range(1) );
+    std::vector<std::string> skus = makeSkus( lines );
+    PointOfSale sale;
+
+    for(const std::string& sku : skus)
+    {
+        configureItem<T>( sale, sku, discount );
+    }
+
+    for(auto _ : state)
+    {
+        sale.newTransaction();
+        for(int scan = 0; scan < 4; scan++)
+        {
+            for(const std::string& sku : skus)
+            {
+                sale.addToCart( sku, scanAmount<T>() );
+            }
+        }
+        benchmark::DoNotOptimize( sale.getPreTaxTotal() );
+    }
+
+    state.SetItemsProcessed( state.iterations() * lines * 4 );
+}
+
+// Pricing a single line of the cart, for the given amount in the cart and discount
+template <class T>
+static void BM_LinePreTax( benchmark::State& state )
+{
+    DiscountType_t discount = static_cast<DiscountType_t>( state.range(1) );
+    CartItem<T> item;
+
+    item.setPrice( 1.99 );
+    if(discount == X_FOR_FLAT)
+    {
+        item.applyGetXforPriceDiscount( 3 * scanAmount<T>(), 5.00, 9 * scanAmount<T>() );
+    }
+    else if(discount == BUY_X_GET_Y_FOR_Z_LIMIT_W)
+    {
+        item.applyBuyXGetYDiscount( 2 * scanAmount<T>(), 1 * scanAmount<T>(), 0.5, 6 * scanAmount<T>() );
+    }
+    item.addToCart( static_cast<T>( state.range(0) ) * scanAmount<T>() );
+
+    double total = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( item.computePreTax( &total ) );
+        benchmark::DoNotOptimize( total );
+    }
+}
+
+BENCHMARK(BM_SetItemPriceNew)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SetItemPriceUpdate)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+BENCHMARK_TEMPLATE(BM_AddRemove, int)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, X_FOR_FLAT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
+BENCHMARK_TEMPLATE(BM_AddRemove, double)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
+
+BENCHMARK_TEMPLATE(BM_PreTaxTotal, int)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, X_FOR_FLAT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
+BENCHMARK_TEMPLATE(BM_PreTaxTotal, double)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
+
+BENCHMARK_TEMPLATE(BM_CheckoutTotal, int)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, X_FOR_FLAT, BUY_X_GET_Y_FOR_Z_LIMIT_W } })->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CheckoutTotal, double)->ArgsProduct({ { 1, 100, 10000 }, { NO_DISCOUNT, BUY_X_GET_Y_FOR_Z_LIMIT_W } })->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(BM_LinePreTax, int)->ArgsProduct({ { 1, 1000, 1000000 }, { NO_DISCOUNT, X_FOR_FLAT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
+BENCHMARK_TEMPLATE(BM_LinePreTax, double)->ArgsProduct({ { 1, 1000, 1000000 }, { NO_DISCOUNT, X_FOR_FLAT, BUY_X_GET_Y_FOR_Z_LIMIT_W } });
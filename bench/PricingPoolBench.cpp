@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Catalog.h"
+#include "StoreEngine.h"
+#include "PricingPool.h"
+
+static const size_t CATALOG_SIZE = 10000;
+static const size_t BASKET_SIZE = 40;
+static const size_t BATCH_BURST = 2000;
+
+static std::shared_ptr<Catalog> makeCatalog( std::vector<ScanRecord>* pBasket )
+{
+    std::shared_ptr<Catalog> catalog = std::make_shared<Catalog>();
+    char buffer[32];
+
+    for(size_t i = 0; i < CATALOG_SIZE; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        catalog->setItemPrice( buffer, 1.00 + (i % 50) * 0.10 );
+    }
+
+    for(size_t i = 0; i < BASKET_SIZE; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", ((i * 104729) % CATALOG_SIZE) * 7919 );
+        pBasket->push_back( { "", catalog->resolveSku( buffer ), FIXED_PRICE_ITEM, 1.0 } );
+    }
+
+    return catalog;
+}
+
+// Time taken for one cart to be priced when it is queued behind a burst of batch carts, with the
+// cart given the priority passed as the argument
+static void BM_CartLatencyBehindBatchBurst( benchmark::State& state )
+{
+    std::vector<ScanRecord> basket;
+    StoreEngine engine( makeCatalog( &basket ) );
+    PricingPool pool( engine, 2 );
+    TaskPriority_t priority = static_cast<TaskPriority_t>( state.range(0) );
+
+    std::vector<ReturnCode_t> codes( BASKET_SIZE * BATCH_BURST );
+    std::vector<Money> totals( BATCH_BURST );
+    ReturnCode_t probe_codes[BASKET_SIZE];
+
+    for(auto _ : state)
+    {
+        for(size_t i = 0; i < BATCH_BURST; i++)
+        {
+            pool.submitCart( basket.data(), basket.size(), &codes[i * BASKET_SIZE], &totals[i], BATCH_PRIORITY );
+        }
+
+        // the time is taken by the worker, so it does not include waking this thread afterwards
+        std::chrono::steady_clock::time_point priced;
+        auto start = std::chrono::steady_clock::now();
+        pool.submit( [&]( Lane& lane )
+        {
+            lane.addToCartBatch( basket.data(), basket.size(), probe_codes );
+            benchmark::DoNotOptimize( lane.getPreTaxTotalMoney() );
+            priced = std::chrono::steady_clock::now();
+        }, priority );
+
+        pool.wait();
+        state.SetIterationTime( std::chrono::duration_cast<std::chrono::duration<double>>( priced - start ).count() );
+    }
+}
+
+BENCHMARK(BM_CartLatencyBehindBatchBurst)->Arg(INTERACTIVE_PRIORITY)->Arg(BATCH_PRIORITY)->UseManualTime()->Unit(benchmark::kMicrosecond);
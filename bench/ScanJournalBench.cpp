@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "PointOfSale.h"
+
+static const size_t CATALOG_SIZE = 1000;
+
+static std::vector<std::string> configure( PointOfSale& sale )
+{
+    std::vector<std::string> skus;
+    char buffer[32];
+
+    for(size_t i = 0; i < CATALOG_SIZE; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+        sale.setItemPrice( skus.back(), 1.00 + (i % 50) * 0.10 );
+    }
+
+    return skus;
+}
+
+// Cost of one scan with no journal, given -1, or with a journal using the given durability window in
+// microseconds. A window of zero flushes every scan to the disk before the scan returns.
+static void BM_JournaledScan( benchmark::State& state )
+{
+    std::string path = "/tmp/pos_scan_journal_bench.bin";
+    std::remove( path.c_str() );
+
+    PointOfSale sale;
+    std::vector<std::string> skus = configure( sale );
+    if(state.range(0) >= 0 && sale.openJournal( path, std::chrono::microseconds( state.range(0) ) ) != OK)
+    {
+        state.SkipWithError( "journal could not be opened" );
+        return;
+    }
+
+    size_t position = 0;
+    size_t scans = 0;
+    for(auto _ : state)
+    {
+        position = (position + 104729) % skus.size();
+        sale.addToCart( skus[position], 1 );
+
+        // a basket of 40 items per customer keeps the journal the size it is in a store
+        if(++scans % 40 == 0)
+        {
+            sale.newTransaction();
+        }
+    }
+
+    state.SetItemsProcessed( state.iterations() );
+    std::remove( path.c_str() );
+}
+
+BENCHMARK(BM_JournaledScan)->Arg(-1)->Arg(2000)->Arg(0);
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "SkuIndex.h"
+
+// Builds the SKU strings for a catalog of the given size
+static std::vector<std::string> makeSkus( size_t count )
+{
+    std::vector<std::string> skus;
+    char buffer[32];
+
+    skus.reserve( count );
+    for(size_t i = 0; i < count; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+    }
+
+    return skus;
+}
+
+// Produces the order in which SKUs are scanned during the benchmark
+static std::vector<size_t> makeScanOrder( size_t count )
+{
+    std::vector<size_t> order( 4096 );
+    std::mt19937 generator( 42 );
+    std::uniform_int_distribution<size_t> distribution( 0, count - 1 );
+
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = distribution( generator );
+    }
+
+    return order;
+}
+
+// Baseline matching the previous layout, where every lookup searched the
+// fixed price map and the weight based map
+static void BM_TwoMapLookup( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    std::vector<std::string> skus = makeSkus( count );
+    std::vector<size_t> order = makeScanOrder( count );
+    std::map<std::string, int*> fixed_items;
+    std::map<std::string, double*> weight_items;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if(i % 4 == 0)
+        {
+            weight_items[skus[i]] = 0;
+        }
+        else
+        {
+            fixed_items[skus[i]] = 0;
+        }
+    }
+
+    size_t next = 0;
+    for(auto _ : state)
+    {
+        const std::string& sku = skus[order[next++ & 4095]];
+        benchmark::DoNotOptimize( fixed_items.find(sku) );
+        benchmark::DoNotOptimize( weight_items.find(sku) );
+    }
+}
+
+static void BM_SkuIndexLookup( benchmark::State& state )
+{
+    size_t count = static_cast<size_t>( state.range(0) );
+    std::vector<std::string> skus = makeSkus( count );
+    std::vector<size_t> order = makeScanOrder( count );
+    SkuIndex index;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        SkuEntry entry = { (i % 4 == 0) ? WEIGHT_BASED_ITEM : FIXED_PRICE_ITEM, static_cast<uint32_t>(i) };
+        index.insert( skus[i], entry );
+    }
+
+    size_t next = 0;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize( index.find( skus[order[next++ & 4095]] ) );
+    }
+}
+
+BENCHMARK(BM_TwoMapLookup)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK(BM_SkuIndexLookup)->Arg(10000)->Arg(100000)->Arg(1000000);
@@ -0,0 +1,76 @@
+#include <cstdio>
+
+#include <unistd.h>
+
+#include "benchmark/benchmark.h"
+#include "PointOfSale.h"
+
+static const int ITEMS_PER_SALE = 16;
+
+// Reads the resident set size of the process in kilobytes, or zero when it can not be read
+static double residentKilobytes()
+{
+    long pages = 0;
+    long resident = 0;
+
+    FILE* file = std::fopen( "/proc/self/statm", "r" );
+    if(file == 0)
+    {
+        return 0;
+    }
+
+    if(std::fscanf( file, "%ld %ld", &pages, &resident ) != 2)
+    {
+        resident = 0;
+    }
+    std::fclose( file );
+
+    return resident * (sysconf( _SC_PAGESIZE ) / 1024.0);
+}
+
+// Creates, uses and destroys a complete PointOfSale on every iteration, as a
+// long running lane does for each customer. The resident set size should be
+// the same at the end of the run as it is after the first few cycles.
+static void BM_PointOfSaleSoak( benchmark::State& state )
+{
+    char skus[ITEMS_PER_SALE][16];
+    double rss_start = 0;
+    size_t cycles = 0;
+
+    for(int i = 0; i < ITEMS_PER_SALE; i++)
+    {
+        std::snprintf( skus[i], sizeof(skus[i]), "0%011d", i * 7919 );
+    }
+
+    for(auto _ : state)
+    {
+        PointOfSale sale;
+
+        for(int i = 0; i < ITEMS_PER_SALE; i++)
+        {
+            if(i % 4 == 0)
+            {
+                sale.setPerPoundPrice( skus[i], 2.49 );
+                sale.addToCart( skus[i], 1.5 );
+            }
+            else
+            {
+                sale.setItemPrice( skus[i], 1.00 + i * 0.10 );
+                sale.applyGetXForYDiscount( skus[i], 3, 2.00 );
+                sale.addToCart( skus[i], 4 );
+            }
+        }
+        benchmark::DoNotOptimize( sale.getPreTaxTotal() );
+
+        // measure once the allocator has settled after the first cycles
+        if(++cycles == 1000)
+        {
+            rss_start = residentKilobytes();
+        }
+    }
+
+    state.counters["rss_start_kb"] = rss_start;
+    state.counters["rss_end_kb"] = residentKilobytes();
+}
+
+BENCHMARK(BM_PointOfSaleSoak)->Iterations(1000000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Catalog.h"
+#include "StoreEngine.h"
+
+static const size_t CATALOG_SIZE = 100000;
+static const size_t BASKET_SIZE = 40;
+
+// Handles of the catalog used by every lane, where every fourth item is sold by weight
+struct SharedStore
+{
+    std::unique_ptr<StoreEngine> engine;
+    std::vector<SkuHandle> handles;
+};
+
+// Built once by whichever benchmark thread gets here first
+static const SharedStore& sharedStore()
+{
+    static SharedStore store = []()
+    {
+        SharedStore result;
+        std::shared_ptr<Catalog> catalog = std::make_shared<Catalog>();
+        char buffer[32];
+
+        for(size_t i = 0; i < CATALOG_SIZE; i++)
+        {
+            std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+            if(i % 4 == 0)
+            {
+                catalog->setPerPoundPrice( buffer, 2.49 );
+            }
+            else
+            {
+                catalog->setItemPrice( buffer, 1.00 + (i % 50) * 0.10 );
+                if(i % 10 == 1)
+                {
+                    catalog->applyGetXForYDiscount( buffer, 3, 2.00 );
+                }
+            }
+            result.handles.push_back( catalog->resolveSku( buffer ) );
+        }
+
+        result.engine.reset( new StoreEngine( catalog ) );
+        return result;
+    }();
+
+    return store;
+}
+
+static void checkout( Lane& lane, const std::vector<SkuHandle>& handles, size_t* pPosition )
+{
+    lane.newTransaction();
+    for(size_t i = 0; i < BASKET_SIZE; i++)
+    {
+        *pPosition = (*pPosition + 104729) % handles.size();
+        if(*pPosition % 4 == 0)
+        {
+            lane.addToCart( handles[*pPosition], 1.5 );
+        }
+        else
+        {
+            lane.addToCart( handles[*pPosition], 1 );
+        }
+    }
+    benchmark::DoNotOptimize( lane.getPreTaxTotalMoney() );
+}
+
+// Every thread runs its own lane, checking out one customer per iteration
+static void BM_LaneCheckout( benchmark::State& state )
+{
+    const SharedStore& store = sharedStore();
+    std::unique_ptr<Lane> lane = store.engine->openLane();
+    size_t position = static_cast<size_t>( state.thread_index() ) * 7;
+
+    for(auto _ : state)
+    {
+        checkout( *lane, store.handles, &position );
+    }
+
+    state.SetItemsProcessed( state.iterations() * BASKET_SIZE );
+}
+
+// A lane checking out customers while a writer publishes a price change every given number of
+// milliseconds, or never when given zero. The writer copies the whole catalog for every change.
+static void BM_LaneCheckoutWhilePublishing( benchmark::State& state )
+{
+    const SharedStore& store = sharedStore();
+    StoreEngine engine( store.engine->getCatalog() );
+    std::unique_ptr<Lane> lane = engine.openLane();
+    size_t position = 0;
+
+    std::atomic<bool> running( true );
+    std::atomic<int> published( 0 );
+    std::thread writer( [&]()
+    {
+        std::chrono::milliseconds interval( state.range(0) );
+        while(interval.count() > 0 && running.load())
+        {
+            SkuHandle handle = store.handles[1 + 4 * (published.load() % 1000)];
+            engine.update( [handle]( Catalog& catalog ){ return catalog.setItemPrice( handle, 3.00 ); } );
+            published++;
+            std::this_thread::sleep_for( interval );
+        }
+    } );
+
+    for(auto _ : state)
+    {
+        checkout( *lane, store.handles, &position );
+    }
+
+    running.store( false );
+    writer.join();
+
+    state.SetItemsProcessed( state.iterations() * BASKET_SIZE );
+    state.counters["versions"] = published.load();
+}
+
+BENCHMARK(BM_LaneCheckout)->ThreadRange(1, 64)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LaneCheckoutWhilePublishing)->Arg(0)->Arg(10)->UseRealTime()->Unit(benchmark::kMicrosecond);
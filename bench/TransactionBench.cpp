@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "PointOfSale.h"
+
+static const size_t BASKET_SIZE = 40;
+
+// Configures a store of the given size, where every fourth item is sold by weight
+static void configure( PointOfSale& sale, const std::vector<std::string>& skus )
+{
+    for(size_t i = 0; i < skus.size(); i++)
+    {
+        if(i % 4 == 0)
+        {
+            sale.setPerPoundPrice( skus[i], 2.49 );
+        }
+        else
+        {
+            sale.setItemPrice( skus[i], 1.00 + (i % 50) * 0.10 );
+        }
+    }
+}
+
+static std::vector<std::string> makeSkus( size_t count )
+{
+    std::vector<std::string> skus;
+    char buffer[32];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::snprintf( buffer, sizeof(buffer), "0%011zu", i * 7919 );
+        skus.push_back( buffer );
+    }
+
+    return skus;
+}
+
+static void checkout( PointOfSale& sale, const std::vector<std::string>& skus )
+{
+    for(size_t i = 0; i < BASKET_SIZE; i++)
+    {
+        size_t position = (i * 104729) % skus.size();
+        if(position % 4 == 0)
+        {
+            sale.addToCart( skus[position], 1.5 );
+        }
+        else
+        {
+            sale.addToCart( skus[position], 1 );
+        }
+    }
+
+    benchmark::DoNotOptimize( sale.getPreTaxTotalMoney() );
+}
+
+// Each customer gets a new PointOfSale, which must be configured again
+static void BM_RebuildPerCustomer( benchmark::State& state )
+{
+    std::vector<std::string> skus = makeSkus( static_cast<size_t>( state.range(0) ) );
+
+    for(auto _ : state)
+    {
+        PointOfSale sale;
+        configure( sale, skus );
+        checkout( sale, skus );
+    }
+}
+
+// Each customer starts a new transaction on the same PointOfSale
+static void BM_NewTransactionPerCustomer( benchmark::State& state )
+{
+    std::vector<std::string> skus = makeSkus( static_cast<size_t>( state.range(0) ) );
+    PointOfSale sale;
+    configure( sale, skus );
+
+    for(auto _ : state)
+    {
+        sale.newTransaction();
+        checkout( sale, skus );
+    }
+}
+
+BENCHMARK(BM_RebuildPerCustomer)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_NewTransactionPerCustomer)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
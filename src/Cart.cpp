@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <string_view>
+
+#include "Types.h"
+#include "Money.h"
+#include "Cart.h"
+
+Cart::Lines::Lines( std::pmr::memory_resource* resource )
+    : amounts( resource ), totals( resource ), queued( resource ), pending( resource ), stamps( resource )
+{
+
+}
+
+Cart::Cart( const Catalog& catalog, std::pmr::memory_resource* resource )
+    : catalog( &catalog ), fixed_lines( resource ), weight_lines( resource )
+{
+    running_total = 0;
+    transaction = 1;
+}
+
+Cart::~Cart()
+{
+
+}
+
+ReturnCode_t Cart::addToCart( std::string_view sku, int count )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addToCart( catalog->resolveSku(sku), count );
+}
+
+ReturnCode_t Cart::addToCart( std::string_view sku, double weight )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addToCart( catalog->resolveSku(sku), weight );
+}
+
+ReturnCode_t Cart::removeFromCart( std::string_view sku, int count )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return removeFromCart( catalog->resolveSku(sku), count );
+}
+
+ReturnCode_t Cart::removeFromCart( std::string_view sku, double weight )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return removeFromCart( catalog->resolveSku(sku), weight );
+}
+
+ReturnCode_t Cart::addToCart( SkuHandle handle, int count )
+{
+    uint32_t index = 0;
+
+    // An item won't be added to the catalog if not given a valid price. As such, the existence
+    // of the item in the catalog means that a price has been defined
+    ReturnCode_t code = catalog->lookupItem( handle, FIXED_PRICE_ITEM, &index );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return addLine( fixed_lines, catalog->getFixedItems(), index, count );
+}
+
+ReturnCode_t Cart::addToCart( SkuHandle handle, double weight )
+{
+    uint32_t index = 0;
+
+    // An item won't be added to the catalog if not given a valid price. As such, the existence
+    // of the item in the catalog means that a price has been defined
+    ReturnCode_t code = catalog->lookupItem( handle, WEIGHT_BASED_ITEM, &index );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return addLine( weight_lines, catalog->getWeightItems(), index, weight );
+}
+
+ReturnCode_t Cart::removeFromCart( SkuHandle handle, int count )
+{
+    uint32_t index = 0;
+
+    // an item without a price can never have been added to the cart
+    ReturnCode_t code = catalog->lookupItem( handle, FIXED_PRICE_ITEM, &index );
+    if(code != OK)
+    {
+        return (code == NO_PRICE_DEFINED) ? ITEM_NOT_IN_CART : code;
+    }
+
+    return removeLine( fixed_lines, catalog->getFixedItems(), index, count );
+}
+
+ReturnCode_t Cart::removeFromCart( SkuHandle handle, double weight )
+{
+    uint32_t index = 0;
+
+    // an item without a price can never have been added to the cart
+    ReturnCode_t code = catalog->lookupItem( handle, WEIGHT_BASED_ITEM, &index );
+    if(code != OK)
+    {
+        return (code == NO_PRICE_DEFINED) ? ITEM_NOT_IN_CART : code;
+    }
+
+    return removeLine( weight_lines, catalog->getWeightItems(), index, weight );
+}
+
+ReturnCode_t Cart::addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes )
+{
+    bool all_added = true;
+
+    // gather the amount for each item before pricing anything, the checks on a
+    // record do not depend on the records before it so the outcome is the same
+    // as adding the records one at a time
+    for(size_t i = 0; i < count; i++)
+    {
+        codes[i] = queueRecord( records[i] );
+        all_added = all_added && (codes[i] == OK);
+    }
+
+    priceQueued( fixed_lines, catalog->getFixedItems() );
+    priceQueued( weight_lines, catalog->getWeightItems() );
+
+    return all_added ? OK : ERROR;
+}
+
+double Cart::getPreTaxTotal() const
+{
+    // the running total is kept up to date as each line in the cart changes
+    return toDollars( running_total );
+}
+
+Money Cart::getPreTaxTotalMoney() const
+{
+    return running_total;
+}
+
+bool Cart::isInCart( std::string_view sku ) const
+{
+    return isInCart( catalog->resolveSku(sku) );
+}
+
+bool Cart::isInCart( SkuHandle handle ) const
+{
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return false;
+    }
+
+    SkuEntry entry = getSkuEntry(handle);
+    if(entry.type == FIXED_PRICE_ITEM)
+    {
+        return isCurrent( fixed_lines, entry.index ) && fixed_lines.amounts[entry.index] > 0;
+    }
+    else
+    {
+        return isCurrent( weight_lines, entry.index ) && weight_lines.amounts[entry.index] > 0;
+    }
+}
+
+void Cart::refreshItem( std::string_view sku )
+{
+    refreshItem( catalog->resolveSku(sku) );
+}
+
+void Cart::refreshItem( SkuHandle handle )
+{
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return;
+    }
+
+    // lines only exist for items that have been scanned, which are always valid in the catalog
+    SkuEntry entry = getSkuEntry(handle);
+    if(entry.type == FIXED_PRICE_ITEM && isCurrent( fixed_lines, entry.index ))
+    {
+        priceLine( fixed_lines, catalog->getFixedItems(), entry.index );
+    }
+    else if(entry.type == WEIGHT_BASED_ITEM && isCurrent( weight_lines, entry.index ))
+    {
+        priceLine( weight_lines, catalog->getWeightItems(), entry.index );
+    }
+}
+
+void Cart::newTransaction()
+{
+    running_total = 0;
+    transaction++;
+
+    // once the stamps wrap around, the stamps of old lines could match again
+    if(transaction == 0)
+    {
+        std::fill( fixed_lines.stamps.begin(), fixed_lines.stamps.end(), 0 );
+        std::fill( weight_lines.stamps.begin(), weight_lines.stamps.end(), 0 );
+        transaction = 1;
+    }
+}
+
+void Cart::newTransaction( const Catalog& catalog )
+{
+    this->catalog = &catalog;
+    newTransaction();
+
+    // the next catalog may hold fewer items, and every line is stale by now so any past its end can go
+    trimLines( fixed_lines, catalog.getFixedItems().size() );
+    trimLines( weight_lines, catalog.getWeightItems().size() );
+}
+
+void Cart::refreshAll()
+{
+    // every line is priced by the pass below, so stale lines must hold zero first
+    clearStale( fixed_lines );
+    clearStale( weight_lines );
+
+    // the lines line up with the start of the catalog storage, so both can be walked together
+    running_total  = catalog->getFixedItems().computeTotals( fixed_lines.amounts.data(), fixed_lines.totals.data(),
+                                                            fixed_lines.amounts.size() );
+    running_total += catalog->getWeightItems().computeTotals( weight_lines.amounts.data(), weight_lines.totals.data(),
+                                                             weight_lines.amounts.size() );
+}
+
+void Cart::reserveLine( Lines& lines, uint32_t index )
+{
+    // make room for the line the first time an item this far into the catalog is scanned
+    if(index >= lines.amounts.size())
+    {
+        lines.amounts.resize( index + 1, 0 );
+        lines.totals.resize( index + 1, 0 );
+        lines.queued.resize( index + 1, 0 );
+        lines.stamps.resize( index + 1, 0 );
+    }
+
+    if(lines.stamps[index] != transaction)
+    {
+        lines.amounts[index] = 0;
+        lines.totals[index] = 0;
+        lines.stamps[index] = transaction;
+    }
+}
+
+bool Cart::isCurrent( const Lines& lines, uint32_t index ) const
+{
+    return index < lines.stamps.size() && lines.stamps[index] == transaction;
+}
+
+void Cart::trimLines( Lines& lines, size_t count )
+{
+    if(count < lines.amounts.size())
+    {
+        lines.amounts.resize( count );
+        lines.totals.resize( count );
+        lines.queued.resize( count );
+        lines.stamps.resize( count );
+    }
+}
+
+void Cart::clearStale( Lines& lines )
+{
+    for(size_t i = 0; i < lines.stamps.size(); i++)
+    {
+        if(lines.stamps[i] != transaction)
+        {
+            lines.amounts[i] = 0;
+            lines.totals[i] = 0;
+            lines.stamps[i] = transaction;
+        }
+    }
+}
+
+ReturnCode_t Cart::queueRecord( const ScanRecord& record )
+{
+    SkuHandle handle = record.handle;
+
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        if(record.sku.length() == 0)
+        {
+            return INVALID_SKU;
+        }
+
+        handle = catalog->resolveSku( record.sku );
+    }
+
+    if(record.type == FIXED_PRICE_ITEM)
+    {
+        // counts must be whole numbers that an int is able to hold
+        if(!(record.amount >= INT_MIN && record.amount <= INT_MAX) || record.amount != std::floor( record.amount ))
+        {
+            return INVALID_ARG;
+        }
+
+        return queueLine( fixed_lines, catalog->getFixedItems(), handle, FIXED_PRICE_ITEM, static_cast<int>( record.amount ) );
+    }
+
+    return queueLine( weight_lines, catalog->getWeightItems(), handle, WEIGHT_BASED_ITEM, record.amount );
+}
+
+template <class T>
+ReturnCode_t Cart::queueLine( Lines& lines, const ItemStore<T>& items, SkuHandle handle, ItemType_t type, T amount )
+{
+    uint32_t index = 0;
+
+    ReturnCode_t code = catalog->lookupItem( handle, type, &index );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    if(!items.isPriceSet(index))
+    {
+        return NO_PRICE_DEFINED;
+    }
+
+    Quantity units = toQuantity( amount );
+    if(units <= 0)
+    {
+        return INVALID_ARG;
+    }
+
+    reserveLine( lines, index );
+    lines.amounts[index] += units;
+
+    if(!lines.queued[index])
+    {
+        lines.queued[index] = 1;
+        lines.pending.push_back( index );
+    }
+
+    return OK;
+}
+
+template <class T>
+void Cart::priceQueued( Lines& lines, const ItemStore<T>& items )
+{
+    for(size_t i = 0; i < lines.pending.size(); i++)
+    {
+        uint32_t index = lines.pending[i];
+
+        priceLine( lines, items, index );
+        lines.queued[index] = 0;
+    }
+
+    lines.pending.clear();
+}
+
+template <class T>
+ReturnCode_t Cart::addLine( Lines& lines, const ItemStore<T>& items, uint32_t index, T amount )
+{
+    if(!items.isPriceSet(index))
+    {
+        return NO_PRICE_DEFINED;
+    }
+
+    // amounts too small to be represented are rejected rather than being dropped
+    Quantity units = toQuantity( amount );
+    if(units <= 0)
+    {
+        return INVALID_ARG;
+    }
+
+    reserveLine( lines, index );
+    lines.amounts[index] += units;
+    priceLine( lines, items, index );
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t Cart::removeLine( Lines& lines, const ItemStore<T>& items, uint32_t index, T amount )
+{
+    Quantity units = toQuantity( amount );
+
+    // check to see that the item has been scanned into this cart
+    if(!isCurrent( lines, index ) || lines.amounts[index] < units || lines.amounts[index] == 0)
+    {
+        return ITEM_NOT_IN_CART;
+    }
+
+    if(units <= 0)
+    {
+        return INVALID_ARG;
+    }
+
+    lines.amounts[index] -= units;
+    priceLine( lines, items, index );
+
+    return OK;
+}
+
+template <class T>
+void Cart::priceLine( Lines& lines, const ItemStore<T>& items, uint32_t index )
+{
+    Money previous = lines.totals[index];
+
+    items.computePreTax( index, lines.amounts[index], &lines.totals[index] );
+    running_total += lines.totals[index] - previous;
+}
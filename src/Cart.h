@@ -0,0 +1,228 @@
+#ifndef CART_H
+#define CART_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+#include "Money.h"
+#include "Catalog.h"
+#include "ItemStore.h"
+
+/// \struct ScanRecord
+/// \brief Describes a single scan within a batch of scans added to the cart together
+///
+/// A record identifies the item either through a handle from Catalog::resolveSku or through the SKU itself.
+/// The type states how the item is being sold, in the same way as choosing between the int and double
+/// variants of Cart::addToCart, and is checked against the catalog.
+struct ScanRecord
+{
+    std::string_view sku;  ///< Represents the item, only used when handle is INVALID_SKU_HANDLE
+    SkuHandle handle;      ///< Identifies the item, or INVALID_SKU_HANDLE to look up the sku instead
+    ItemType_t type;       ///< Whether the amount is a count of items or a weight
+    double amount;         ///< Number of items, which must be whole, or pounds to add to the cart
+};
+
+/// \class Cart
+/// \brief Tracks the items scanned during a single checkout and prices them against a shared Catalog
+///
+/// The Cart class holds only the state that belongs to one customer: the amount of each SKU that has
+/// been scanned and the running pre-tax total. All prices, markdowns and discounts are read from the
+/// Catalog the cart was created with. Creating a cart does not copy anything from the catalog, so a new
+/// checkout can be started at no cost regardless of the size of the catalog. Any number of carts can
+/// reference the same catalog at the same time.
+///
+/// The cart keeps the pre-tax cost of every line along with the total for the whole cart. Adding or
+/// removing items only re-prices the line that changed. When the configuration of an item already in
+/// the cart is changed in the catalog, refreshItem must be called so the line is priced again.
+///
+/// Lines are stored by the position of the item within the catalog, so each operation on the cart performs
+/// a single lookup of the SKU. The storage for the lines grows as items further into the catalog are scanned
+/// and does not need to be touched when the cart is created. The amounts and the line totals are kept in
+/// separate arrays that line up with the ItemStore arrays of the catalog, so every line can be priced again
+/// in a single pass over contiguous memory.
+///
+/// Amounts and totals are held as integer Quantity and Money values. The total of the cart is the exact sum
+/// of its line totals, so it does not depend on the order in which items were scanned or voided.
+///
+/// A cart can be reused for the next customer through newTransaction. Every line is stamped with the
+/// transaction that last changed it, and a line stamped by an earlier transaction is treated as empty the
+/// next time it is used. Starting a transaction therefore takes the same time no matter how many lines the
+/// cart has, and keeps the storage that has already been sized for the catalog.
+///
+/// All of the memory held by a cart is taken from the memory resource it is created with. A lane can give
+/// the cart an arena, such as a std::pmr::monotonic_buffer_resource, so that the cart never uses the global
+/// heap and all of its memory is released in one step along with the arena.
+class Cart
+{
+    public:
+
+        /// \brief Creates an empty cart that is priced against the given catalog
+        ///
+        /// \param catalog Prices used for the items in the cart, must outlive the cart
+        /// \param resource Source of all memory used by the cart, must outlive the cart
+        Cart( const Catalog& catalog, std::pmr::memory_resource* resource = std::pmr::get_default_resource() );
+        ~Cart();
+
+        /// \brief Adds fixed price items to the cart
+        ///
+        /// \param sku Represents the item that is being added
+        /// \param count Number of the items that should be added to the cart
+        ReturnCode_t addToCart( std::string_view sku, int count );
+
+        /// \brief Adds weight to an item in the cart
+        ///
+        /// \param sku Represents the item that is being added
+        /// \param weight Amount of the item that should be added to the cart, in pounds
+        ReturnCode_t addToCart( std::string_view sku, double weight );
+
+        /// \brief Removes fixed price items from cart
+        ///
+        /// \param sku Represents the item that is being removed
+        /// \param count The number of items that need to removed from the cart
+        ReturnCode_t removeFromCart( std::string_view sku, int count );
+
+        /// \brief Removes portion of weight based item from the cart
+        ///
+        /// \param sku Represents the item that is being removed
+        /// \param weight Amount of the item that should be removed from the cart, in pounds
+        ReturnCode_t removeFromCart( std::string_view sku, double weight );
+
+        /// \brief Adds fixed price items to the cart using a handle from Catalog::resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param count Number of the items that should be added to the cart
+        ReturnCode_t addToCart( SkuHandle handle, int count );
+
+        /// \brief Adds weight to an item in the cart using a handle from Catalog::resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param weight Amount of the item that should be added to the cart, in pounds
+        ReturnCode_t addToCart( SkuHandle handle, double weight );
+
+        /// \brief Removes fixed price items from cart using a handle from Catalog::resolveSku
+        ///
+        /// \param handle Identifies the item that is being removed
+        /// \param count The number of items that need to removed from the cart
+        ReturnCode_t removeFromCart( SkuHandle handle, int count );
+
+        /// \brief Removes portion of weight based item from the cart using a handle from Catalog::resolveSku
+        ///
+        /// \param handle Identifies the item that is being removed
+        /// \param weight Amount of the item that should be removed from the cart, in pounds
+        ReturnCode_t removeFromCart( SkuHandle handle, double weight );
+
+        /// \brief Adds a whole basket of items to the cart at once
+        ///
+        /// Every record is checked exactly as the single item addToCart would check it, and the records that
+        /// pass are added. The amounts for each item are gathered first and each line that changed is then
+        /// priced once, no matter how many records refer to it. Records that fail leave the cart untouched.
+        ///
+        /// \param records The scans being added to the cart
+        /// \param count Number of records
+        /// \param codes Location that the result of each record is stored, must hold count entries
+        /// \return OK when every record was added, otherwise ERROR with the reason for each failure in codes
+        ReturnCode_t addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes );
+
+        /// \brief Provides the pre-tax total for all items within the cart
+        double getPreTaxTotal() const;
+
+        /// \brief Provides the exact pre-tax total for all items within the cart, in Money units
+        Money getPreTaxTotalMoney() const;
+
+        /// \brief Indicates whether any amount of the SKU is currently in the cart
+        ///
+        /// \param sku Represents the item being checked
+        bool isInCart( std::string_view sku ) const;
+
+        /// \brief Indicates whether any amount of the item is currently in the cart
+        ///
+        /// \param handle Identifies the item being checked
+        bool isInCart( SkuHandle handle ) const;
+
+        /// \brief Prices the line for a SKU again after its configuration changed in the catalog
+        ///
+        /// \param sku Represents the item whose configuration changed
+        void refreshItem( std::string_view sku );
+
+        /// \brief Prices the line for an item again after its configuration changed in the catalog
+        ///
+        /// \param handle Identifies the item whose configuration changed
+        void refreshItem( SkuHandle handle );
+
+        /// \brief Empties the cart for the next customer
+        ///
+        /// Every line is cleared without being visited, and the catalog is not touched, so the prices,
+        /// markdowns and discounts remain in place.
+        void newTransaction();
+
+        /// \brief Empties the cart for the next customer, who is priced against a different catalog
+        ///
+        /// This allows a cart to move to a newer version of the catalog between customers while keeping
+        /// the storage it has already sized. Lines past the end of the new catalog are released.
+        ///
+        /// \param catalog Prices used from now on, must outlive the cart or the next call to this function
+        void newTransaction( const Catalog& catalog );
+
+        /// \brief Prices every line in the cart again in a single pass
+        ///
+        /// This is cheaper than refreshing items one at a time after a large number of changes
+        /// have been made to the catalog, such as when new prices are loaded.
+        void refreshAll();
+
+    private:
+
+        /// \brief State kept for every SKU of one type, by position within the catalog
+        struct Lines
+        {
+            Lines( std::pmr::memory_resource* resource );
+
+            std::pmr::vector<Quantity> amounts;  // number of items, or thousandths of a pound, in the cart
+            std::pmr::vector<Money>    totals;   // cached pre-tax cost of each amount
+            std::pmr::vector<uint8_t>  queued;   // set while a batch has changed the amount but not priced it
+            std::pmr::vector<uint32_t> pending;  // positions that have been queued by the current batch
+            std::pmr::vector<uint32_t> stamps;   // transaction that last changed each line
+        };
+
+        /// \brief Makes room for the line of an item at the given position and empties it if it is stale
+        void reserveLine( Lines& lines, uint32_t index );
+
+        /// \brief Indicates whether a line holds an amount scanned during the current transaction
+        bool isCurrent( const Lines& lines, uint32_t index ) const;
+
+        /// \brief Drops the lines past the given number of items, all of which must be stale
+        void trimLines( Lines& lines, size_t count );
+
+        /// \brief Empties every line left over from an earlier transaction
+        void clearStale( Lines& lines );
+
+        /// \brief Checks a record of a batch and adds its amount to the line without pricing it
+        ReturnCode_t queueRecord( const ScanRecord& record );
+
+        template <class T>
+        ReturnCode_t queueLine( Lines& lines, const ItemStore<T>& items, SkuHandle handle, ItemType_t type, T amount );
+
+        /// \brief Prices every line queued by a batch and clears the queue
+        template <class T>
+        void priceQueued( Lines& lines, const ItemStore<T>& items );
+
+        template <class T>
+        ReturnCode_t addLine( Lines& lines, const ItemStore<T>& items, uint32_t index, T amount );
+
+        template <class T>
+        ReturnCode_t removeLine( Lines& lines, const ItemStore<T>& items, uint32_t index, T amount );
+
+        template <class T>
+        void priceLine( Lines& lines, const ItemStore<T>& items, uint32_t index );
+
+        const Catalog* catalog;  // prices used for the current customer
+        Lines fixed_lines;   // lines for fixed price items, by catalog position
+        Lines weight_lines;  // lines for weight based items, by catalog position
+        Money running_total; // sum of the pre-tax cost of every line in the cart
+        uint32_t transaction; // stamp given to lines changed by the current customer
+
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Types.h"
+#include "Money.h"
 #include "CartItem.h"
 
 // By default, a template class definition and the implementation must be
@@ -13,18 +14,7 @@ template <class T>
 CartItem<T>::CartItem()
 {
     amount_in_cart = 0;
-    price = 0.0;
-    is_price_set = false;
-    markdown = 0.0;
-
-    discount_type = NO_DISCOUNT;
-    is_discount_limited = false;
-
-    discount_x = 0;
-    discount_y = 0;
-    discount_percent = 0.0;
-    discount_price = 0.0;
-    discount_limit = 0;
+    line_total = 0;
 }
 
 template <class T>
@@ -36,9 +26,10 @@ CartItem<T>::~CartItem()
 template <class T>
 ReturnCode_t CartItem<T>::setPrice( double amount )
 {
-    if(amount <= 0.0)
+    ReturnCode_t code = pricing.checkPrice( amount );
+    if(code != OK)
     {
-        return INVALID_PRICE;
+        return code;
     }
 
     if(amount_in_cart > 0)
@@ -46,23 +37,19 @@ ReturnCode_t CartItem<T>::setPrice( double amount )
         return PRICE_UPDATE_NOT_AVAILABLE;
     }
 
-    price = amount;
-    is_price_set = true;
+    code = pricing.setPrice( amount );
+    refreshLineTotal();
 
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::applyMarkdown( double amount )
 {
-    if(!is_price_set)
-    {
-        return NO_PRICE_DEFINED;
-    }
-
-    if(amount < 0 || amount > price)
+    ReturnCode_t code = pricing.checkMarkdown( amount );
+    if(code != OK)
     {
-        return INVALID_PRICE;
+        return code;
     }
 
     if(amount_in_cart > 0)
@@ -70,115 +57,66 @@ ReturnCode_t CartItem<T>::applyMarkdown( double amount )
         return PRICE_UPDATE_NOT_AVAILABLE;
     }
 
-    markdown = amount;
+    code = pricing.applyMarkdown( amount );
+    refreshLineTotal();
 
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::applyGetXforPriceDiscount( T buy_amount, double price )
 {
-    if(buy_amount < 0 || price < 0)
-    {
-        return INVALID_DISCOUNT;
-    }
-
-    discount_type = X_FOR_FLAT;
-
-    discount_x = buy_amount;
-    discount_y = 0;
-    discount_percent = 0.0;
-    discount_price = price;
-    is_discount_limited = false;
-    discount_limit = 0;
+    ReturnCode_t code = pricing.applyGetXforPriceDiscount( buy_amount, price );
+    refreshLineTotal();
 
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::applyGetXforPriceDiscount( T buy_amount, double price, T limit )
 {
-    if(buy_amount < 0 || price < 0 || limit <= 0 || limit < buy_amount)
-    {
-        return INVALID_DISCOUNT;
-    }
+    ReturnCode_t code = pricing.applyGetXforPriceDiscount( buy_amount, price, limit );
+    refreshLineTotal();
 
-    discount_type = X_FOR_FLAT;
-    
-    discount_x = buy_amount;
-    discount_y = 0;
-    discount_percent = 0.0;
-    discount_price = price;
-    is_discount_limited = true;
-    discount_limit = limit;
-
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off )
 {
-    if(buy_x < 0 || get_y < 0 || percent_off < 0)
-    {
-        return INVALID_DISCOUNT;
-    }
-    if(percent_off > 1.0)
-    {
-        return INVALID_DISCOUNT;
-    }
+    ReturnCode_t code = pricing.applyBuyXGetYDiscount( buy_x, get_y, percent_off );
+    refreshLineTotal();
 
-    discount_type = BUY_X_GET_Y_FOR_Z_LIMIT_W;
-    
-    discount_x = buy_x;
-    discount_y = get_y;
-    discount_limit = 0;
-    is_discount_set = true;
-    discount_percent = percent_off;
-    discount_price = 0.0;
-    is_discount_limited = false;
-    
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off, T limit )
 {
-    if(buy_x < 0 || get_y < 0 || percent_off < 0 || limit <= 0 || limit < buy_x)
-    {
-        return INVALID_DISCOUNT;
-    }
-    if(percent_off > 1.0)
-    {
-        return INVALID_DISCOUNT;
-    }
+    ReturnCode_t code = pricing.applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit );
+    refreshLineTotal();
 
-    discount_type = BUY_X_GET_Y_FOR_Z_LIMIT_W;
-    
-    discount_x = buy_x;
-    discount_y = get_y;
-    discount_limit = limit;
-    is_discount_set = true;
-    discount_percent = percent_off;
-    discount_price = 0.0;
-    is_discount_limited = true;
-    
-    return OK;
+    return code;
 }
 
 template <class T>
 ReturnCode_t CartItem<T>::addToCart( T amount )
 {
-    if(!is_price_set)
+    if(!pricing.isPriceSet())
     {
         return NO_PRICE_DEFINED;
     }
 
-    if(amount <= 0)
+    // amounts too small to be represented are rejected rather than being dropped
+    Quantity units = toQuantity( amount );
+    if(units <= 0)
     {
         return INVALID_ARG;
     }
 
-    amount_in_cart += amount;
+    amount_in_cart += units;
+
+    refreshLineTotal();
 
     return OK;
 }
@@ -186,17 +124,20 @@ ReturnCode_t CartItem<T>::addToCart( T amount )
 template <class T>
 ReturnCode_t CartItem<T>::removeFromCart( T amount )
 {
-    if(amount_in_cart < amount || amount_in_cart == 0)
+    Quantity units = toQuantity( amount );
+    if(amount_in_cart < units || amount_in_cart == 0)
     {
         return ITEM_NOT_IN_CART;
     }
 
-    if(amount <= 0)
+    if(units <= 0)
     {
         return INVALID_ARG;
     }
 
-    amount_in_cart -= amount;
+    amount_in_cart -= units;
+
+    refreshLineTotal();
 
     return OK;
 }
@@ -204,89 +145,22 @@ ReturnCode_t CartItem<T>::removeFromCart( T amount )
 template <class T>
 ReturnCode_t CartItem<T>::computePreTax( double *pTaxAmount )
 {
-    double total = 0.0;
-    T items_discounted = 0;
-    T items_remain = amount_in_cart;
-    double normalized_cost = price - markdown;
+    Money cost = 0;
 
-    if(discount_type == X_FOR_FLAT)
-    {
-        T discount_remain = discount_limit - items_discounted;
-        while(items_remain >= discount_x)
-        {
-            // check if a limit was placed and if so then determine if it has been reached
-            if((discount_limit != 0) && (discount_remain < discount_x))
-            {
-                break;
-            }
-
-            items_remain -= discount_x;
-            items_discounted += discount_x;
-            total += discount_price;
-            discount_remain = discount_limit - items_discounted;
-        }
-    }
-    else if(discount_type == BUY_X_GET_Y_FOR_Z_LIMIT_W)
-    {
+    ReturnCode_t code = pricing.computePreTax( amount_in_cart, &cost );
+    *pTaxAmount = toDollars( cost );
 
-        while(discount_type != NO_DISCOUNT)
-        {
-
-            // check to see if the limit has been reached for particular discount
-            if((is_discount_limited) && (items_discounted >= discount_limit))
-            {
-                break;
-            }
-
-            // check to see if enough items remain to qualify for discount
-            if(items_remain > discount_x)
-            {
-                // decrement items needing processed
-                items_remain -= discount_x;
-                items_discounted += discount_x;
-                total += (discount_x * normalized_cost);
-
-                if((discount_limit != 0) && (items_discounted >= discount_limit))
-                {
-                    break;
-                }
-
-                // calculate number items that should be discounted
-                T discount_remain = (discount_limit - items_discounted);
-                T items_to_discount = discount_y;
-                if(items_remain == 0)
-                {
-                    items_to_discount = 0;
-                }
-                else if(discount_limit != 0 && discount_remain < discount_y)
-                {
-                    items_to_discount = discount_remain;
-                }
-                else if(items_remain < discount_y)
-                {
-                    items_to_discount = items_remain;
-                }
-
-                // decrement count so that the items are not counted again
-                items_remain -= items_to_discount;
-                items_discounted += items_to_discount;
-
-                // compute the discounted price adn add to the running total
-                double original_price = items_to_discount * normalized_cost;
-                double discount_price = original_price * (1 - discount_percent);
-
-                total += discount_price;
-            }
-            else
-            {
-                break;
-            }
-        }
-    }
+    return code;
+}
 
-    // compute cost for rest of the items that weren't covered by discount
-    total += (normalized_cost * items_remain);
-    *pTaxAmount = total;
+template <class T>
+double CartItem<T>::getLineTotal() const
+{
+    return toDollars( line_total );
+}
 
-    return OK;
-}
\ No newline at end of file
+template <class T>
+void CartItem<T>::refreshLineTotal()
+{
+    pricing.computePreTax( amount_in_cart, &line_total );
+}
@@ -2,6 +2,8 @@
 #define CART_ITEM_H
 
 #include "Types.h"
+#include "Money.h"
+#include "CatalogItem.h"
 
 /// \class CartItem
 /// \brief Implements the logic of a single item in the cart
@@ -10,6 +12,10 @@
 /// is utilized to handle both fixed price items and weight based items. The use of templates
 /// makes it possible to re-use all code associated with all items. The only difference in
 /// the logic is whether a whole number of items is maintained or a floating point weight.
+/// The price and discounts are held in a CatalogItem, while this class tracks the amount of
+/// the item in the cart and prevents the price from changing once the item has been scanned.
+/// The amount in the cart is held as an integer Quantity, so weight based items are tracked to
+/// the thousandth of a pound and removing weight exactly undoes adding it.
 template <class T>
 class CartItem { 
    
@@ -102,36 +108,27 @@ class CartItem {
         /// \brief Calculates the pre-tax cost of the item
         ///
         /// This function will compute the pre-tax cost of the item for the customer. This calcution
-        /// will take into affect any markdowns and/or discounts that have been applied.
+        /// will take into affect any markdowns and/or discounts that have been applied. The discounts are
+        /// evaluated arithmetically, so the cost of the calculation does not grow with the amount in the cart.
         ///
         /// \param pTaxAmount Location that the computed pre-tax figure should be stored
         ReturnCode_t computePreTax( double *pTaxAmount );
 
+        /// \brief Provides the most recently computed pre-tax cost of the item
+        ///
+        /// The pre-tax cost of the item is recomputed whenever the amount in the cart, the price or the
+        /// discount for the item changes. This allows the cost to be retrieved repeatedly, such as after
+        /// every scan, without performing the calculation again.
+        double getLineTotal() const;
+
     private:
 
-        typedef enum
-        {
-            NO_DISCOUNT,
-            X_FOR_FLAT,
-            BUY_X_GET_Y_FOR_Z_LIMIT_W,
-        } DiscountType_t;
-
-        DiscountType_t discount_type;
-        T amount_in_cart;  // maintain count of item in the cart
-
-        // All related to the price and markdown
-        double price;      // configured full price for the item
-        bool is_price_set; // keep track of when price has been set
-        double markdown;   // amount of markdown that is programmed, defaults to 0
-
-        // All related to the discounts associated with the code
-        T discount_x;
-        T discount_y;
-        T discount_limit;
-        bool is_discount_set;
-        double discount_percent;
-        double discount_price;
-        bool is_discount_limited;
+        /// \brief Recomputes the cached pre-tax cost after a change to the item
+        void refreshLineTotal();
+
+        CatalogItem<T> pricing;   // price, markdown and discount configured for the item
+        Quantity amount_in_cart;  // maintain count of item in the cart
+        Money line_total;         // cached pre-tax cost of the amount in the cart
         
 }; 
 
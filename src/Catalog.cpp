@@ -0,0 +1,723 @@
+#include <string_view>
+
+#include "Types.h"
+#include "Catalog.h"
+#include "CatalogItem.h"
+#include "ItemStore.h"
+#include "CatalogImage.h"
+
+// Copies an item out of the store, applies a change to it, and copies it back
+// when the change is accepted. All validation remains within CatalogItem.
+template <class T, class Edit>
+static ReturnCode_t editItem( ItemStore<T>& items, uint32_t position, Edit edit )
+{
+    CatalogItem<T> item = items.get( position );
+
+    ReturnCode_t code = edit( item );
+    if(code == OK)
+    {
+        items.set( position, item );
+    }
+
+    return code;
+}
+
+Catalog::Catalog()
+{
+
+}
+
+Catalog::~Catalog()
+{
+
+}
+
+ReturnCode_t Catalog::setItemPrice( std::string_view sku, double price )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    // if the item is already registered then call function to update price
+    SkuHandle handle = resolveSku(sku);
+    if(handle != INVALID_SKU_HANDLE)
+    {
+        return setItemPrice( handle, price );
+    }
+
+    // only register the sku once it has been given a valid price
+    CatalogItem<int> fixed;
+    ReturnCode_t code = fixed.setPrice(price);
+    if(code == OK)
+    {
+        SkuEntry created = { FIXED_PRICE_ITEM, fixed_items.append( fixed ) };
+        index.insert( sku, created );
+    }
+
+    return code;
+}
+
+ReturnCode_t Catalog::setPerPoundPrice( std::string_view sku, double price )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    // if the item is already registered then call function to update price
+    SkuHandle handle = resolveSku(sku);
+    if(handle != INVALID_SKU_HANDLE)
+    {
+        return setPerPoundPrice( handle, price );
+    }
+
+    // only register the sku once it has been given a valid price
+    CatalogItem<double> weight;
+    ReturnCode_t code = weight.setPrice(price);
+    if(code == OK)
+    {
+        SkuEntry created = { WEIGHT_BASED_ITEM, weight_items.append( weight ) };
+        index.insert( sku, created );
+    }
+
+    return code;
+}
+
+ReturnCode_t Catalog::setMarkdown( std::string_view sku, double price )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return setMarkdown( resolveSku(sku), price );
+}
+
+ReturnCode_t Catalog::checkMarkdown( std::string_view sku, double price ) const
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return checkMarkdown( resolveSku(sku), price );
+}
+
+ReturnCode_t Catalog::applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyGetXForYDiscount( resolveSku(sku), buy_x, amount );
+}
+
+ReturnCode_t Catalog::applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyGetXForYDiscount( resolveSku(sku), buy_x, amount, limit );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off, limit );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return applyBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off, limit );
+}
+
+ReturnCode_t Catalog::addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addGetXForYDiscount( resolveSku(sku), buy_x, amount );
+}
+
+ReturnCode_t Catalog::addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addGetXForYDiscount( resolveSku(sku), buy_x, amount, limit );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off, limit );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    return addBuyXGetYAtDiscount( resolveSku(sku), buy_x, get_y, percent_off, limit );
+}
+
+ReturnCode_t Catalog::setItemPrice( SkuHandle handle, double price )
+{
+    uint32_t position = 0;
+
+    // a handle can only update an item that has already been registered
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return INVALID_SKU;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.setPrice(price); } );
+}
+
+ReturnCode_t Catalog::setPerPoundPrice( SkuHandle handle, double price )
+{
+    uint32_t position = 0;
+
+    // a handle can only update an item that has already been registered
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return INVALID_SKU;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.setPrice(price); } );
+}
+
+ReturnCode_t Catalog::checkItemPrice( SkuHandle handle, double price ) const
+{
+    uint32_t position = 0;
+
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return INVALID_SKU;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return fixed_items.get(position).checkPrice( price );
+}
+
+ReturnCode_t Catalog::checkPerPoundPrice( SkuHandle handle, double price ) const
+{
+    uint32_t position = 0;
+
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return INVALID_SKU;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return weight_items.get(position).checkPrice( price );
+}
+
+ReturnCode_t Catalog::setMarkdown( SkuHandle handle, double price )
+{
+    uint32_t position = 0;
+    SkuEntry entry = getSkuEntry(handle);
+
+    // markdowns apply to either type of item
+    ReturnCode_t code = lookupItem( handle, entry.type, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+    else if(entry.type == FIXED_PRICE_ITEM)
+    {
+        return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.applyMarkdown( price ); } );
+    }
+    else
+    {
+        return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.applyMarkdown( price ); } );
+    }
+}
+
+ReturnCode_t Catalog::checkMarkdown( SkuHandle handle, double price ) const
+{
+    uint32_t position = 0;
+    SkuEntry entry = getSkuEntry(handle);
+
+    ReturnCode_t code = lookupItem( handle, entry.type, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+    else if(entry.type == FIXED_PRICE_ITEM)
+    {
+        return fixed_items.get(position).checkMarkdown( price );
+    }
+    else
+    {
+        return weight_items.get(position).checkMarkdown( price );
+    }
+}
+
+ReturnCode_t Catalog::applyGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount )
+{
+    uint32_t position = 0;
+
+    if(checkGetXForYDiscount( buy_x, amount, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.applyGetXforPriceDiscount( buy_x, amount ); } );
+}
+
+ReturnCode_t Catalog::applyGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount, int limit )
+{
+    uint32_t position = 0;
+
+    if(checkGetXForYDiscount( buy_x, amount, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.applyGetXforPriceDiscount( buy_x, amount, limit ); } );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.applyBuyXGetYDiscount( buy_x, get_y, percent_off ); } );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.applyBuyXGetYDiscount( buy_x, get_y, percent_off ); } );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off, int limit )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit ); } );
+}
+
+ReturnCode_t Catalog::applyBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off, double limit )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit ); } );
+}
+
+ReturnCode_t Catalog::addGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount )
+{
+    uint32_t position = 0;
+
+    if(checkGetXForYDiscount( buy_x, amount, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.addGetXforPriceDiscount( buy_x, amount ); } );
+}
+
+ReturnCode_t Catalog::addGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount, int limit )
+{
+    uint32_t position = 0;
+
+    if(checkGetXForYDiscount( buy_x, amount, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.addGetXforPriceDiscount( buy_x, amount, limit ); } );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.addBuyXGetYDiscount( buy_x, get_y, percent_off ); } );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, false, 0 ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.addBuyXGetYDiscount( buy_x, get_y, percent_off ); } );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off, int limit )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, FIXED_PRICE_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( fixed_items, position, [&]( CatalogItem<int>& item ) { return item.addBuyXGetYDiscount( buy_x, get_y, percent_off, limit ); } );
+}
+
+ReturnCode_t Catalog::addBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off, double limit )
+{
+    uint32_t position = 0;
+
+    if(checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, true, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    ReturnCode_t code = lookupItem( handle, WEIGHT_BASED_ITEM, &position );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    return editItem( weight_items, position, [&]( CatalogItem<double>& item ) { return item.addBuyXGetYDiscount( buy_x, get_y, percent_off, limit ); } );
+}
+
+ReturnCode_t Catalog::loadItem( std::string_view sku, const CatalogItem<int>& item )
+{
+    return loadItem( sku, item, fixed_items, FIXED_PRICE_ITEM );
+}
+
+ReturnCode_t Catalog::loadItem( std::string_view sku, const CatalogItem<double>& item )
+{
+    return loadItem( sku, item, weight_items, WEIGHT_BASED_ITEM );
+}
+
+template <class T>
+ReturnCode_t Catalog::loadItem( std::string_view sku, const CatalogItem<T>& item, ItemStore<T>& items, ItemType_t type )
+{
+    if(sku.length() == 0)
+    {
+        return INVALID_SKU;
+    }
+
+    // the same rule as setting prices one at a time, an item is only registered with a price
+    if(!item.isPriceSet())
+    {
+        return INVALID_PRICE;
+    }
+
+    const SkuEntry* entry = index.find(sku);
+    if(entry == 0)
+    {
+        SkuEntry created = { type, items.append( item ) };
+        index.insert( sku, created );
+        return OK;
+    }
+
+    if(entry->type != type)
+    {
+        return ITEM_CONFLICT;
+    }
+
+    items.set( entry->index, item );
+    return OK;
+}
+
+void Catalog::reserve( size_t fixed_count, size_t weight_count )
+{
+    index.reserve( index.size() + fixed_count + weight_count );
+    fixed_items.reserve( fixed_items.size() + fixed_count );
+    weight_items.reserve( weight_items.size() + weight_count );
+}
+
+ReturnCode_t Catalog::setPriceTables( int quantity, size_t item_count )
+{
+    if(quantity < 0 || quantity > MAX_PRICE_TABLE_AMOUNT)
+    {
+        return INVALID_ARG;
+    }
+
+    fixed_items.setPriceTables( quantity, item_count );
+
+    return OK;
+}
+
+ReturnCode_t Catalog::saveImage( const std::string& path ) const
+{
+    return CatalogImage::write( *this, path );
+}
+
+ReturnCode_t Catalog::openImage( const std::string& path )
+{
+    std::shared_ptr<const CatalogImage> opened;
+
+    ReturnCode_t code = CatalogImage::open( path, &opened );
+    if(code == OK)
+    {
+        opened->attach( *this );
+        image = opened;
+    }
+
+    return code;
+}
+
+ReturnCode_t Catalog::checkGetXForYDiscount( double buy_x, double amount, bool limited, double limit )
+{
+    if(buy_x <= 0 || amount < 0 || (limited && limit <= 0))
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return OK;
+}
+
+ReturnCode_t Catalog::checkBuyXGetYAtDiscount( double buy_x, double get_y, double percent_off, bool limited, double limit )
+{
+    if(buy_x <= 0 || get_y < 0 || percent_off >= 1.0 || percent_off < 0.0 || (limited && limit < 0))
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return OK;
+}
+
+SkuHandle Catalog::resolveSku( std::string_view sku ) const
+{
+    const SkuEntry* entry = index.find(sku);
+
+    if(entry == 0)
+    {
+        return INVALID_SKU_HANDLE;
+    }
+
+    return makeSkuHandle( *entry );
+}
+
+std::string_view Catalog::getSku( SkuHandle handle ) const
+{
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return std::string_view();
+    }
+
+    return index.getSku( getSkuEntry(handle) );
+}
+
+ReturnCode_t Catalog::lookupItem( SkuHandle handle, ItemType_t type, uint32_t* pIndex ) const
+{
+    // an unresolved sku is treated the same as a sku that was never given a price
+    if(handle == INVALID_SKU_HANDLE)
+    {
+        return NO_PRICE_DEFINED;
+    }
+
+    SkuEntry entry = getSkuEntry(handle);
+    size_t count = (entry.type == FIXED_PRICE_ITEM) ? fixed_items.size() : weight_items.size();
+    if(entry.index >= count)
+    {
+        return INVALID_SKU;
+    }
+
+    if(entry.type != type)
+    {
+        return ITEM_CONFLICT;
+    }
+
+    *pIndex = entry.index;
+    return OK;
+}
+
+bool Catalog::isFixedItem( std::string_view sku ) const
+{
+    uint32_t position = 0;
+    return lookupItem( resolveSku(sku), FIXED_PRICE_ITEM, &position ) == OK;
+}
+
+bool Catalog::isWeightItem( std::string_view sku ) const
+{
+    uint32_t position = 0;
+    return lookupItem( resolveSku(sku), WEIGHT_BASED_ITEM, &position ) == OK;
+}
+
+const ItemStore<int>& Catalog::getFixedItems() const
+{
+    return fixed_items;
+}
+
+const ItemStore<double>& Catalog::getWeightItems() const
+{
+    return weight_items;
+}
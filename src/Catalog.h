@@ -0,0 +1,457 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+#include "CatalogItem.h"
+#include "ItemStore.h"
+#include "SkuIndex.h"
+
+class CatalogImage;
+
+/// \class Catalog
+/// \brief Holds the prices, markdowns and discounts for every SKU sold in the store
+///
+/// The Catalog class contains all of the pricing configuration that is shared between checkouts.
+/// Once configured, a single Catalog can be referenced by any number of Cart objects at the same
+/// time. Each cart only reads from the catalog, which means a new checkout can be started without
+/// copying or reloading any of the prices. The catalog must outlive every cart that references it.
+///
+/// The rules for configuring items match those of the PointOfSale class. A SKU is registered as
+/// either a fixed price item or a weight based item when its price is first set, and it can not
+/// be used as the other type afterwards.
+///
+/// Every SKU is located through a single SkuIndex regardless of its type. The index records whether the
+/// SKU is a fixed price or weight based item along with the position of its configuration, so each
+/// operation performs one lookup. Every operation is also available using a SkuHandle, which skips the
+/// lookup entirely for callers that have already resolved the SKU.
+///
+/// The configuration of each type of item is held in an ItemStore, which lays every field out as its own
+/// array. Carts price their lines straight from those arrays.
+///
+/// The catalog owns the storage of every item. No item is allocated on its own: registering a SKU appends
+/// to the arrays of its ItemStore, which grow in blocks that at least double in size, and all of them are
+/// released together when the catalog is destroyed. Items are never removed, so handles and positions
+/// given out by the catalog stay valid for as long as the catalog exists.
+///
+/// A configured catalog can be saved as a CatalogImage and opened again by mapping the file, which makes
+/// the whole catalog available without configuring any items.
+class Catalog
+{
+    public:
+
+        Catalog();
+        ~Catalog();
+
+        /// \brief Provides ability to setup a fixed price for a SKU
+        ///
+        /// Registers the SKU as a fixed price item, or updates the price when it has already been
+        /// registered. A SKU that has been registered as a weight based item can not be given a fixed price.
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param price The price per unit of the item
+        ReturnCode_t setItemPrice( std::string_view sku, double price );
+
+        /// \brief Provides ability to setup a per pound based price for a SKU
+        ///
+        /// Registers the SKU as a weight based item, or updates the price when it has already been
+        /// registered. A SKU that has been registered as a fixed price item can not be given a per pound price.
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param price The price per pound of the item
+        ReturnCode_t setPerPoundPrice( std::string_view sku, double price );
+
+        /// \brief Provides ability to enable a marked down price on an item
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param price Amount of discount to apply to the item
+        ReturnCode_t setMarkdown( std::string_view sku, double price );
+
+        /// \brief Verifies that a markdown would be accepted for the SKU without applying it
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param price Amount of discount to apply to the item
+        ReturnCode_t checkMarkdown( std::string_view sku, double price ) const;
+
+        /// \brief Applys a buy X items for the Z price
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        ReturnCode_t applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount );
+
+        /// \brief Applys a buy X items for the Z price, with a limit on the number of items
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit );
+
+        /// \brief Applies a discount on fixed price items after a qualifying number are purchased
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off );
+
+        /// \brief Applies a discount on fixed price items after a qualifying number are purchased, with a limit
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit );
+
+        /// \brief Applies a discount on weight based items after a qualifying weight is purchased
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off );
+
+        /// \brief Applies a discount on weight based items after a qualifying weight is purchased, with a limit
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        /// \param limit The number of pounds that are allowed to be purchased with this discount
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Offers a buy X items for the Z price alongside the discounts already configured for the SKU
+        ///
+        /// The apply functions replace the discount of an item. The add functions instead keep every discount
+        /// already offered, up to MAX_STACKED_DISCOUNTS of each type, and the customer is charged the cheapest
+        /// combination of them, see StackedDiscount.
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        ReturnCode_t addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount );
+
+        /// \brief Offers a buy X items for the Z price, with a limit, alongside the discounts already configured
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit );
+
+        /// \brief Offers a buy X get Y discount on a fixed price item alongside the discounts already configured
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, on a fixed price item alongside the discounts already configured
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit );
+
+        /// \brief Offers a buy X get Y discount on a weight based item alongside the discounts already configured
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, on a weight based item alongside the discounts already configured
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        /// \param limit The number of pounds that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Updates the price of a registered fixed price item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price The price per unit of the item
+        ReturnCode_t setItemPrice( SkuHandle handle, double price );
+
+        /// \brief Updates the price of a registered weight based item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price The price per pound of the item
+        ReturnCode_t setPerPoundPrice( SkuHandle handle, double price );
+
+        /// \brief Verifies that a price would be accepted for a registered fixed price item without applying it
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price The price per unit of the item
+        ReturnCode_t checkItemPrice( SkuHandle handle, double price ) const;
+
+        /// \brief Verifies that a price would be accepted for a registered weight based item without applying it
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price The price per pound of the item
+        ReturnCode_t checkPerPoundPrice( SkuHandle handle, double price ) const;
+
+        /// \brief Provides ability to enable a marked down price on a registered item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price Amount of discount to apply to the item
+        ReturnCode_t setMarkdown( SkuHandle handle, double price );
+
+        /// \brief Verifies that a markdown would be accepted for a registered item without applying it
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param price Amount of discount to apply to the item
+        ReturnCode_t checkMarkdown( SkuHandle handle, double price ) const;
+
+        /// \brief Applys a buy X items for the Z price to a registered item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        ReturnCode_t applyGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount );
+
+        /// \brief Applys a buy X items for the Z price, with a limit on the number of items, to a registered item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limit The number of items, or pounds, that are allowed to be purchased with this discount
+        ReturnCode_t applyGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount, int limit );
+
+        /// \brief Applies a buy X get Y discount to a registered fixed price item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param get_y The number of items, or pounds, that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t applyBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off );
+
+        /// \brief Applies a buy X get Y discount, with a limit, to a registered fixed price item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param get_y The number of items, or pounds, that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items, or pounds, that are allowed to be purchased with this discount
+        ReturnCode_t applyBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off, int limit );
+
+        /// \brief Applies a buy X get Y discount to a registered weight based item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param get_y The number of items, or pounds, that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t applyBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off );
+
+        /// \brief Applies a buy X get Y discount, with a limit, to a registered weight based item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param get_y The number of items, or pounds, that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items, or pounds, that are allowed to be purchased with this discount
+        ReturnCode_t applyBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Offers a buy X items for the Z price alongside the discounts already configured for a registered item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        ReturnCode_t addGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount );
+
+        /// \brief Offers a buy X items for the Z price, with a limit, alongside the discounts already configured for a registered item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addGetXForYDiscount  ( SkuHandle handle, int buy_x, double amount, int limit );
+
+        /// \brief Offers a buy X get Y discount alongside the discounts already configured for a registered fixed price item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, alongside the discounts already configured for a registered fixed price item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( SkuHandle handle, int buy_x, int get_y, double percent_off, int limit );
+
+        /// \brief Offers a buy X get Y discount alongside the discounts already configured for a registered weight based item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of pounds that must be purchased for discount to apply
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, alongside the discounts already configured for a registered weight based item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param buy_x Number of pounds that must be purchased for discount to apply
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        /// \param limit The number of pounds that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( SkuHandle handle, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Registers a fixed price item with a configuration that has already been validated
+        ///
+        /// This is used to load many items at once, such as by CatalogLoader. The SKU is registered when it
+        /// is new, and its configuration is replaced when it is already a fixed price item.
+        ///
+        /// \param sku Represents the item being loaded
+        /// \param item Complete configuration for the item, must have a price set
+        /// \return INVALID_PRICE when the item has no price, ITEM_CONFLICT when the SKU is sold by weight
+        ReturnCode_t loadItem( std::string_view sku, const CatalogItem<int>& item );
+
+        /// \brief Registers a weight based item with a configuration that has already been validated
+        ///
+        /// \param sku Represents the item being loaded
+        /// \param item Complete configuration for the item, must have a price set
+        /// \return INVALID_PRICE when the item has no price, ITEM_CONFLICT when the SKU is sold per item
+        ReturnCode_t loadItem( std::string_view sku, const CatalogItem<double>& item );
+
+        /// \brief Allocates room for items that are about to be loaded
+        ///
+        /// The index and the storage are sized once, instead of growing repeatedly as items are added.
+        ///
+        /// \param fixed_count Number of fixed price items that are expected to be added
+        /// \param weight_count Number of weight based items that are expected to be added
+        void reserve( size_t fixed_count, size_t weight_count );
+
+        /// \brief Keeps the price of every count up to a limit for discounted fixed price items
+        ///
+        /// Each table is built when a discount is set through the apply or add discount functions, and again
+        /// whenever the price or markdown of the item changes, so pricing a count within the table is a single
+        /// lookup. Larger counts are priced by the discount as usual. Only the given number of items have a
+        /// table at any time, each costing eight bytes for every count up to the limit.
+        ///
+        /// The items are chosen by position, not by how often they are scanned. Fixed price items that already
+        /// have a discount are given tables in the order they were first priced, and after that items are given
+        /// tables in the order their discounts are set, taking the tables given up by items whose discounts are
+        /// removed. Setting the discounts of the items that are scanned most often first gives them the tables.
+        ///
+        /// Weight based items are never given a table, whatever their discount, since a weight is rarely
+        /// scanned twice.
+        ///
+        /// Tables are not saved in an image, and opening an image leaves the catalog without any until this
+        /// is called again.
+        ///
+        /// \param quantity Largest count held by each table, zero turns the tables off, no more than
+        ///        MAX_PRICE_TABLE_AMOUNT
+        /// \param item_count Most items that are given a table
+        /// \return OK, or INVALID_ARG for a negative quantity or one above MAX_PRICE_TABLE_AMOUNT
+        ReturnCode_t setPriceTables( int quantity, size_t item_count );
+
+        /// \brief Saves every item of the catalog to a binary image file
+        ///
+        /// \param path Location of the image file
+        /// \return OK, or ERROR if the file could not be written
+        ReturnCode_t saveImage( const std::string& path ) const;
+
+        /// \brief Replaces the contents of the catalog with an image written by saveImage
+        ///
+        /// The file is mapped read-only and used in place, after its index and discounts have been read
+        /// through once to check them, see CatalogImage. The catalog can be changed afterwards without
+        /// affecting the file. On failure the catalog is left unchanged.
+        ///
+        /// \param path Location of the image file
+        /// \return OK, INVALID_ARG when the file cannot be opened, or ERROR when it is not a valid image
+        ReturnCode_t openImage( const std::string& path );
+
+        /// \brief Verifies the arguments of a buy X items for the Z price discount
+        ///
+        /// These checks are made before the discount is handed to the item, which applies its own checks
+        /// on top of them.
+        ///
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limited Whether a limit is being placed on the discount
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        static ReturnCode_t checkGetXForYDiscount( double buy_x, double amount, bool limited, double limit );
+
+        /// \brief Verifies the arguments of a buy X get Y discount
+        ///
+        /// \param buy_x Number of items, or pounds, that must be purchased for discount to apply
+        /// \param get_y The number of items, or pounds, that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limited Whether a limit is being placed on the discount
+        /// \param limit The number of items, or pounds, that are allowed to be purchased with this discount
+        static ReturnCode_t checkBuyXGetYAtDiscount( double buy_x, double get_y, double percent_off, bool limited, double limit );
+
+        /// \brief Converts a SKU into a handle that can be used in place of the string
+        ///
+        /// The handle stays the same for as long as the catalog exists, which allows callers to resolve
+        /// frequently scanned SKUs once and skip the string lookup afterwards.
+        ///
+        /// \param sku Represents the item being looked up
+        /// \return Handle for the item, or INVALID_SKU_HANDLE if the SKU has not been given a price
+        SkuHandle resolveSku( std::string_view sku ) const;
+
+        /// \brief Converts a handle back into the SKU it was resolved from
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \return Characters of the SKU, valid while the catalog is unchanged, or an empty view for a handle
+        ///         that was never given out
+        std::string_view getSku( SkuHandle handle ) const;
+
+        /// \brief Validates a handle and locates the storage for the item
+        ///
+        /// \param handle Identifies the item, as given by resolveSku
+        /// \param type The type of item the caller expects the handle to refer to
+        /// \param pIndex Location where the position of the item within the storage for its type is stored
+        /// \return NO_PRICE_DEFINED for INVALID_SKU_HANDLE, INVALID_SKU for a handle that was never given
+        ///         out, ITEM_CONFLICT when the item is of the other type, otherwise OK
+        ReturnCode_t lookupItem( SkuHandle handle, ItemType_t type, uint32_t* pIndex ) const;
+
+        /// \brief Indicates whether the SKU has been registered as a fixed price item
+        ///
+        /// \param sku Represents the item being looked up
+        bool isFixedItem( std::string_view sku ) const;
+
+        /// \brief Indicates whether the SKU has been registered as a weight based item
+        ///
+        /// \param sku Represents the item being looked up
+        bool isWeightItem( std::string_view sku ) const;
+
+        /// \brief Provides the configuration of every fixed price item, by the position given through lookupItem
+        const ItemStore<int>& getFixedItems() const;
+
+        /// \brief Provides the configuration of every weight based item, by the position given through lookupItem
+        const ItemStore<double>& getWeightItems() const;
+
+    private:
+
+        friend class CatalogImage;
+
+        template <class T>
+        ReturnCode_t loadItem( std::string_view sku, const CatalogItem<T>& item, ItemStore<T>& items, ItemType_t type );
+
+        SkuIndex index;                                // locates every sku within the storage below
+        ItemStore<int>    fixed_items;  // configuration of fixed price items
+        ItemStore<double> weight_items; // configuration of weight based items
+        std::shared_ptr<const CatalogImage> image; // mapping the storage is read from, if any
+
+};
+
+#endif
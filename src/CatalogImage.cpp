@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Types.h"
+#include "Catalog.h"
+#include "CatalogImage.h"
+
+// Version 4 holds the index slots, the key pool, the key of every fixed price and then every weight
+// based item, then the six item arrays and three discount pools of the fixed price store followed by
+// those of the weight based store. Version 3 had no keys by item, version 2 had no pool of stacked
+// discounts, and version 1 held every field of every discount as an item array.
+static const char IMAGE_MAGIC[8] = { 'P', 'O', 'S', 'C', 'A', 'T', 'L', 'G' };
+static const uint32_t IMAGE_VERSION = 4;
+static const uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+static const size_t ITEM_COLUMNS = 6;
+static const size_t STORE_COLUMNS = ITEM_COLUMNS + 3;
+static const size_t INDEX_SECTIONS = 4;
+static const size_t IMAGE_SECTIONS = INDEX_SECTIONS + 2 * STORE_COLUMNS;
+static const size_t SECTION_ALIGNMENT = 64;
+
+struct ImageHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;   // reads back as IMAGE_BYTE_ORDER only on a machine with the same byte order
+    uint32_t slot_size;    // size of an index slot, which differs between ABIs
+    uint32_t header_size;
+    uint64_t file_size;
+    uint64_t sku_count;
+    uint64_t slot_count;
+    uint64_t key_bytes;
+    uint64_t item_count[2];             // fixed price items, then weight based items
+    uint64_t bundle_count[2];           // entries in the bundle discount pool of each store
+    uint64_t buy_x_get_y_count[2];      // entries in the buy x get y discount pool of each store
+    uint64_t stacked_count[2];          // entries in the stacked discount pool of each store
+    uint64_t offsets[IMAGE_SECTIONS];   // start of each array, from the start of the file
+};
+
+// Element sizes of the arrays of a store, in the order listColumns gives them
+static const size_t COLUMN_SIZES[STORE_COLUMNS] = { sizeof(Money), sizeof(uint8_t), sizeof(Money), sizeof(Money),
+                                                     sizeof(uint32_t), sizeof(uint8_t), sizeof(BundleDiscount),
+                                                     sizeof(BuyXGetYDiscount), sizeof(StackedDiscount) };
+
+static uint64_t alignSection( uint64_t offset )
+{
+    return (offset + SECTION_ALIGNMENT - 1) & ~static_cast<uint64_t>( SECTION_ALIGNMENT - 1 );
+}
+
+// Checks that every discount of a pool could have been made by the catalog, so pricing it is safe
+template <class D>
+static bool checkPool( const char* base, uint64_t offset, uint64_t count )
+{
+    const D* pool = reinterpret_cast<const D*>( base + offset );
+    for(uint64_t i = 0; i < count; i++)
+    {
+        if(!pool[i].isValid())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks the discounts of a store, and that each item refers to an entry of the pool for its discount
+static bool checkStore( const char* base, const uint64_t* offsets, const uint64_t* counts )
+{
+    if(!checkPool<BundleDiscount>( base, offsets[ITEM_COLUMNS], counts[1] ) ||
+       !checkPool<BuyXGetYDiscount>( base, offsets[ITEM_COLUMNS + 1], counts[2] ) ||
+       !checkPool<StackedDiscount>( base, offsets[ITEM_COLUMNS + 2], counts[3] ))
+    {
+        return false;
+    }
+
+    const uint8_t* types = reinterpret_cast<const uint8_t*>( base + offsets[1] );
+    const uint32_t* indexes = reinterpret_cast<const uint32_t*>( base + offsets[4] );
+    for(uint64_t i = 0; i < counts[0]; i++)
+    {
+        if(types[i] > STACKED_DISCOUNTS || (types[i] != NO_DISCOUNT && indexes[i] >= counts[types[i]]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+CatalogImage::CatalogImage()
+{
+    base = 0;
+    length = 0;
+}
+
+CatalogImage::~CatalogImage()
+{
+    if(base != 0)
+    {
+        munmap( const_cast<char*>( base ), length );
+    }
+}
+
+template <class T>
+void CatalogImage::listColumns( const ItemStore<T>& items, Column* columns )
+{
+    size_t count = items.size();
+
+    columns[0] = { items.net_price.data(), count * sizeof(Money) };
+    columns[1] = { items.discount_type.data(), count * sizeof(uint8_t) };
+    columns[2] = { items.price.data(), count * sizeof(Money) };
+    columns[3] = { items.markdown.data(), count * sizeof(Money) };
+    columns[4] = { items.discount_index.data(), count * sizeof(uint32_t) };
+    columns[5] = { items.flags.data(), count * sizeof(uint8_t) };
+    columns[6] = { items.bundle_discounts.data(), items.bundle_discounts.size() * sizeof(BundleDiscount) };
+    columns[7] = { items.buy_x_get_y_discounts.data(), items.buy_x_get_y_discounts.size() * sizeof(BuyXGetYDiscount) };
+    columns[8] = { items.stacked_discounts.data(), items.stacked_discounts.size() * sizeof(StackedDiscount) };
+}
+
+template <class T>
+void CatalogImage::attachColumns( ItemStore<T>& items, const uint64_t* offsets, const uint64_t* counts ) const
+{
+    items.net_price.attach( reinterpret_cast<const Money*>( base + offsets[0] ), counts[0] );
+    items.discount_type.attach( reinterpret_cast<const uint8_t*>( base + offsets[1] ), counts[0] );
+    items.price.attach( reinterpret_cast<const Money*>( base + offsets[2] ), counts[0] );
+    items.markdown.attach( reinterpret_cast<const Money*>( base + offsets[3] ), counts[0] );
+    items.discount_index.attach( reinterpret_cast<const uint32_t*>( base + offsets[4] ), counts[0] );
+    items.flags.attach( reinterpret_cast<const uint8_t*>( base + offsets[5] ), counts[0] );
+    items.bundle_discounts.attach( reinterpret_cast<const BundleDiscount*>( base + offsets[6] ), counts[1] );
+    items.buy_x_get_y_discounts.attach( reinterpret_cast<const BuyXGetYDiscount*>( base + offsets[7] ), counts[2] );
+    items.stacked_discounts.attach( reinterpret_cast<const StackedDiscount*>( base + offsets[8] ), counts[3] );
+
+    // tables and unused pool entries belong to the items that were replaced, the entries an image leaves
+    // unused stay that way
+    items.clearPriceTables();
+    for(std::vector<uint32_t>& free : items.free_discounts)
+    {
+        free.clear();
+    }
+}
+
+ReturnCode_t CatalogImage::write( const Catalog& catalog, const std::string& path )
+{
+    ImageHeader header;
+    Column columns[IMAGE_SECTIONS];
+
+    std::memset( &header, 0, sizeof(header) );
+    std::memcpy( header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC) );
+    header.version = IMAGE_VERSION;
+    header.byte_order = IMAGE_BYTE_ORDER;
+    header.slot_size = sizeof(SkuIndex::Slot);
+    header.header_size = sizeof(ImageHeader);
+    header.sku_count = catalog.index.size();
+    header.slot_count = catalog.index.slots.size();
+    header.key_bytes = catalog.index.keys.size();
+    header.item_count[0] = catalog.fixed_items.size();
+    header.item_count[1] = catalog.weight_items.size();
+    header.bundle_count[0] = catalog.fixed_items.bundle_discounts.size();
+    header.bundle_count[1] = catalog.weight_items.bundle_discounts.size();
+    header.buy_x_get_y_count[0] = catalog.fixed_items.buy_x_get_y_discounts.size();
+    header.buy_x_get_y_count[1] = catalog.weight_items.buy_x_get_y_discounts.size();
+    header.stacked_count[0] = catalog.fixed_items.stacked_discounts.size();
+    header.stacked_count[1] = catalog.weight_items.stacked_discounts.size();
+
+    columns[0] = { catalog.index.slots.data(), catalog.index.slots.size() * sizeof(SkuIndex::Slot) };
+    columns[1] = { catalog.index.keys.data(), catalog.index.keys.size() };
+    columns[2] = { catalog.index.fixed_keys.data(), catalog.index.fixed_keys.size() * sizeof(SkuIndex::KeyRef) };
+    columns[3] = { catalog.index.weight_keys.data(), catalog.index.weight_keys.size() * sizeof(SkuIndex::KeyRef) };
+    listColumns( catalog.fixed_items, columns + INDEX_SECTIONS );
+    listColumns( catalog.weight_items, columns + INDEX_SECTIONS + STORE_COLUMNS );
+
+    uint64_t offset = sizeof(ImageHeader);
+    for(size_t i = 0; i < IMAGE_SECTIONS; i++)
+    {
+        header.offsets[i] = alignSection( offset );
+        offset = header.offsets[i] + columns[i].bytes;
+    }
+    header.file_size = offset;
+
+    // the new image only replaces the old one once it has been written completely
+    std::string temporary = path + ".tmp";
+    std::ofstream file( temporary, std::ios::binary | std::ios::trunc );
+    if(!file)
+    {
+        return ERROR;
+    }
+
+    static const char padding[SECTION_ALIGNMENT] = { 0 };
+    file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+    offset = sizeof(ImageHeader);
+    for(size_t i = 0; i < IMAGE_SECTIONS; i++)
+    {
+        file.write( padding, static_cast<std::streamsize>( header.offsets[i] - offset ) );
+        file.write( static_cast<const char*>( columns[i].data ), static_cast<std::streamsize>( columns[i].bytes ) );
+        offset = header.offsets[i] + columns[i].bytes;
+    }
+
+    file.close();
+    if(!file || std::rename( temporary.c_str(), path.c_str() ) != 0)
+    {
+        std::remove( temporary.c_str() );
+        return ERROR;
+    }
+
+    return OK;
+}
+
+ReturnCode_t CatalogImage::open( const std::string& path, std::shared_ptr<const CatalogImage>* pImage )
+{
+    int descriptor = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if(descriptor < 0)
+    {
+        return INVALID_ARG;
+    }
+
+    struct stat status;
+    if(fstat( descriptor, &status ) != 0 || static_cast<size_t>( status.st_size ) < sizeof(ImageHeader))
+    {
+        close( descriptor );
+        return ERROR;
+    }
+
+    size_t length = static_cast<size_t>( status.st_size );
+    void* mapping = mmap( 0, length, PROT_READ, MAP_SHARED, descriptor, 0 );
+    close( descriptor );
+
+    if(mapping == MAP_FAILED)
+    {
+        return ERROR;
+    }
+
+    std::shared_ptr<CatalogImage> image( new CatalogImage() );
+    image->base = static_cast<const char*>( mapping );
+    image->length = length;
+
+    const ImageHeader* header = reinterpret_cast<const ImageHeader*>( image->base );
+    if(std::memcmp( header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC) ) != 0 || header->version != IMAGE_VERSION ||
+       header->byte_order != IMAGE_BYTE_ORDER || header->slot_size != sizeof(SkuIndex::Slot) ||
+       header->header_size != sizeof(ImageHeader) || header->file_size != length)
+    {
+        return ERROR;
+    }
+
+    // the table needs a power of two size with at least one empty slot, and positions must fit a handle
+    if(header->slot_count == 0 || (header->slot_count & (header->slot_count - 1)) != 0 ||
+       header->sku_count >= header->slot_count || header->key_bytes > UINT32_MAX ||
+       header->item_count[0] > 0x7FFFFFFF || header->item_count[1] > 0x7FFFFFFF)
+    {
+        return ERROR;
+    }
+
+    uint64_t bytes[IMAGE_SECTIONS];
+    bytes[0] = header->slot_count * sizeof(SkuIndex::Slot);
+    bytes[1] = header->key_bytes;
+    bytes[2] = header->item_count[0] * sizeof(SkuIndex::KeyRef);
+    bytes[3] = header->item_count[1] * sizeof(SkuIndex::KeyRef);
+    for(size_t store = 0; store < 2; store++)
+    {
+        // discounts are located by 32 bit positions, which also keeps the sizes below from overflowing
+        uint64_t counts[STORE_COLUMNS];
+        if(header->bundle_count[store] > UINT32_MAX || header->buy_x_get_y_count[store] > UINT32_MAX ||
+           header->stacked_count[store] > UINT32_MAX)
+        {
+            return ERROR;
+        }
+
+        std::fill( counts, counts + ITEM_COLUMNS, header->item_count[store] );
+        counts[ITEM_COLUMNS] = header->bundle_count[store];
+        counts[ITEM_COLUMNS + 1] = header->buy_x_get_y_count[store];
+        counts[ITEM_COLUMNS + 2] = header->stacked_count[store];
+
+        for(size_t i = 0; i < STORE_COLUMNS; i++)
+        {
+            bytes[INDEX_SECTIONS + store * STORE_COLUMNS + i] = counts[i] * COLUMN_SIZES[i];
+        }
+    }
+
+    for(size_t i = 0; i < IMAGE_SECTIONS; i++)
+    {
+        if(header->offsets[i] % SECTION_ALIGNMENT != 0 || header->offsets[i] > length ||
+           bytes[i] > length - header->offsets[i])
+        {
+            return ERROR;
+        }
+    }
+
+    // every position read through the index or an item is checked once, so lookups can trust them
+    const SkuIndex::Slot* slots = reinterpret_cast<const SkuIndex::Slot*>( image->base + header->offsets[0] );
+    uint64_t occupied = 0;
+    for(uint64_t i = 0; i < header->slot_count; i++)
+    {
+        const SkuIndex::Slot& slot = slots[i];
+        if(slot.hash == 0)
+        {
+            continue;
+        }
+
+        occupied++;
+        if(slot.key_offset > header->key_bytes || slot.key_length > header->key_bytes - slot.key_offset ||
+           (slot.entry.type != FIXED_PRICE_ITEM && slot.entry.type != WEIGHT_BASED_ITEM) ||
+           slot.entry.index >= header->item_count[slot.entry.type])
+        {
+            return ERROR;
+        }
+    }
+
+    auto checkKeys = [header]( const char* keys, uint64_t count )
+    {
+        const SkuIndex::KeyRef* refs = reinterpret_cast<const SkuIndex::KeyRef*>( keys );
+        for(uint64_t i = 0; i < count; i++)
+        {
+            if(refs[i].offset > header->key_bytes || refs[i].length > header->key_bytes - refs[i].offset)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const uint64_t fixed_counts[4] = { header->item_count[0], header->bundle_count[0], header->buy_x_get_y_count[0],
+                                       header->stacked_count[0] };
+    const uint64_t weight_counts[4] = { header->item_count[1], header->bundle_count[1], header->buy_x_get_y_count[1],
+                                        header->stacked_count[1] };
+
+    if(occupied != header->sku_count ||
+       !checkKeys( image->base + header->offsets[2], header->item_count[0] ) ||
+       !checkKeys( image->base + header->offsets[3], header->item_count[1] ) ||
+       !checkStore( image->base, header->offsets + INDEX_SECTIONS, fixed_counts ) ||
+       !checkStore( image->base, header->offsets + INDEX_SECTIONS + STORE_COLUMNS, weight_counts ))
+    {
+        return ERROR;
+    }
+
+    *pImage = image;
+    return OK;
+}
+
+void CatalogImage::attach( Catalog& catalog ) const
+{
+    const ImageHeader* header = reinterpret_cast<const ImageHeader*>( base );
+
+    catalog.index.slots.attach( reinterpret_cast<const SkuIndex::Slot*>( base + header->offsets[0] ), header->slot_count );
+    catalog.index.keys.attach( base + header->offsets[1], header->key_bytes );
+    catalog.index.fixed_keys.attach( reinterpret_cast<const SkuIndex::KeyRef*>( base + header->offsets[2] ), header->item_count[0] );
+    catalog.index.weight_keys.attach( reinterpret_cast<const SkuIndex::KeyRef*>( base + header->offsets[3] ), header->item_count[1] );
+    catalog.index.count = header->sku_count;
+
+    const uint64_t fixed_counts[4] = { header->item_count[0], header->bundle_count[0], header->buy_x_get_y_count[0],
+                                       header->stacked_count[0] };
+    const uint64_t weight_counts[4] = { header->item_count[1], header->bundle_count[1], header->buy_x_get_y_count[1],
+                                        header->stacked_count[1] };
+
+    attachColumns( catalog.fixed_items, header->offsets + INDEX_SECTIONS, fixed_counts );
+    attachColumns( catalog.weight_items, header->offsets + INDEX_SECTIONS + STORE_COLUMNS, weight_counts );
+}
+
+size_t CatalogImage::size() const
+{
+    return length;
+}
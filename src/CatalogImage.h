@@ -0,0 +1,91 @@
+#ifndef CATALOG_IMAGE_H
+#define CATALOG_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Types.h"
+#include "ItemStore.h"
+
+class Catalog;
+
+/// \class CatalogImage
+/// \brief Binary file holding a complete Catalog that can be mapped into memory and used in place
+///
+/// The image holds the hash table of the SkuIndex, the pool of SKU characters, the key of each item, and
+/// every array of the fixed price and weight based ItemStore, exactly as they are laid out in memory. Nothing in the file is
+/// a pointer, so it can be mapped at any address. Opening an image maps the file read-only and points the
+/// catalog at it without copying anything, and every process that maps the same file shares one copy of
+/// it through the page cache.
+///
+/// The file starts with a header giving the format version, the byte order and layout it was written
+/// with, and the location of each array. An image written by a different version of the format or on a
+/// machine with a different layout is rejected rather than being converted. When the file is opened the
+/// header is checked, and the index, the keys, the discount of each item and the discount pools are read
+/// through once to check that every position they hold lies within its array and every discount could
+/// have been made by the catalog. Prices are not checked, since no value of them is unsafe to use.
+///
+/// A catalog that is using an image can still be changed. The first change to each array copies it out
+/// of the mapping, so the file itself is never modified.
+class CatalogImage
+{
+    public:
+
+        ~CatalogImage();
+
+        /// \brief Saves the current contents of a catalog as an image
+        ///
+        /// The image is written to a temporary file beside the path and then renamed over it, so processes
+        /// that have the previous image mapped keep reading a complete copy.
+        ///
+        /// \param catalog The catalog being saved
+        /// \param path Location of the image file
+        /// \return OK, or ERROR if the file could not be written
+        static ReturnCode_t write( const Catalog& catalog, const std::string& path );
+
+        /// \brief Maps an image into memory
+        ///
+        /// \param path Location of the image file
+        /// \param pImage Location that the opened image is stored
+        /// \return OK, INVALID_ARG when the file cannot be opened, or ERROR when it is not a valid image
+        static ReturnCode_t open( const std::string& path, std::shared_ptr<const CatalogImage>* pImage );
+
+        /// \brief Points every array of a catalog at the contents of the image
+        ///
+        /// \param catalog The catalog that takes on the contents of the image, must not outlive the image
+        void attach( Catalog& catalog ) const;
+
+        /// \brief Provides the number of bytes in the image
+        size_t size() const;
+
+    private:
+
+        /// \brief Location and size of one array when writing an image
+        struct Column
+        {
+            const void* data;
+            size_t bytes;
+        };
+
+        CatalogImage();
+
+        /// \brief Lists the arrays of a store in the order they are stored within the image
+        template <class T>
+        static void listColumns( const ItemStore<T>& items, Column* columns );
+
+        /// \brief Points the arrays of a store at the image
+        ///
+        /// \param items The store being attached
+        /// \param offsets Start of each array of the store within the image
+        /// \param counts Number of items, of bundle discounts, of buy x get y discounts and of stacked discounts in the store
+        template <class T>
+        void attachColumns( ItemStore<T>& items, const uint64_t* offsets, const uint64_t* counts ) const;
+
+        const char* base;   // start of the mapping
+        size_t length;      // number of bytes mapped
+
+};
+
+#endif
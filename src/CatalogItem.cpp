@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Types.h"
+#include "Money.h"
+#include "CatalogItem.h"
+
+// By default, a template class definition and the implementation must be
+// in the same file. This is due to the compilation process generating the
+// class as it is utilized within the file. By adding these statements, the
+// compiler is told to always create these variants of the CatalogItem class so
+// that that symbols are available during linking.
+template class CatalogItem<int>;
+template class CatalogItem<double>;
+
+template <class T>
+CatalogItem<T>::CatalogItem()
+{
+    price = 0;
+    is_price_set = false;
+    markdown = 0;
+}
+
+template <class T>
+CatalogItem<T>::~CatalogItem()
+{
+
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::checkPrice( double amount ) const
+{
+    // a price too small to be held as Money would leave the item free, and one that is not a
+    // finite number can not be held at all
+    if(!std::isfinite(amount) || amount <= 0.0 || toMoney(amount) <= 0)
+    {
+        return INVALID_PRICE;
+    }
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::checkMarkdown( double amount ) const
+{
+    if(!is_price_set)
+    {
+        return NO_PRICE_DEFINED;
+    }
+
+    if(amount < 0 || toMoney(amount) > price)
+    {
+        return INVALID_PRICE;
+    }
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::setPrice( double amount )
+{
+    ReturnCode_t code = checkPrice( amount );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    price = toMoney( amount );
+    is_price_set = true;
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::applyMarkdown( double amount )
+{
+    ReturnCode_t code = checkMarkdown( amount );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    markdown = toMoney( amount );
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::applyGetXforPriceDiscount( T buy_amount, double price )
+{
+    if(buy_amount < 0 || price < 0)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return setBundle( toQuantity( buy_amount ), NO_LIMIT, toMoney( price ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::applyGetXforPriceDiscount( T buy_amount, double price, T limit )
+{
+    if(buy_amount < 0 || price < 0 || limit <= 0 || limit < buy_amount)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return setBundle( toQuantity( buy_amount ), toQuantity( limit ), toMoney( price ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off )
+{
+    if(buy_x < 0 || get_y < 0 || percent_off < 0)
+    {
+        return INVALID_DISCOUNT;
+    }
+    if(percent_off > 1.0)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return setBuyXGetY( toQuantity( buy_x ), toQuantity( get_y ), NO_LIMIT, toRate( percent_off ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off, T limit )
+{
+    if(buy_x < 0 || get_y < 0 || percent_off < 0 || limit <= 0 || limit < buy_x)
+    {
+        return INVALID_DISCOUNT;
+    }
+    if(percent_off > 1.0)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return setBuyXGetY( toQuantity( buy_x ), toQuantity( get_y ), toQuantity( limit ), toRate( percent_off ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::addGetXforPriceDiscount( T buy_amount, double price )
+{
+    Discount previous = discount;
+    return stackWith( previous, applyGetXforPriceDiscount( buy_amount, price ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::addGetXforPriceDiscount( T buy_amount, double price, T limit )
+{
+    Discount previous = discount;
+    return stackWith( previous, applyGetXforPriceDiscount( buy_amount, price, limit ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::addBuyXGetYDiscount( T buy_x, T get_y, double percent_off )
+{
+    Discount previous = discount;
+    return stackWith( previous, applyBuyXGetYDiscount( buy_x, get_y, percent_off ) );
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::addBuyXGetYDiscount( T buy_x, T get_y, double percent_off, T limit )
+{
+    Discount previous = discount;
+    return stackWith( previous, applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit ) );
+}
+
+template <class T>
+bool CatalogItem<T>::isPriceSet() const
+{
+    return is_price_set;
+}
+
+template <class T>
+const Discount& CatalogItem<T>::getDiscount() const
+{
+    return discount;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::computePreTax( Quantity amount, Money *pTaxAmount ) const
+{
+    *pTaxAmount = priceWithDiscount<T>( discount, amount, price - markdown );
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::setBundle( Quantity size, Quantity limit, Money bundle_price )
+{
+    // an empty bundle takes nothing off, so there is nothing to keep
+    if(size == 0)
+    {
+        discount = NoDiscount();
+    }
+    else
+    {
+        discount = BundleDiscount{ size, limit, bundle_price };
+    }
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::setBuyXGetY( Quantity buy, Quantity get, Quantity limit, int64_t rate )
+{
+    if(buy + get == 0)
+    {
+        discount = NoDiscount();
+    }
+    else
+    {
+        discount = BuyXGetYDiscount{ buy, get, limit, rate };
+    }
+
+    return OK;
+}
+
+template <class T>
+ReturnCode_t CatalogItem<T>::stackWith( const Discount& previous, ReturnCode_t code )
+{
+    // the discount was validated and applied on its own, so only the room left in the stack can reject it now
+    if(code != OK)
+    {
+        return code;
+    }
+
+    if(!stackDiscounts( previous, &discount ))
+    {
+        discount = previous;
+        return INVALID_DISCOUNT;
+    }
+
+    return OK;
+}
@@ -0,0 +1,168 @@
+#ifndef CATALOG_ITEM_H
+#define CATALOG_ITEM_H
+
+#include "Types.h"
+#include "Money.h"
+#include "DiscountPolicy.h"
+
+template <class T>
+class ItemStore;
+
+/// \class CatalogItem
+/// \brief Holds the price, markdown and discount configured for a single SKU
+///
+/// The CatalogItem class contains everything needed to price an item except for the amount
+/// being purchased. This allows a single configuration to be shared by any number of carts
+/// that are being checked out at the same time. The amount in a particular cart is provided
+/// when the pre-tax cost is computed. As with the CartItem class, templates allow the same
+/// logic to be used for fixed price items and weight based items.
+///
+/// The configuration is held as integer Money and Quantity values. Amounts given through the API are
+/// converted once when they are configured, and the pre-tax cost is computed entirely in integers so the
+/// same amount always produces the same cost.
+///
+/// The discount is held as a Discount, which keeps only the fields of the discount that was configured and
+/// prices the item with the evaluator written for that discount.
+template <class T>
+class CatalogItem {
+
+    public:
+
+        CatalogItem();
+        ~CatalogItem();
+
+        /// \brief Allows for setting price for the item
+        ///
+        /// Each item has a price that is defined. This price will either apply to a single
+        /// item or to a pound of the item.
+        ///
+        /// \param price Cost per item/pound of the item
+        ReturnCode_t setPrice( double price );
+
+        /// \brief Allows for setting a reduction in the price of the item
+        ///
+        /// The marked down value is subtracted from the configured price before all computations are
+        /// performed on the cost. A price must have been set before a markdown can be applied.
+        ///
+        /// \param amount Amount to take off the normal price for the special
+        ReturnCode_t applyMarkdown( double amount );
+
+        /// \brief Verifies that a price is acceptable without applying it
+        ///
+        /// \param price Cost per item/pound of the item
+        ReturnCode_t checkPrice( double price ) const;
+
+        /// \brief Verifies that a markdown is acceptable for the current price without applying it
+        ///
+        /// \param amount Amount to take off the normal price for the special
+        ReturnCode_t checkMarkdown( double amount ) const;
+
+        /// \brief Configures a discount where multiples of the item are sold for a single price
+        ///
+        /// \param buy_amount The number of items, or pounds, that the customer is allowed for the specified price
+        /// \param price The cost for acquiring all the items, or pounds
+        ReturnCode_t applyGetXforPriceDiscount( T buy_amount, double price );
+
+        /// \brief Configures a discount where multiples of the item are sold for a single price, up to a limit
+        ///
+        /// \param buy_amount The number of items, or pounds, that the customer is allowed for the specified price
+        /// \param price The cost for acquiring all the items, or pounds
+        /// \param limit The maximum number of items, or pounds, that the customer is able to buy using the discount
+        ReturnCode_t applyGetXforPriceDiscount( T buy_amount, double price, T limit );
+
+        /// \brief Configures a discount where items are sold at a reduced rate after others are bought at full price
+        ///
+        /// \param buy_x The number of items, or pounds, that must be purchased at full price
+        /// \param get_y The number of items, or pounds, that are able to be purchased at a discounted rate
+        /// \param percent_off The amount of savings given to the customer, must be between 0 and 1
+        ReturnCode_t applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off );
+
+        /// \brief Configures a discount where items are sold at a reduced rate after others are bought at full price, up to a limit
+        ///
+        /// \param buy_x The number of items, or pounds, that must be purchased at full price
+        /// \param get_y The number of items, or pounds, that are able to be purchased at a discounted rate
+        /// \param percent_off The amount of savings given to the customer, must be between 0 and 1
+        /// \param limit Allows for placing a limit on the number of items that an be purchased with this discount
+        ReturnCode_t applyBuyXGetYDiscount( T buy_x, T get_y, double percent_off, T limit );
+
+        /// \brief Offers a discount where multiples of the item are sold for a single price alongside the discounts already configured
+        ///
+        /// The apply functions replace the discount of the item, while the add functions keep every discount
+        /// already offered and let the customer have the cheapest combination, see StackedDiscount.
+        ///
+        /// \param buy_amount The number of items, or pounds, that the customer is allowed for the specified price
+        /// \param price The cost for acquiring all the items, or pounds
+        /// \return INVALID_DISCOUNT for invalid values or when MAX_STACKED_DISCOUNTS bundles are already offered
+        ReturnCode_t addGetXforPriceDiscount( T buy_amount, double price );
+
+        /// \brief Offers a discount where multiples of the item are sold for a single price, up to a limit, alongside the discounts already configured
+        ///
+        /// \param buy_amount The number of items, or pounds, that the customer is allowed for the specified price
+        /// \param price The cost for acquiring all the items, or pounds
+        /// \param limit The maximum number of items, or pounds, that the customer is able to buy using the discount
+        ReturnCode_t addGetXforPriceDiscount( T buy_amount, double price, T limit );
+
+        /// \brief Offers a buy x get y discount alongside the discounts already configured
+        ///
+        /// \param buy_x The number of items, or pounds, that must be purchased at full price
+        /// \param get_y The number of items, or pounds, that are able to be purchased at a discounted rate
+        /// \param percent_off The amount of savings given to the customer, must be between 0 and 1
+        /// \return INVALID_DISCOUNT for invalid values or when MAX_STACKED_DISCOUNTS of them are already offered
+        ReturnCode_t addBuyXGetYDiscount( T buy_x, T get_y, double percent_off );
+
+        /// \brief Offers a buy x get y discount, up to a limit, alongside the discounts already configured
+        ///
+        /// \param buy_x The number of items, or pounds, that must be purchased at full price
+        /// \param get_y The number of items, or pounds, that are able to be purchased at a discounted rate
+        /// \param percent_off The amount of savings given to the customer, must be between 0 and 1
+        /// \param limit Allows for placing a limit on the number of items that an be purchased with this discount
+        ReturnCode_t addBuyXGetYDiscount( T buy_x, T get_y, double percent_off, T limit );
+
+        /// \brief Indicates whether a valid price has been configured for the item
+        bool isPriceSet() const;
+
+        /// \brief Provides the discount configured for the item
+        const Discount& getDiscount() const;
+
+        /// \brief Calculates the pre-tax cost of the given amount of the item
+        ///
+        /// This function will compute the pre-tax cost of purchasing the amount of the item. This calcution
+        /// will take into affect any markdowns and/or discounts that have been applied. A single discount is
+        /// evaluated arithmetically, so the cost of the calculation does not grow with the amount. Stacked
+        /// discounts take time that grows with the amount only up to a range set by their sizes, see
+        /// StackedDiscount.
+        ///
+        /// With a single discount, the cost of the items sold at the full price and of the items sold at a
+        /// percentage off are each rounded half away from zero to the nearest Money unit, and items sold as
+        /// part of a bundle are charged the bundle price exactly. Stacked discounts round the line once.
+        ///
+        /// \param amount The number of items, or thousandths of a pound, being purchased
+        /// \param pTaxAmount Location that the computed pre-tax figure should be stored
+        ReturnCode_t computePreTax( Quantity amount, Money *pTaxAmount ) const;
+
+    private:
+
+        friend class ItemStore<T>;
+
+        /// \brief Replaces the discount with a bundle, or with none when the bundle is empty
+        ReturnCode_t setBundle( Quantity size, Quantity limit, Money bundle_price );
+
+        /// \brief Replaces the discount with a buy x get y discount, or with none when the cycle is empty
+        ReturnCode_t setBuyXGetY( Quantity buy, Quantity get, Quantity limit, int64_t rate );
+
+        /// \brief Offers the discount held before the last one was applied alongside it
+        ///
+        /// \param previous The discount held before the last one was applied
+        /// \param code Result of applying the last discount, nothing is changed unless it is OK
+        ReturnCode_t stackWith( const Discount& previous, ReturnCode_t code );
+
+        // All related to the price and markdown
+        Money price;       // configured full price for the item
+        bool is_price_set; // keep track of when price has been set
+        Money markdown;    // amount of markdown that is programmed, defaults to 0
+
+        Discount discount; // discount associated with the item, if any
+
+};
+
+#endif
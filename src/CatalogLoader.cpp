@@ -0,0 +1,493 @@
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "Types.h"
+#include "CatalogLoader.h"
+
+// A row holds at most the sku, type, price, markdown, discount kind and four discount arguments
+static const size_t MAX_FIELDS = 9;
+static const size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+static std::string_view trim( std::string_view field )
+{
+    while(field.length() > 0 && field.front() == ' ')
+    {
+        field.remove_prefix( 1 );
+    }
+
+    while(field.length() > 0 && (field.back() == ' ' || field.back() == '\r'))
+    {
+        field.remove_suffix( 1 );
+    }
+
+    return field;
+}
+
+static bool equalsIgnoreCase( std::string_view field, const char* text )
+{
+    size_t length = std::strlen( text );
+    if(field.length() != length)
+    {
+        return false;
+    }
+
+    for(size_t i = 0; i < length; i++)
+    {
+        if((field[i] | 0x20) != text[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Converts the whole of a field, rejecting anything that is not a finite number
+static bool parseAmount( std::string_view field, double* pValue )
+{
+    const char* end = field.data() + field.length();
+    std::from_chars_result result = std::from_chars( field.data(), end, *pValue );
+
+    return field.length() > 0 && result.ec == std::errc() && result.ptr == end && std::isfinite( *pValue );
+}
+
+// Amounts of fixed price items must be whole numbers that an int is able to hold
+static bool parseAmount( std::string_view field, int* pValue )
+{
+    double value = 0;
+    if(!parseAmount( field, &value ) || !(value >= INT_MIN && value <= INT_MAX) || value != std::floor( value ))
+    {
+        return false;
+    }
+
+    *pValue = static_cast<int>( value );
+    return true;
+}
+
+// The catalog only offers the bundle price discount for fixed price items
+static ReturnCode_t applyGetXForPrice( const std::string_view* args, size_t count, CatalogItem<int>& item )
+{
+    int buy_x = 0;
+    int limit = 0;
+    double price = 0;
+    bool limited = (count == 3);
+
+    if((count != 2 && count != 3) || !parseAmount( args[0], &buy_x ) || !parseAmount( args[1], &price ) ||
+       (limited && !parseAmount( args[2], &limit )))
+    {
+        return INVALID_ARG;
+    }
+
+    if(Catalog::checkGetXForYDiscount( buy_x, price, limited, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return limited ? item.applyGetXforPriceDiscount( buy_x, price, limit ) : item.applyGetXforPriceDiscount( buy_x, price );
+}
+
+static ReturnCode_t applyGetXForPrice( const std::string_view*, size_t, CatalogItem<double>& )
+{
+    return ITEM_CONFLICT;
+}
+
+template <class T>
+static ReturnCode_t applyBuyXGetY( const std::string_view* args, size_t count, CatalogItem<T>& item )
+{
+    T buy_x = 0;
+    T get_y = 0;
+    T limit = 0;
+    double percent_off = 0;
+    bool limited = (count == 4);
+
+    if((count != 3 && count != 4) || !parseAmount( args[0], &buy_x ) || !parseAmount( args[1], &get_y ) ||
+       !parseAmount( args[2], &percent_off ) || (limited && !parseAmount( args[3], &limit )))
+    {
+        return INVALID_ARG;
+    }
+
+    if(Catalog::checkBuyXGetYAtDiscount( buy_x, get_y, percent_off, limited, limit ) != OK)
+    {
+        return INVALID_DISCOUNT;
+    }
+
+    return limited ? item.applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit ) : item.applyBuyXGetYDiscount( buy_x, get_y, percent_off );
+}
+
+// Builds the configuration of an item through the same calls used to configure it one step at a time
+template <class T>
+static ReturnCode_t parseItem( const std::string_view* fields, size_t count, CatalogItem<T>& item )
+{
+    double price = 0;
+    double markdown = 0;
+
+    if(!parseAmount( fields[2], &price ))
+    {
+        return INVALID_ARG;
+    }
+
+    ReturnCode_t code = item.setPrice( price );
+    if(code != OK || count <= 3)
+    {
+        return code;
+    }
+
+    if(fields[3].length() > 0)
+    {
+        if(!parseAmount( fields[3], &markdown ))
+        {
+            return INVALID_ARG;
+        }
+
+        code = item.applyMarkdown( markdown );
+        if(code != OK)
+        {
+            return code;
+        }
+    }
+
+    if(count <= 4 || fields[4].length() == 0)
+    {
+        return (count <= 5) ? OK : INVALID_ARG;
+    }
+    else if(fields[4] == "xfor")
+    {
+        return applyGetXForPrice( fields + 5, count - 5, item );
+    }
+    else if(fields[4] == "bxgy")
+    {
+        return applyBuyXGetY( fields + 5, count - 5, item );
+    }
+
+    return INVALID_ARG;
+}
+
+CatalogLoader::CatalogLoader( Catalog& catalog ) : catalog( catalog )
+{
+    chunk_size = DEFAULT_CHUNK_SIZE;
+    lines_read = 0;
+    chunk_number = 0;
+    parsing = 0;
+    load_ended = false;
+    setThreadCount( std::thread::hardware_concurrency() );
+}
+
+CatalogLoader::~CatalogLoader()
+{
+
+}
+
+void CatalogLoader::setThreadCount( unsigned count )
+{
+    thread_count = (count < 1) ? 1 : count;
+    slices.resize( thread_count );
+}
+
+void CatalogLoader::setChunkSize( size_t bytes )
+{
+    chunk_size = (bytes < 1) ? 1 : bytes;
+}
+
+ReturnCode_t CatalogLoader::loadFile( const std::string& path, LoadReport* pReport )
+{
+    std::ifstream file( path, std::ios::binary );
+
+    if(!file)
+    {
+        if(pReport != 0)
+        {
+            *pReport = LoadReport();
+        }
+
+        return INVALID_ARG;
+    }
+
+    return loadStream( file, pReport );
+}
+
+ReturnCode_t CatalogLoader::loadStream( std::istream& input, LoadReport* pReport )
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LoadReport report = LoadReport();
+    std::string buffer;
+    size_t carried = 0;
+    bool read_failed = false;
+
+    lines_read = 0;
+    startWorkers();
+
+    while(true)
+    {
+        buffer.resize( carried + chunk_size );
+        input.read( &buffer[carried], static_cast<std::streamsize>( chunk_size ) );
+
+        size_t filled = carried + static_cast<size_t>( input.gcount() );
+
+        // a read that stops short of the end of the stream may have cut a row in half, so nothing more is loaded
+        if(input.bad() || (input.fail() && !input.eof()))
+        {
+            read_failed = true;
+            break;
+        }
+        if(!input)
+        {
+            loadChunk( buffer.data(), buffer.data() + filled, report );
+            break;
+        }
+
+        // only whole lines are parsed, the partial line at the end is carried into the next chunk
+        size_t last = std::string_view( buffer.data(), filled ).rfind( '\n' );
+        if(last == std::string_view::npos)
+        {
+            carried = filled;
+            continue;
+        }
+
+        loadChunk( buffer.data(), buffer.data() + last + 1, report );
+
+        carried = filled - (last + 1);
+        std::memmove( &buffer[0], buffer.data() + last + 1, carried );
+    }
+
+    stopWorkers();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    report.seconds = elapsed.count();
+    report.rows_per_second = (report.seconds > 0) ? (report.rows_loaded + report.rows_failed) / report.seconds : 0;
+
+    ReturnCode_t code = (report.rows_failed == 0 && !read_failed) ? OK : ERROR;
+    if(pReport != 0)
+    {
+        *pReport = std::move( report );
+    }
+
+    return code;
+}
+
+void CatalogLoader::startWorkers()
+{
+    chunk_number = 0;
+    parsing = 0;
+    load_ended = false;
+
+    for(size_t i = 1; i < slices.size(); i++)
+    {
+        workers.emplace_back( &CatalogLoader::runWorker, this, i );
+    }
+}
+
+void CatalogLoader::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock( chunk_lock );
+        load_ended = true;
+    }
+    chunk_ready.notify_all();
+
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void CatalogLoader::runWorker( size_t index )
+{
+    uint64_t seen = 0;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock( chunk_lock );
+            chunk_ready.wait( lock, [this, seen]() { return load_ended || chunk_number != seen; } );
+
+            // every chunk handed out is parsed before the load ends
+            if(chunk_number == seen)
+            {
+                return;
+            }
+            seen = chunk_number;
+        }
+
+        parseSlice( &slices[index] );
+
+        std::lock_guard<std::mutex> lock( chunk_lock );
+        if(--parsing == 0)
+        {
+            chunk_parsed.notify_one();
+        }
+    }
+}
+
+void CatalogLoader::loadChunk( const char* begin, const char* end, LoadReport& report )
+{
+    size_t share = static_cast<size_t>( end - begin ) / thread_count;
+
+    // give each thread an even share of the chunk, moving each boundary forward to the end of a line
+    const char* position = begin;
+    for(size_t i = 0; i < slices.size(); i++)
+    {
+        const char* boundary = (i + 1 == slices.size() || share >= static_cast<size_t>( end - position )) ? end : position + share;
+        const char* newline = static_cast<const char*>( std::memchr( boundary, '\n', end - boundary ) );
+
+        slices[i].begin = position;
+        slices[i].end = (newline == 0) ? end : newline + 1;
+        position = slices[i].end;
+    }
+
+    // the slices are handed to the workers under the lock, which also publishes their results back
+    {
+        std::lock_guard<std::mutex> lock( chunk_lock );
+        chunk_number++;
+        parsing = slices.size() - 1;
+    }
+    chunk_ready.notify_all();
+
+    parseSlice( &slices[0] );
+
+    std::unique_lock<std::mutex> lock( chunk_lock );
+    chunk_parsed.wait( lock, [this]() { return parsing == 0; } );
+    lock.unlock();
+
+    size_t fixed_count = 0;
+    size_t weight_count = 0;
+    for(const Slice& slice : slices)
+    {
+        for(const Row& row : slice.rows)
+        {
+            fixed_count += (row.code == OK && row.type == FIXED_PRICE_ITEM) ? 1 : 0;
+            weight_count += (row.code == OK && row.type == WEIGHT_BASED_ITEM) ? 1 : 0;
+        }
+    }
+
+    catalog.reserve( fixed_count, weight_count );
+
+    // the rows are applied in file order so that later rows for a sku win
+    for(const Slice& slice : slices)
+    {
+        for(const Row& row : slice.rows)
+        {
+            if(row.header && lines_read + row.line == 1)
+            {
+                continue;
+            }
+
+            ReturnCode_t code = row.code;
+            if(code == OK && row.type == FIXED_PRICE_ITEM)
+            {
+                code = catalog.loadItem( row.sku, row.fixed );
+            }
+            else if(code == OK)
+            {
+                code = catalog.loadItem( row.sku, row.weight );
+            }
+
+            if(code == OK)
+            {
+                report.rows_loaded++;
+            }
+            else
+            {
+                LoadError error = { lines_read + row.line, code };
+                report.errors.push_back( error );
+                report.rows_failed++;
+            }
+        }
+
+        lines_read += slice.lines;
+    }
+}
+
+void CatalogLoader::parseSlice( Slice* pSlice )
+{
+    const char* position = pSlice->begin;
+
+    pSlice->rows.clear();
+    pSlice->lines = 0;
+
+    while(position < pSlice->end)
+    {
+        const char* newline = static_cast<const char*>( std::memchr( position, '\n', pSlice->end - position ) );
+        const char* line_end = (newline == 0) ? pSlice->end : newline;
+
+        pSlice->lines++;
+        pSlice->rows.emplace_back();
+
+        Row& row = pSlice->rows.back();
+        row.line = pSlice->lines;
+        if(!parseRow( std::string_view( position, line_end - position ), &row ))
+        {
+            pSlice->rows.pop_back();
+        }
+
+        position = line_end + 1;
+    }
+}
+
+bool CatalogLoader::parseRow( std::string_view line, Row* pRow )
+{
+    std::string_view fields[MAX_FIELDS];
+    size_t count = 0;
+
+    line = trim( line );
+    if(line.length() == 0 || line.front() == '#')
+    {
+        return false;
+    }
+
+    char separator = (line.find( '\t' ) != std::string_view::npos) ? '\t' : ',';
+    while(true)
+    {
+        // anything left over once every field is filled means the row has too many fields
+        if(count == MAX_FIELDS)
+        {
+            count++;
+            break;
+        }
+
+        size_t next = line.find( separator );
+        fields[count++] = trim( line.substr( 0, next ) );
+
+        if(next == std::string_view::npos)
+        {
+            break;
+        }
+
+        line.remove_prefix( next + 1 );
+    }
+
+    // only the first line of the file may be a header, which is decided once the line within the file is known
+    pRow->header = equalsIgnoreCase( fields[0], "sku" );
+    pRow->sku = fields[0];
+    pRow->type = FIXED_PRICE_ITEM;
+
+    if(count < 3 || count > MAX_FIELDS)
+    {
+        pRow->code = INVALID_ARG;
+    }
+    else if(fields[0].length() == 0)
+    {
+        pRow->code = INVALID_SKU;
+    }
+    else if(fields[1] == "each")
+    {
+        pRow->code = parseItem( fields, count, pRow->fixed );
+    }
+    else if(fields[1] == "lb")
+    {
+        pRow->type = WEIGHT_BASED_ITEM;
+        pRow->code = parseItem( fields, count, pRow->weight );
+    }
+    else
+    {
+        pRow->code = INVALID_ARG;
+    }
+
+    return true;
+}
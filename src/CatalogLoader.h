@@ -0,0 +1,154 @@
+#ifndef CATALOG_LOADER_H
+#define CATALOG_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Types.h"
+#include "Catalog.h"
+#include "CatalogItem.h"
+
+/// \struct LoadError
+/// \brief Identifies a row of a price file that could not be loaded
+struct LoadError
+{
+    size_t line;         ///< Line of the file holding the row, starting from 1
+    ReturnCode_t code;   ///< Reason the row was rejected
+};
+
+/// \struct LoadReport
+/// \brief Summarizes the outcome of loading a price file
+struct LoadReport
+{
+    size_t rows_loaded;              ///< Number of rows applied to the catalog
+    size_t rows_failed;              ///< Number of rows that were rejected
+    double seconds;                  ///< Time taken to read, parse and apply the file
+    double rows_per_second;          ///< Rows processed, loaded or not, per second
+    std::vector<LoadError> errors;   ///< Line and reason for every rejected row, in file order
+};
+
+/// \class CatalogLoader
+/// \brief Loads the configuration of many items into a Catalog from a CSV or TSV price file
+///
+/// Each line of the file describes the complete configuration of one SKU:
+///
+///     sku,type,price[,markdown[,xfor,buy_x,price[,limit]]]
+///     sku,type,price[,markdown[,bxgy,buy_x,get_y,percent_off[,limit]]]
+///
+/// The type is either "each" for fixed price items or "lb" for weight based items. The markdown may be left
+/// empty when a discount follows. Fields are separated by tabs when the line contains one, otherwise by
+/// commas. Blank lines, lines starting with '#' and a first line whose first field is "sku" are skipped. A
+/// row on any other line whose first field is "sku" is loaded like any other row.
+///
+/// Every row is checked with the same rules that apply when an item is configured one call at a time, and
+/// a rejected row is reported with the ReturnCode_t those calls would have returned. Malformed fields are
+/// reported as INVALID_ARG. Rows are applied in file order, so a later row for a SKU replaces an earlier one.
+///
+/// The file is read in chunks of whole lines. Each chunk is split between a number of threads that parse
+/// their share of the rows at the same time, after which the rows are added to the catalog by the calling
+/// thread. The threads are started once for each load and kept for every chunk of it. The storage of the
+/// catalog is sized once per chunk rather than growing item by item.
+class CatalogLoader
+{
+    public:
+
+        /// \brief Creates a loader that adds items to the given catalog
+        ///
+        /// \param catalog Catalog receiving the items, must outlive the loader
+        CatalogLoader( Catalog& catalog );
+        ~CatalogLoader();
+
+        /// \brief Sets the number of threads that parse each chunk, defaults to the number of processors
+        ///
+        /// \param count Number of threads, including the calling thread, values below 1 are treated as 1
+        void setThreadCount( unsigned count );
+
+        /// \brief Sets the number of bytes read from the file at a time, defaults to 1 MB
+        ///
+        /// \param bytes Size of each chunk, a line longer than this is read whole
+        void setChunkSize( size_t bytes );
+
+        /// \brief Loads every row of a price file into the catalog
+        ///
+        /// \param path Location of the price file
+        /// \param pReport Location that the outcome of the load is stored, may be null
+        /// \return OK when every row was loaded, INVALID_ARG when the file cannot be opened, otherwise ERROR,
+        ///         including when the file could not be read to its end
+        ReturnCode_t loadFile( const std::string& path, LoadReport* pReport );
+
+        /// \brief Loads every row read from a stream into the catalog
+        ///
+        /// A read that fails before the end of the stream ends the load. The rows of the chunks read before it
+        /// stay loaded, while the partly read chunk is dropped.
+        ///
+        /// \param input Stream supplying the contents of a price file
+        /// \param pReport Location that the outcome of the load is stored, may be null
+        /// \return OK when every row was loaded, otherwise ERROR, including when the stream could not be read
+        ///         to its end
+        ReturnCode_t loadStream( std::istream& input, LoadReport* pReport );
+
+    private:
+
+        /// \brief Outcome of parsing a single row
+        struct Row
+        {
+            size_t line;                 // line within the slice, replaced by the line within the file
+            ReturnCode_t code;           // OK when the item below is ready to be loaded
+            ItemType_t type;             // which of the items below holds the configuration
+            bool header;                 // first field is "sku", skipped when on the first line of the file
+            std::string_view sku;        // refers to the chunk being loaded
+            CatalogItem<int> fixed;
+            CatalogItem<double> weight;
+        };
+
+        /// \brief Portion of a chunk parsed by a single thread
+        struct Slice
+        {
+            const char* begin;
+            const char* end;
+            size_t lines;                // number of lines within the slice
+            std::vector<Row> rows;       // rows that were not skipped, kept between chunks
+        };
+
+        /// \brief Parses every line of a slice
+        static void parseSlice( Slice* pSlice );
+
+        /// \brief Parses a single line, returning false when the line holds no row
+        static bool parseRow( std::string_view line, Row* pRow );
+
+        /// \brief Parses the rows of a chunk of whole lines and applies them to the catalog
+        void loadChunk( const char* begin, const char* end, LoadReport& report );
+
+        /// \brief Starts a thread for every slice but the first, which is parsed by the calling thread
+        void startWorkers();
+
+        /// \brief Ends the load for the threads started by startWorkers and waits for them to exit
+        void stopWorkers();
+
+        /// \brief Parses one slice of every chunk handed out until the load ends
+        void runWorker( size_t index );
+
+        Catalog& catalog;
+        unsigned thread_count;
+        size_t chunk_size;
+        size_t lines_read;            // lines of the file before the current chunk
+        std::vector<Slice> slices;    // one for each thread, reused for every chunk
+
+        std::vector<std::thread> workers;        // parse every slice but the first, for the length of a load
+        std::mutex chunk_lock;                   // guards the fields below
+        std::condition_variable chunk_ready;     // signalled when a chunk is handed out or the load ends
+        std::condition_variable chunk_parsed;    // signalled when the last worker finishes its slice
+        uint64_t chunk_number;                   // counts the chunks handed out during a load
+        size_t parsing;                          // workers still parsing the current chunk
+        bool load_ended;
+
+};
+
+#endif
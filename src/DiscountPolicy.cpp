@@ -0,0 +1,501 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "Types.h"
+#include "Money.h"
+#include "DiscountPolicy.h"
+
+// Savings are held exactly, in units of 1 / (units * RATE_SCALE) of a Money unit, so that the savings of
+// bundles, of items sold at a percentage off and of whole or partial pounds can all be added together
+typedef __int128 Savings;
+
+// Marks an amount that can not be made up, far enough below any real savings that adding to it never reaches them
+static const Savings UNREACHABLE = -(static_cast<Savings>( 1 ) << 120);
+
+namespace
+{
+    // Space reused by every line priced on a thread, so that pricing does not allocate once it has grown. The
+    // dynamic programming never covers more than MAX_STACKED_RANGE amounts, so it is kept for the life of the
+    // thread and never grows past that.
+    struct StackScratch
+    {
+        std::vector<Savings>  best;     // most that can be saved for each amount, using the discounts taken so far
+        std::vector<Savings>  next;     // the same once the next discount has been taken
+        std::vector<Savings>  tails;    // most that can be saved for each amount when it ends with a partial cycle
+        std::vector<Quantity> window;   // positions held by a sliding window, with their values decreasing
+    };
+
+    thread_local StackScratch scratch;
+
+    // One discount of a stack as it stands at the net price of the item
+    struct StackRule
+    {
+        bool cycle;             // buy x get y rather than a bundle
+        Quantity size;          // amount in each whole bundle or cycle
+        Quantity buy;           // amount of each cycle sold at the full price
+        Quantity get;           // amount of each cycle sold at the percentage off
+        Quantity limit;         // most of the amount that may be sold using the discount
+        Savings gain;           // saved by each whole bundle or cycle
+        Savings rate_gain;      // saved by each item sold at the percentage off
+    };
+
+    // Takes a discount that is used in whole steps of the given size, each saving the given amount, at most
+    // the given number of times. For each amount the result is the best of leaving it as it is and of taking
+    // some number of steps on top of the savings of a smaller amount. The steps taken for the amounts within
+    // one remainder of the step size are found with a sliding window over the number of steps.
+    void foldSteps( const Savings* from, Savings* into, Quantity amount, Quantity size, Savings gain, Quantity most )
+    {
+        Quantity* window = scratch.window.data();
+
+        for(Quantity start = 0; start < size && start <= amount; start++)
+        {
+            size_t head = 0;
+            size_t tail = 0;
+
+            for(Quantity step = 0; start + step * size <= amount; step++)
+            {
+                Savings value = from[start + step * size] - step * gain;
+
+                while(tail > head && from[start + window[tail - 1] * size] - window[tail - 1] * gain <= value)
+                {
+                    tail--;
+                }
+                window[tail++] = step;
+
+                if(step - window[head] > most)
+                {
+                    head++;
+                }
+
+                Quantity first = window[head];
+                into[start + step * size] = std::max( into[start + step * size],
+                                                      from[start + first * size] + (step - first) * gain );
+            }
+        }
+    }
+
+    // Finds the most that can be saved for each amount when it ends with a partial cycle of a buy x get y
+    // discount: buy items at the full price followed by between first and last items at the percentage off.
+    // The positions the partial cycle can start from form a window that moves along with the amount.
+    void foldTails( const Savings* from, Savings* tails, Quantity amount, Quantity buy, Quantity first, Quantity last,
+                    Savings rate_gain )
+    {
+        Quantity* window = scratch.window.data();
+        size_t head = 0;
+        size_t tail = 0;
+
+        for(Quantity total = 0; total <= amount; total++)
+        {
+            Quantity newest = total - buy - first;
+            if(newest < 0)
+            {
+                tails[total] = UNREACHABLE;
+                continue;
+            }
+
+            Savings value = from[newest] - newest * rate_gain;
+            while(tail > head && from[window[tail - 1]] - window[tail - 1] * rate_gain <= value)
+            {
+                tail--;
+            }
+            window[tail++] = newest;
+
+            if(window[head] < total - buy - last)
+            {
+                head++;
+            }
+
+            Quantity start = window[head];
+            tails[total] = from[start] + (total - buy - start) * rate_gain;
+        }
+    }
+
+    // Finds the most that can be saved on an amount by dynamic programming over every amount up to it,
+    // taking one discount at a time
+    Savings foldRules( const StackRule* rules, size_t count, Quantity amount )
+    {
+        size_t length = static_cast<size_t>( amount ) + 1;
+        if(scratch.best.size() < length)
+        {
+            scratch.best.resize( length );
+            scratch.next.resize( length );
+            scratch.tails.resize( length );
+            scratch.window.resize( length );
+        }
+
+        // nothing is saved by selling every item at the full price
+        std::fill( scratch.best.begin(), scratch.best.begin() + length, 0 );
+
+        for(size_t i = 0; i < count; i++)
+        {
+            const StackRule& rule = rules[i];
+            Quantity eligible = std::min( amount, rule.limit );
+            if(eligible < rule.size && !(rule.cycle && eligible > rule.buy))
+            {
+                continue;
+            }
+
+            const Savings* best = scratch.best.data();
+            Savings* next = scratch.next.data();
+            Savings* tails = scratch.tails.data();
+
+            std::copy( scratch.best.begin(), scratch.best.begin() + length, scratch.next.begin() );
+            foldSteps( best, next, amount, rule.size, rule.gain, eligible / rule.size );
+
+            if(rule.cycle)
+            {
+                // the portion sold using the discount can not go past its limit, so the number of complete
+                // cycles that may come before a partial cycle depends on how long the partial cycle is
+                Quantity cycles = eligible / rule.size;
+                Quantity left = eligible % rule.size - rule.buy;
+
+                Quantity short_last = std::min( rule.get - 1, left );
+                if(short_last >= 1)
+                {
+                    foldTails( best, tails, amount, rule.buy, 1, short_last, rule.rate_gain );
+                    foldSteps( tails, next, amount, rule.size, rule.gain, cycles );
+                }
+
+                Quantity long_first = std::max<Quantity>( 1, left + 1 );
+                if(cycles >= 1 && long_first <= rule.get - 1)
+                {
+                    foldTails( best, tails, amount, rule.buy, long_first, rule.get - 1, rule.rate_gain );
+                    foldSteps( tails, next, amount, rule.size, rule.gain, cycles - 1 );
+                }
+            }
+
+            scratch.best.swap( scratch.next );
+        }
+
+        return scratch.best[amount];
+    }
+
+    // Least common multiple of two sizes, or most when that is smaller
+    Quantity commonSpan( Quantity a, Quantity b, Quantity most )
+    {
+        Savings span = static_cast<Savings>( a / std::gcd( a, b ) ) * b;
+        return static_cast<Quantity>( std::min<Savings>( span, most ) );
+    }
+
+    // Range of amounts the dynamic programming is run over for discounts of the given sizes, see bestSavings,
+    // or most when that is smaller
+    Quantity stackRange( const Quantity* sizes, size_t count, Quantity most )
+    {
+        Savings range = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+            Quantity widest = 0;
+            for(size_t j = 0; j < count; j++)
+            {
+                if(j != i)
+                {
+                    widest = std::max( widest, commonSpan( sizes[i], sizes[j], most ) );
+                }
+            }
+            range += widest + 3 * static_cast<Savings>( sizes[i] );
+        }
+        return static_cast<Quantity>( std::min<Savings>( range, most ) );
+    }
+
+    // Finds the most that can be saved on an amount using discounts that each save something.
+    //
+    // Only a bounded range of amounts is ever worked through. Take the discounts in order of what they save
+    // per item. Whenever a later discount makes up a whole common multiple of its step and that of an earlier
+    // one, the earlier one could be used for that amount instead without saving less, unless it is nearly at
+    // its limit. So some cheapest combination has a first discount m that is not nearly at its limit, every
+    // earlier discount is within one such multiple of its limit, and every later one covers less than a
+    // multiple of its step and that of m. Only m can cover a large amount, and with every other discount
+    // bounded, all but a bounded part of the amount is whole steps of m. For each choice of m those whole steps,
+    // and the whole steps that take each earlier discount to near its limit, are counted in closed form and
+    // the rest is found by dynamic programming. The best of the choices, and of none of the discounts being
+    // short of its limit, is the most that can be saved.
+    Savings bestSavings( StackRule* rules, size_t count, Quantity amount )
+    {
+        if(count == 0)
+        {
+            return 0;
+        }
+
+        // insertion sort keeps equal rules in the order given without the buffer std::stable_sort would allocate
+        for(size_t i = 1; i < count; i++)
+        {
+            StackRule rule = rules[i];
+            size_t j = i;
+            for(; j > 0 && rule.gain * rules[j - 1].size > rules[j - 1].gain * rule.size; j--)
+            {
+                rules[j] = rules[j - 1];
+            }
+            rules[j] = rule;
+        }
+
+        Quantity sizes[2 * MAX_STACKED_DISCOUNTS];
+        for(size_t i = 0; i < count; i++)
+        {
+            sizes[i] = rules[i].size;
+        }
+
+        if(amount <= stackRange( sizes, count, amount + 1 ))
+        {
+            return foldRules( rules, count, amount );
+        }
+
+        // longest exchange, within the amount, of steps of a later discount for steps of each discount
+        Quantity reach[2 * MAX_STACKED_DISCOUNTS] = {};
+        for(size_t i = 0; i < count; i++)
+        {
+            for(size_t j = i + 1; j < count; j++)
+            {
+                Quantity span = commonSpan( sizes[i], sizes[j], amount + 1 );
+                if(span <= amount)
+                {
+                    reach[i] = std::max( reach[i], span );
+                }
+            }
+        }
+
+        Savings most = 0;
+        for(size_t m = 0; m <= count; m++)
+        {
+            StackRule residual[2 * MAX_STACKED_DISCOUNTS];
+            std::copy( rules, rules + count, residual );
+
+            Savings committed = 0;
+            Quantity left = amount;
+            Quantity spread = 0;
+
+            for(size_t h = 0; h < m; h++)
+            {
+                Quantity steps = std::max<Quantity>( 0, residual[h].limit / sizes[h] - reach[h] / sizes[h] - 1 );
+                committed += steps * residual[h].gain;
+                left -= steps * sizes[h];
+                residual[h].limit -= steps * sizes[h];
+                spread += reach[h] + 2 * sizes[h];
+            }
+
+            // the earlier discounts can not all be near their limits when those add up to more than the amount
+            if(left < 0)
+            {
+                continue;
+            }
+
+            if(m < count)
+            {
+                for(size_t j = m + 1; j < count; j++)
+                {
+                    Quantity span = commonSpan( sizes[m], sizes[j], amount );
+                    residual[j].limit = std::min( residual[j].limit, span + sizes[j] );
+                    spread += span + sizes[j];
+                }
+
+                // covers the partial cycle of m and whatever is left over at the full price
+                spread += 2 * sizes[m];
+                if(left > spread)
+                {
+                    Quantity steps = std::min( (left - spread) / sizes[m], residual[m].limit / sizes[m] );
+                    committed += steps * residual[m].gain;
+                    left -= steps * sizes[m];
+                    residual[m].limit -= steps * sizes[m];
+                }
+            }
+
+            // nothing more is saved once every discount can be used up to its limit
+            Quantity usable = 0;
+            for(size_t i = 0; i < count; i++)
+            {
+                usable = std::min( left, usable + residual[i].limit );
+            }
+
+            most = std::max( most, committed + foldRules( residual, count, usable ) );
+        }
+
+        return most;
+    }
+
+    // Gathers the sizes of the steps of every discount of a stack, returning how many there are
+    size_t getStackSizes( const StackedDiscount& stack, Quantity* sizes )
+    {
+        size_t count = 0;
+        for(uint32_t i = 0; i < std::min<uint32_t>( stack.bundle_count, MAX_STACKED_DISCOUNTS ); i++)
+        {
+            sizes[count++] = stack.bundles[i].size;
+        }
+        for(uint32_t i = 0; i < std::min<uint32_t>( stack.buy_x_get_y_count, MAX_STACKED_DISCOUNTS ); i++)
+        {
+            sizes[count++] = stack.buy_x_get_y[i].buy + stack.buy_x_get_y[i].get;
+        }
+        return count;
+    }
+
+    bool addToStack( StackedDiscount* pStack, const Discount& discount )
+    {
+        if(const BundleDiscount* bundle = std::get_if<BundleDiscount>( &discount ))
+        {
+            if(pStack->bundle_count == MAX_STACKED_DISCOUNTS)
+            {
+                return false;
+            }
+            pStack->bundles[pStack->bundle_count++] = *bundle;
+        }
+        else if(const BuyXGetYDiscount* buy = std::get_if<BuyXGetYDiscount>( &discount ))
+        {
+            if(pStack->buy_x_get_y_count == MAX_STACKED_DISCOUNTS)
+            {
+                return false;
+            }
+            pStack->buy_x_get_y[pStack->buy_x_get_y_count++] = *buy;
+        }
+        else if(const SharedStackedDiscount* shared = std::get_if<SharedStackedDiscount>( &discount ))
+        {
+            const StackedDiscount& stacked = *shared->stack;
+            for(uint32_t i = 0; i < stacked.bundle_count; i++)
+            {
+                if(!addToStack( pStack, stacked.bundles[i] ))
+                {
+                    return false;
+                }
+            }
+            for(uint32_t i = 0; i < stacked.buy_x_get_y_count; i++)
+            {
+                if(!addToStack( pStack, stacked.buy_x_get_y[i] ))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+}
+
+namespace
+{
+    // Gathers the discounts of a stack that save something on an amount, returning how many there are
+    size_t gatherRules( const StackedDiscount& stack, Quantity amount, Money net_price, Quantity units, StackRule* rules )
+    {
+        const Savings net = net_price;
+        size_t count = 0;
+
+        // discounts that would cost the customer more than the full price are never taken
+        for(uint32_t i = 0; i < std::min<uint32_t>( stack.bundle_count, MAX_STACKED_DISCOUNTS ); i++)
+        {
+            const BundleDiscount& bundle = stack.bundles[i];
+
+            Savings gain = (net * bundle.size - static_cast<Savings>( bundle.bundle_price ) * units) * RATE_SCALE;
+            if(bundle.size > 0 && bundle.size <= std::min( amount, bundle.limit ) && gain > 0)
+            {
+                rules[count++] = { false, bundle.size, 0, 0, std::min( amount, bundle.limit ), gain, 0 };
+            }
+        }
+
+        for(uint32_t i = 0; i < std::min<uint32_t>( stack.buy_x_get_y_count, MAX_STACKED_DISCOUNTS ); i++)
+        {
+            const BuyXGetYDiscount& discount = stack.buy_x_get_y[i];
+
+            Savings rate_gain = net * discount.rate;
+            if(discount.get > 0 && rate_gain > 0 && discount.buy < std::min( amount, discount.limit ))
+            {
+                rules[count++] = { true, discount.buy + discount.get, discount.buy, discount.get,
+                                   std::min( amount, discount.limit ), rate_gain * discount.get, rate_gain };
+            }
+        }
+
+        return count;
+    }
+
+    // Cost of an amount once the savings are taken off, rounded half away from zero
+    Money roundCost( Money net_price, Quantity amount, Savings saved, Quantity units )
+    {
+        Savings scale = static_cast<Savings>( units ) * RATE_SCALE;
+        Savings cost = static_cast<Savings>( net_price ) * amount * RATE_SCALE - saved;
+
+        // the cost is never negative, so adding half rounds half away from zero
+        return static_cast<Money>( (cost + scale / 2) / scale );
+    }
+
+}
+
+Money priceStacked( const StackedDiscount& stack, Quantity amount, Money net_price, Quantity units )
+{
+    if(amount <= 0)
+    {
+        return scaleMoney( net_price, amount, units );
+    }
+
+    StackRule rules[2 * MAX_STACKED_DISCOUNTS];
+    size_t count = gatherRules( stack, amount, net_price, units, rules );
+
+    Savings saved = bestSavings( rules, count, amount );
+    return roundCost( net_price, amount, saved, units );
+}
+
+void tabulateStacked( const StackedDiscount& stack, Quantity most, Money net_price, Quantity units, Money* prices )
+{
+    StackRule rules[2 * MAX_STACKED_DISCOUNTS];
+    size_t count = gatherRules( stack, most, net_price, units, rules );
+
+    // The dynamic programming finds the most that can be saved on every amount up to the one it is run for.
+    // The limits of the discounts only hold back amounts larger than themselves, so the savings found for
+    // each smaller amount are those it would be priced with on its own.
+    foldRules( rules, count, most );
+    for(Quantity amount = 0; amount <= most; amount++)
+    {
+        prices[amount] = roundCost( net_price, amount, scratch.best[amount], units );
+    }
+}
+
+bool StackedDiscount::isValid() const
+{
+    if(bundle_count > MAX_STACKED_DISCOUNTS || buy_x_get_y_count > MAX_STACKED_DISCOUNTS)
+    {
+        return false;
+    }
+    for(uint32_t i = 0; i < bundle_count; i++)
+    {
+        if(!bundles[i].isValid())
+        {
+            return false;
+        }
+    }
+    for(uint32_t i = 0; i < buy_x_get_y_count; i++)
+    {
+        if(!buy_x_get_y[i].isValid())
+        {
+            return false;
+        }
+    }
+
+    Quantity sizes[2 * MAX_STACKED_DISCOUNTS];
+    size_t count = getStackSizes( *this, sizes );
+    return stackRange( sizes, count, MAX_STACKED_RANGE + 1 ) <= MAX_STACKED_RANGE;
+}
+
+bool stackDiscounts( const Discount& existing, Discount* pDiscount )
+{
+    // a discount that takes nothing off adds nothing, and one added to no discount is offered on its own
+    if(getDiscountType( *pDiscount ) == NO_DISCOUNT)
+    {
+        *pDiscount = existing;
+        return true;
+    }
+    if(getDiscountType( existing ) == NO_DISCOUNT)
+    {
+        return true;
+    }
+
+    StackedDiscount stack = {};
+    if(!addToStack( &stack, existing ) || !addToStack( &stack, *pDiscount ))
+    {
+        return false;
+    }
+
+    // the range priced by dynamic programming depends only on the sizes, so it is bounded before it is offered
+    if(!stack.isValid())
+    {
+        return false;
+    }
+
+    *pDiscount = SharedStackedDiscount{ std::make_shared<const StackedDiscount>( stack ) };
+    return true;
+}
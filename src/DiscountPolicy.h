@@ -0,0 +1,223 @@
+#ifndef DISCOUNT_POLICY_H
+#define DISCOUNT_POLICY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <variant>
+
+#include "Types.h"
+#include "Money.h"
+
+/// \brief Limit given to a discount that may be applied to any amount
+const Quantity NO_LIMIT = INT64_MAX;
+
+/// \brief Most discounts of each type that can be offered on an item at the same time
+const size_t MAX_STACKED_DISCOUNTS = 4;
+
+/// \brief Widest range of amounts a stack of discounts may need to be priced over, see StackedDiscount
+///
+/// Each thread that prices stacks keeps 56 bytes for every amount of the widest range it has priced, so the
+/// space is at most about 3.5 MB and is never given back or grown again while scanning.
+const Quantity MAX_STACKED_RANGE = 1 << 16;
+
+struct StackedDiscount;
+
+/// \brief Calculates the cost of an amount of an item offering several discounts, see StackedDiscount
+///
+/// \param stack The discounts offered on the item
+/// \param amount The number of items, or thousandths of a pound, being purchased
+/// \param net_price Price of one item or pound after the markdown has been taken off
+/// \param units Amount that makes up one item or pound, as given by QuantityTraits
+Money priceStacked( const StackedDiscount& stack, Quantity amount, Money net_price, Quantity units );
+
+/// \brief Calculates the cost of every amount of an item offering several discounts, up to a limit
+///
+/// Gives the same costs as priceStacked, but works through the discounts once for every amount together.
+///
+/// \param stack The discounts offered on the item
+/// \param most Largest amount priced, the number of items or thousandths of a pound
+/// \param net_price Price of one item or pound after the markdown has been taken off
+/// \param units Amount that makes up one item or pound, as given by QuantityTraits
+/// \param prices Location that the cost of each amount is stored, must hold most + 1 entries
+void tabulateStacked( const StackedDiscount& stack, Quantity most, Money net_price, Quantity units, Money* prices );
+
+/// \struct NoDiscount
+/// \brief Every item, or pound, is sold at the marked down price
+struct NoDiscount
+{
+    /// \brief Calculates the cost of an amount of an item sold by the given type of amount
+    ///
+    /// \param amount The number of items, or thousandths of a pound, being purchased
+    /// \param net_price Price of one item or pound after the markdown has been taken off
+    template <class T>
+    Money price( Quantity amount, Money net_price ) const
+    {
+        return scaleMoney( net_price, amount, QuantityTraits<T>::UNITS );
+    }
+};
+
+/// \struct BundleDiscount
+/// \brief Complete bundles of the item are sold for a single price, up to a limit
+///
+/// Corresponds to X_FOR_FLAT. A bundle is never empty: a discount configured with a bundle of nothing takes
+/// nothing off, so it is held as NoDiscount instead.
+struct BundleDiscount
+{
+    Quantity size;          ///< Amount sold together for the bundle price, greater than zero
+    Quantity limit;         ///< Most that can be bought using the discount, or NO_LIMIT
+    Money bundle_price;     ///< Price of one whole bundle
+
+    /// \brief Checks that the bundle is not empty, as it is for every bundle the catalog makes
+    bool isValid() const
+    {
+        return size > 0;
+    }
+
+    /// \brief Calculates the cost of an amount of an item sold by the given type of amount
+    ///
+    /// Every complete bundle within the limit is sold at the bundle price exactly, and the rest is sold
+    /// at the net price rounded half away from zero.
+    ///
+    /// \param amount The number of items, or thousandths of a pound, being purchased
+    /// \param net_price Price of one item or pound after the markdown has been taken off
+    template <class T>
+    Money price( Quantity amount, Money net_price ) const
+    {
+        Quantity bundles = std::min( amount, limit ) / size;
+        return bundles * bundle_price + scaleMoney( net_price, amount - bundles * size, QuantityTraits<T>::UNITS );
+    }
+};
+
+/// \struct BuyXGetYDiscount
+/// \brief Items are sold at a percentage off after others are bought at full price, up to a limit
+///
+/// Corresponds to BUY_X_GET_Y_FOR_Z_LIMIT_W. As with BundleDiscount, a cycle of nothing is held as NoDiscount.
+struct BuyXGetYDiscount
+{
+    Quantity buy;           ///< Amount bought at full price to earn the discount
+    Quantity get;           ///< Amount then sold at the discounted rate, buy + get is greater than zero
+    Quantity limit;         ///< Most that can be bought using the discount, or NO_LIMIT
+    int64_t rate;           ///< Portion taken off the price, out of RATE_SCALE
+
+    /// \brief Checks that the cycle is not empty and its size can be held, as it is for every discount the catalog makes
+    bool isValid() const
+    {
+        return buy >= 0 && get >= 0 && buy <= NO_LIMIT - get && buy + get > 0;
+    }
+
+    /// \brief Calculates the cost of an amount of an item sold by the given type of amount
+    ///
+    /// Each complete cycle of buy full price items earns get discounted items, and a trailing partial cycle
+    /// earns whatever is left once its full price items are covered. The discounted items and the rest are
+    /// each rounded half away from zero.
+    ///
+    /// \param amount The number of items, or thousandths of a pound, being purchased
+    /// \param net_price Price of one item or pound after the markdown has been taken off
+    template <class T>
+    Money price( Quantity amount, Money net_price ) const
+    {
+        const Quantity units = QuantityTraits<T>::UNITS;
+
+        Quantity eligible = std::min( amount, limit );
+        Quantity cycle = buy + get;
+        Quantity cycles = eligible / cycle;
+        Quantity discounted = cycles * get + std::max<Quantity>( eligible - cycles * cycle - buy, 0 );
+
+        return scaleMoney( net_price, discounted * (RATE_SCALE - rate), units * RATE_SCALE ) +
+               scaleMoney( net_price, amount - discounted, units );
+    }
+};
+
+/// \struct StackedDiscount
+/// \brief Several discounts are offered on the item at once, and the customer is given the cheapest combination
+///
+/// Corresponds to STACKED_DISCOUNTS. Each item, or pound, is sold under at most one of the discounts, and each
+/// discount is used for at most one portion of the amount, so each keeps to its own limit. A discount may also
+/// be left unused when it would cost the customer more than the full price.
+///
+/// The cheapest combination is found by dynamic programming over the amount, taking one discount at a time.
+/// For every amount up to the one being purchased the most that can be saved using the discounts taken so far
+/// is kept, and the next discount is folded in using sliding window maximums. Costs are added up exactly and
+/// the line is rounded half away from zero once.
+///
+/// The dynamic programming only ever covers a range set by the common multiples of the bundle and cycle sizes,
+/// whatever the amount. Beyond it the best combination is made up of whole bundles or cycles of the discounts
+/// that save the most per item, which are counted in closed form. The range is checked when discounts are
+/// stacked, and a stack whose sizes have so little in common that it would pass MAX_STACKED_RANGE is refused.
+struct StackedDiscount
+{
+    BundleDiscount   bundles[MAX_STACKED_DISCOUNTS];     ///< Bundle discounts offered, in the order they were added
+    BuyXGetYDiscount buy_x_get_y[MAX_STACKED_DISCOUNTS]; ///< Buy x get y discounts offered, in the order they were added
+    uint32_t bundle_count;                               ///< Entries of bundles in use
+    uint32_t buy_x_get_y_count;                          ///< Entries of buy_x_get_y in use
+
+    /// \brief Checks that the stack is one stackDiscounts could have made, so that its range is within
+    ///        MAX_STACKED_RANGE
+    bool isValid() const;
+
+    /// \brief Calculates the cost of an amount of an item sold by the given type of amount
+    ///
+    /// \param amount The number of items, or thousandths of a pound, being purchased
+    /// \param net_price Price of one item or pound after the markdown has been taken off
+    template <class T>
+    Money price( Quantity amount, Money net_price ) const
+    {
+        return priceStacked( *this, amount, net_price, QuantityTraits<T>::UNITS );
+    }
+};
+
+/// \struct SharedStackedDiscount
+/// \brief Holds a StackedDiscount out of line, so that offering several discounts does not grow every Discount
+///
+/// The stack is never changed once made, so copies of an item share it.
+struct SharedStackedDiscount
+{
+    std::shared_ptr<const StackedDiscount> stack;   ///< The discounts offered, never null
+
+    /// \brief Calculates the cost of an amount of an item sold by the given type of amount
+    ///
+    /// \param amount The number of items, or thousandths of a pound, being purchased
+    /// \param net_price Price of one item or pound after the markdown has been taken off
+    template <class T>
+    Money price( Quantity amount, Money net_price ) const
+    {
+        return stack->price<T>( amount, net_price );
+    }
+};
+
+/// \typedef Discount
+/// \brief The discount configured for an item, holding only the fields of that discount
+///
+/// The alternatives are in the order of DiscountType_t, so the index of the alternative held is the type
+/// of the discount.
+typedef std::variant<NoDiscount, BundleDiscount, BuyXGetYDiscount, SharedStackedDiscount> Discount;
+
+/// \brief Offers the discounts already configured for an item alongside a discount being added
+///
+/// \param existing The discount configured for the item before the new one
+/// \param pDiscount The discount being added, replaced by the discounts offered together
+/// \return False, leaving the discount unchanged, when the item already offers the most discounts of that type
+///         or the discounts together would need a range wider than MAX_STACKED_RANGE
+bool stackDiscounts( const Discount& existing, Discount* pDiscount );
+
+/// \brief Provides the type of a discount
+inline DiscountType_t getDiscountType( const Discount& discount )
+{
+    return static_cast<DiscountType_t>( discount.index() );
+}
+
+/// \brief Calculates the cost of an amount of an item using the evaluator of its discount
+///
+/// \param discount The discount configured for the item
+/// \param amount The number of items, or thousandths of a pound, being purchased
+/// \param net_price Price of one item or pound after the markdown has been taken off
+template <class T>
+Money priceWithDiscount( const Discount& discount, Quantity amount, Money net_price )
+{
+    return std::visit( [amount, net_price]( const auto& policy ) { return policy.template price<T>( amount, net_price ); },
+                       discount );
+}
+
+#endif
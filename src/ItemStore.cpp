@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Types.h"
+#include "Money.h"
+#include "ItemStore.h"
+#include "PricingKernel.h"
+
+// By default, a template class definition and the implementation must be
+// in the same file. By adding these statements, the compiler is told to
+// always create these variants of the ItemStore class so that the symbols
+// are available during linking.
+template class ItemStore<int>;
+template class ItemStore<double>;
+
+// Changes one element of an array, leaving the array shared with copies of the store when it already holds the value
+template <class X>
+static void assignElement( MappedArray<X>& column, size_t index, const X& value )
+{
+    if(std::as_const( column )[index] != value)
+    {
+        column[index] = value;
+    }
+}
+
+template <class T>
+ItemStore<T>::ItemStore()
+{
+    table_amount = 0;
+    table_limit = 0;
+}
+
+template <class T>
+ItemStore<T>::~ItemStore()
+{
+
+}
+
+template <class T>
+uint32_t ItemStore<T>::append( const CatalogItem<T>& item )
+{
+    uint32_t index = static_cast<uint32_t>( net_price.size() );
+
+    net_price.push_back( 0 );
+    discount_type.push_back( 0 );
+    price.push_back( 0 );
+    markdown.push_back( 0 );
+    discount_index.push_back( 0 );
+    flags.push_back( 0 );
+
+    set( index, item );
+
+    return index;
+}
+
+template <class T>
+void ItemStore<T>::reserve( size_t count )
+{
+    if(count <= net_price.capacity())
+    {
+        return;
+    }
+
+    count = std::max( count, net_price.capacity() * 2 );
+
+    net_price.reserve( count );
+    discount_type.reserve( count );
+    price.reserve( count );
+    markdown.reserve( count );
+    discount_index.reserve( count );
+    flags.reserve( count );
+}
+
+template <class T>
+CatalogItem<T> ItemStore<T>::get( uint32_t index ) const
+{
+    CatalogItem<T> item;
+
+    item.price = price[index];
+    item.markdown = markdown[index];
+    item.is_price_set = (flags[index] & ITEM_PRICE_SET) != 0;
+
+    switch(discount_type[index])
+    {
+        case X_FOR_FLAT:
+            item.discount = bundle_discounts[discount_index[index]];
+            break;
+        case BUY_X_GET_Y_FOR_Z_LIMIT_W:
+            item.discount = buy_x_get_y_discounts[discount_index[index]];
+            break;
+        case STACKED_DISCOUNTS:
+            // the pool entry is copied out once, and the copy is shared by every copy of the item
+            item.discount = SharedStackedDiscount{
+                std::make_shared<const StackedDiscount>( stacked_discounts[discount_index[index]] ) };
+            break;
+        default:
+            item.discount = NoDiscount();
+            break;
+    }
+
+    return item;
+}
+
+template <class T>
+void ItemStore<T>::set( uint32_t index, const CatalogItem<T>& item )
+{
+    const ItemStore<T>& current = *this;
+    DiscountType_t previous = static_cast<DiscountType_t>( current.discount_type[index] );
+    DiscountType_t type = getDiscountType( item.discount );
+    bool repriced = previous != type || current.net_price[index] != item.price - item.markdown;
+
+    assignElement( net_price, index, item.price - item.markdown );
+    assignElement( discount_type, index, static_cast<uint8_t>( type ) );
+
+    assignElement( price, index, item.price );
+    assignElement( markdown, index, item.markdown );
+    assignElement( flags, index, static_cast<uint8_t>( item.is_price_set ? ITEM_PRICE_SET : 0 ) );
+
+    // an entry left behind in another pool is given back for the next discount of that type
+    if(previous != type && previous != NO_DISCOUNT)
+    {
+        free_discounts[previous].push_back( std::as_const( discount_index )[index] );
+    }
+
+    if(type == X_FOR_FLAT)
+    {
+        repriced |= placeDiscount( bundle_discounts, type, index, previous == type, std::get<BundleDiscount>( item.discount ) );
+    }
+    else if(type == BUY_X_GET_Y_FOR_Z_LIMIT_W)
+    {
+        repriced |= placeDiscount( buy_x_get_y_discounts, type, index, previous == type,
+                                   std::get<BuyXGetYDiscount>( item.discount ) );
+    }
+    else if(type == STACKED_DISCOUNTS)
+    {
+        repriced |= placeDiscount( stacked_discounts, type, index, previous == type,
+                                   *std::get<SharedStackedDiscount>( item.discount ).stack );
+    }
+    else
+    {
+        assignElement( discount_index, index, 0u );
+    }
+
+    // the table holds prices after the markdown, so it is built again whenever they change
+    bool tabulated = index < current.table_slot.size() && current.table_slot[index] != 0;
+    if(type == NO_DISCOUNT)
+    {
+        dropPriceTable( index );
+    }
+    else if(repriced || !tabulated)
+    {
+        buildPriceTable( index );
+    }
+}
+
+template <class T>
+template <class P>
+bool ItemStore<T>::placeDiscount( MappedArray<P>& pool, DiscountType_t type, uint32_t index, bool reuse, const P& policy )
+{
+    // discounts are made up of whole numbers alone, so comparing their bytes compares their values
+    static_assert( std::has_unique_object_representations_v<P>, "discounts are compared by their bytes" );
+
+    if(reuse)
+    {
+        uint32_t position = std::as_const( discount_index )[index];
+        if(std::memcmp( &std::as_const( pool )[position], &policy, sizeof(P) ) == 0)
+        {
+            return false;
+        }
+
+        pool[position] = policy;
+        return true;
+    }
+
+    std::vector<uint32_t>& free = free_discounts[type];
+    if(!free.empty())
+    {
+        assignElement( discount_index, index, free.back() );
+        pool[free.back()] = policy;
+        free.pop_back();
+        return true;
+    }
+
+    assignElement( discount_index, index, static_cast<uint32_t>( pool.size() ) );
+    pool.push_back( policy );
+    return true;
+}
+
+template <class T>
+size_t ItemStore<T>::size() const
+{
+    return net_price.size();
+}
+
+template <class T>
+bool ItemStore<T>::isPriceSet( uint32_t index ) const
+{
+    return (flags[index] & ITEM_PRICE_SET) != 0;
+}
+
+template <class T>
+ReturnCode_t ItemStore<T>::computePreTax( uint32_t index, Quantity amount, Money* pTaxAmount ) const
+{
+    if(discount_type[index] == NO_DISCOUNT)
+    {
+        *pTaxAmount = NoDiscount().price<T>( amount, net_price[index] );
+        return OK;
+    }
+
+    // common amounts of items with a table are looked up rather than evaluated
+    if(index < table_slot.size() && table_slot[index] != 0 &&
+       static_cast<uint64_t>( amount ) <= static_cast<uint64_t>( table_amount ))
+    {
+        *pTaxAmount = price_tables[(table_slot[index] - 1) * static_cast<size_t>( table_amount + 1 ) + amount];
+        return OK;
+    }
+
+    *pTaxAmount = priceDiscount( index, amount );
+
+    return OK;
+}
+
+template <class T>
+Money ItemStore<T>::priceDiscount( uint32_t index, Quantity amount ) const
+{
+    // each type of discount is priced by its own evaluator, reading only the fields it needs
+    switch(discount_type[index])
+    {
+        case X_FOR_FLAT:
+            return bundle_discounts[discount_index[index]].price<T>( amount, net_price[index] );
+        case BUY_X_GET_Y_FOR_Z_LIMIT_W:
+            return buy_x_get_y_discounts[discount_index[index]].price<T>( amount, net_price[index] );
+        case STACKED_DISCOUNTS:
+            return stacked_discounts[discount_index[index]].price<T>( amount, net_price[index] );
+        default:
+            return NoDiscount().price<T>( amount, net_price[index] );
+    }
+}
+
+template <class T>
+void ItemStore<T>::setPriceTables( Quantity table_amount, size_t table_count )
+{
+    this->table_amount = (table_count > 0) ? std::clamp<Quantity>( table_amount, 0, MAX_PRICE_TABLE_AMOUNT ) : 0;
+    table_limit = (this->table_amount > 0) ? table_count : 0;
+
+    clearPriceTables();
+
+    for(uint32_t index = 0; index < size() && getPriceTableCount() < table_limit; index++)
+    {
+        if(discount_type[index] != NO_DISCOUNT)
+        {
+            buildPriceTable( index );
+        }
+    }
+}
+
+template <class T>
+size_t ItemStore<T>::getPriceTableCount() const
+{
+    if(table_amount == 0)
+    {
+        return 0;
+    }
+
+    return price_tables.size() / static_cast<size_t>( table_amount + 1 ) - free_slots.size();
+}
+
+template <class T>
+size_t ItemStore<T>::getPoolSize( DiscountType_t type ) const
+{
+    switch(type)
+    {
+        case X_FOR_FLAT:
+            return bundle_discounts.size();
+        case BUY_X_GET_Y_FOR_Z_LIMIT_W:
+            return buy_x_get_y_discounts.size();
+        case STACKED_DISCOUNTS:
+            return stacked_discounts.size();
+        default:
+            return 0;
+    }
+}
+
+template <class T>
+void ItemStore<T>::buildPriceTable( uint32_t index )
+{
+    if(table_amount == 0)
+    {
+        return;
+    }
+
+    size_t stride = static_cast<size_t>( table_amount + 1 );
+
+    if(index >= table_slot.size() || std::as_const( table_slot )[index] == 0)
+    {
+        uint32_t slot = 0;
+
+        if(!free_slots.empty())
+        {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        else if(getPriceTableCount() < table_limit)
+        {
+            slot = static_cast<uint32_t>( price_tables.size() / stride );
+            price_tables.resize( price_tables.size() + stride );
+        }
+        else
+        {
+            // every table is taken, the item is priced by its evaluator
+            return;
+        }
+
+        if(index >= table_slot.size())
+        {
+            table_slot.resize( index + 1, 0 );
+        }
+        table_slot[index] = slot + 1;
+    }
+
+    const ItemStore<T>& current = *this;
+    Money* table = &price_tables[(current.table_slot[index] - 1) * stride];
+    if(current.discount_type[index] == STACKED_DISCOUNTS)
+    {
+        // pricing each amount of a stack on its own would work through the discounts once for every amount
+        tabulateStacked( current.stacked_discounts[current.discount_index[index]], table_amount, current.net_price[index],
+                         QuantityTraits<T>::UNITS, table );
+        return;
+    }
+
+    for(Quantity amount = 0; amount <= table_amount; amount++)
+    {
+        table[amount] = priceDiscount( index, amount );
+    }
+}
+
+template <class T>
+void ItemStore<T>::dropPriceTable( uint32_t index )
+{
+    if(index < table_slot.size() && std::as_const( table_slot )[index] != 0)
+    {
+        free_slots.push_back( table_slot[index] - 1 );
+        table_slot[index] = 0;
+    }
+}
+
+template <class T>
+void ItemStore<T>::clearPriceTables()
+{
+    table_slot.clear();
+    price_tables.clear();
+    free_slots.clear();
+}
+
+template <class T>
+Money ItemStore<T>::computeTotals( const Quantity* amounts, Money* totals, size_t count ) const
+{
+    return computeTotals( amounts, totals, count, getPricingKernel() );
+}
+
+template <class T>
+Money ItemStore<T>::computeTotals( const Quantity* amounts, Money* totals, size_t count, PricingKernel_t kernel ) const
+{
+    Money total = 0;
+
+    if(kernel != SCALAR_KERNEL && isPricingKernelSupported( kernel ))
+    {
+        PricingColumns columns = { net_price.data(), discount_type.data(), discount_index.data(), bundle_discounts.data(),
+                                   buy_x_get_y_discounts.data(), QuantityTraits<T>::UNITS };
+        size_t unpriced = 0;
+
+        total = priceLines( kernel, columns, amounts, totals, count, &unpriced );
+
+        // lines the vector kernel could not price exactly are priced one at a time
+        for(size_t i = 0; unpriced > 0 && i < count; i++)
+        {
+            if(totals[i] == UNPRICED_LINE)
+            {
+                computePreTax( static_cast<uint32_t>( i ), amounts[i], &totals[i] );
+                total += totals[i];
+                unpriced--;
+            }
+        }
+
+        return total;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        // most items carry no discount and are priced from the hot arrays alone
+        if(discount_type[i] == NO_DISCOUNT)
+        {
+            totals[i] = scaleMoney( net_price[i], amounts[i], QuantityTraits<T>::UNITS );
+        }
+        else
+        {
+            computePreTax( static_cast<uint32_t>( i ), amounts[i], &totals[i] );
+        }
+
+        total += totals[i];
+    }
+
+    return total;
+}
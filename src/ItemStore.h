@@ -0,0 +1,185 @@
+#ifndef ITEM_STORE_H
+#define ITEM_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Types.h"
+#include "Money.h"
+#include "CatalogItem.h"
+#include "DiscountPolicy.h"
+#include "MappedArray.h"
+#include "PricingKernel.h"
+
+/// \brief Largest amount a price table may hold, see ItemStore::setPriceTables
+const Quantity MAX_PRICE_TABLE_AMOUNT = 4096;
+
+/// \class ItemStore
+/// \brief Keeps the configuration of every item of one type in parallel arrays
+///
+/// The ItemStore class holds the same fields as CatalogItem, but each field lives in its own contiguous
+/// array indexed by the position of the item. The fields read for every item when pricing a cart, the
+/// net price and the type of discount, are kept apart from the discount configuration that only a few
+/// items use. Pricing a run of items therefore streams through a couple of dense arrays instead of
+/// jumping between separately allocated objects.
+///
+/// Discounts are kept in a pool for each type of discount, holding only the fields of that discount, and
+/// each item records the position of its discount within the pool for its type. An item without a discount
+/// costs four bytes of discount storage rather than the fields of every discount. An item whose discount
+/// changes to another type gives its old entry back to the other pool, which reuses it for the next item to
+/// be given a discount of that type, so the pools never hold more entries than items have held at once.
+///
+/// Discounted items can also be given a table holding the cost of every amount up to a limit, see setPriceTables.
+/// Pricing an amount within the table is then a single load instead of evaluating the discount.
+///
+/// Configuration changes are rare compared to pricing, so they are made by copying an item out as a
+/// CatalogItem, changing it, and copying it back. This keeps all validation within CatalogItem.
+///
+/// The arrays can also be read in place from a mapped CatalogImage. The first change made to a store
+/// that is mapped copies its arrays into memory owned by the store. Copies of a store share their arrays
+/// in the same way, and a change only writes the arrays whose values differ, so the other arrays stay shared.
+template <class T>
+class ItemStore
+{
+    public:
+
+        ItemStore();
+        ~ItemStore();
+
+        /// \brief Adds an item to the end of the store
+        ///
+        /// \param item Configuration of the new item
+        /// \return Position of the item within the store
+        uint32_t append( const CatalogItem<T>& item );
+
+        /// \brief Allocates room for a number of items so that appending them does not reallocate
+        ///
+        /// The room at least doubles whenever it has to grow, so reserving a little more before each of many
+        /// appends still copies every item a constant number of times.
+        ///
+        /// \param count Total number of items the store is expected to hold
+        void reserve( size_t count );
+
+        /// \brief Copies the configuration of an item out of the store
+        ///
+        /// \param index Position of the item within the store
+        CatalogItem<T> get( uint32_t index ) const;
+
+        /// \brief Replaces the configuration of an item within the store
+        ///
+        /// \param index Position of the item within the store
+        /// \param item New configuration for the item
+        void set( uint32_t index, const CatalogItem<T>& item );
+
+        /// \brief Provides the number of items within the store
+        size_t size() const;
+
+        /// \brief Indicates whether a valid price has been configured for the item
+        ///
+        /// \param index Position of the item within the store
+        bool isPriceSet( uint32_t index ) const;
+
+        /// \brief Calculates the pre-tax cost of the given amount of a single item
+        ///
+        /// \param index Position of the item within the store
+        /// \param amount The number of items, or thousandths of a pound, being purchased
+        /// \param pTaxAmount Location that the computed pre-tax figure should be stored
+        ReturnCode_t computePreTax( uint32_t index, Quantity amount, Money* pTaxAmount ) const;
+
+        /// \brief Keeps a table of the cost of every amount up to a limit for discounted items
+        ///
+        /// Items that already have a discount are given tables by position, and later items in the order their
+        /// discounts are set, until the given number of items have one. Each table is built again whenever the
+        /// net price or discount of its item changes, which costs one pass over the amounts whatever the type of
+        /// discount. An item whose discount is removed gives its table up to the next item to be given a
+        /// discount. A limit or count of zero turns the tables off.
+        ///
+        /// Tables are only held in memory. A store attached to a CatalogImage starts without any.
+        ///
+        /// \param table_amount Largest amount, in items or thousandths of a pound, held by each table, no more
+        ///        than MAX_PRICE_TABLE_AMOUNT
+        /// \param table_count Most items that are given a table
+        void setPriceTables( Quantity table_amount, size_t table_count );
+
+        /// \brief Provides the number of items that currently have a table, see setPriceTables
+        size_t getPriceTableCount() const;
+
+        /// \brief Provides the number of entries held by the pool for a type of discount, including any waiting to be reused
+        ///
+        /// \param type The type of discount, zero for NO_DISCOUNT which has no pool
+        size_t getPoolSize( DiscountType_t type ) const;
+
+        /// \brief Prices a run of items in a single pass
+        ///
+        /// The amounts are given by position, so amounts[i] is the amount of the item at position i.
+        /// The fastest kernel supported by the processor is used, as given by getPricingKernel.
+        ///
+        /// \param amounts Amount of each item, starting from the first item in the store
+        /// \param totals Location that the pre-tax cost of each item is stored
+        /// \param count Number of items to price, must not be more than size()
+        /// \return Sum of the pre-tax cost of every item
+        Money computeTotals( const Quantity* amounts, Money* totals, size_t count ) const;
+
+        /// \brief Prices a run of items in a single pass using the given kernel
+        ///
+        /// Every kernel produces exactly the same costs. The vector kernels price several lines at once and
+        /// hand any line they can not price exactly back to the scalar kernel. A kernel that is not supported
+        /// by the processor is replaced by the scalar kernel.
+        ///
+        /// \param amounts Amount of each item, starting from the first item in the store
+        /// \param totals Location that the pre-tax cost of each item is stored
+        /// \param count Number of items to price, must not be more than size()
+        /// \param kernel Implementation used to price the lines
+        /// \return Sum of the pre-tax cost of every item
+        Money computeTotals( const Quantity* amounts, Money* totals, size_t count, PricingKernel_t kernel ) const;
+
+    private:
+
+        friend class CatalogImage;
+
+        /// \brief Stores a discount in its pool, reusing the entry of the item when it already has one of that type,
+        ///        or else an entry given back by another item
+        ///
+        /// \return Whether the discount of the item changed
+        template <class P>
+        bool placeDiscount( MappedArray<P>& pool, DiscountType_t type, uint32_t index, bool reuse, const P& policy );
+
+        /// \brief Calculates the cost of an amount of an item by evaluating its discount
+        Money priceDiscount( uint32_t index, Quantity amount ) const;
+
+        /// \brief Fills in the table of a discounted item, giving it one when any are left
+        void buildPriceTable( uint32_t index );
+
+        /// \brief Releases the table of an item, if it has one, for use by another item
+        void dropPriceTable( uint32_t index );
+
+        /// \brief Releases every table while keeping the limits given to setPriceTables
+        void clearPriceTables();
+
+        // fields read for every item that is priced
+        MappedArray<Money>   net_price;      // price after the markdown has been taken off
+        MappedArray<uint8_t> discount_type;  // DiscountType_t of the item
+
+        // fields only read when configuring an item or pricing a discounted item
+        MappedArray<Money>    price;
+        MappedArray<Money>    markdown;
+        MappedArray<uint32_t> discount_index; // position of the discount within the pool for its type
+        MappedArray<uint8_t>  flags;          // ITEM_PRICE_SET bit
+
+        // discounts of every item that has one, by type
+        MappedArray<BundleDiscount>   bundle_discounts;
+        MappedArray<BuyXGetYDiscount> buy_x_get_y_discounts;
+        MappedArray<StackedDiscount>  stacked_discounts;
+        std::vector<uint32_t> free_discounts[STACKED_DISCOUNTS + 1]; // entries no item uses, by DiscountType_t of the pool
+
+        // prices of discounted items by amount, never part of an image
+        Quantity table_amount;              // largest amount held by each table, zero when tables are off
+        size_t   table_limit;               // most tables that are kept
+        MappedArray<uint32_t> table_slot;   // one more than the slot of the table of each item, zero for none
+        MappedArray<Money>    price_tables; // table_amount + 1 prices for each slot
+        std::vector<uint32_t> free_slots;   // slots given up by items that no longer have a discount
+
+};
+
+#endif
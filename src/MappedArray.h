@@ -0,0 +1,132 @@
+#ifndef MAPPED_ARRAY_H
+#define MAPPED_ARRAY_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// \class MappedArray
+/// \brief Array that either owns its elements or reads them in place from a mapped catalog image
+///
+/// The MappedArray class lets the storage of the catalog be used directly from a file mapped into memory
+/// by CatalogImage. While mapped, reading an element costs the same as reading from a vector and nothing is
+/// copied. The first change made to a mapped array copies its elements into memory it owns, after which
+/// it behaves as a std::vector. The mapping must outlive the array for as long as the array refers to it.
+///
+/// Owned elements are shared between copies of the array in the same way, so copying a catalog only copies
+/// the arrays that are then changed. An array that still shares its elements copies them on its first
+/// change. Copies may be read from different threads while one of them is being changed.
+template <class X>
+class MappedArray
+{
+    public:
+
+        MappedArray() : mapped( 0 ), mapped_count( 0 )
+        {
+
+        }
+
+        /// \brief Refers to elements held in mapped memory in place of the owned elements
+        ///
+        /// \param elements First element within the mapping
+        /// \param count Number of elements within the mapping
+        void attach( const X* elements, size_t count )
+        {
+            owned.reset();
+            mapped = elements;
+            mapped_count = count;
+        }
+
+        /// \brief Indicates whether the elements are being read from mapped memory
+        bool isMapped() const
+        {
+            return mapped != 0;
+        }
+
+        /// \brief Copies mapped or shared elements into memory only this array owns so that they can be changed
+        ///
+        /// \return The owned elements
+        std::vector<X>& detach()
+        {
+            if(mapped != 0)
+            {
+                owned = std::make_shared<std::vector<X>>( mapped, mapped + mapped_count );
+                mapped = 0;
+                mapped_count = 0;
+            }
+            else if(!owned)
+            {
+                owned = std::make_shared<std::vector<X>>();
+            }
+            else if(owned.use_count() > 1)
+            {
+                owned = std::make_shared<std::vector<X>>( *owned );
+            }
+            else
+            {
+                // the last copy to let go of the elements may have done so on another thread, and its reads
+                // must be complete before they are changed
+                std::atomic_thread_fence( std::memory_order_acquire );
+            }
+
+            return *owned;
+        }
+
+        /// \brief Lets go of every element
+        void clear()
+        {
+            owned.reset();
+            mapped = 0;
+            mapped_count = 0;
+        }
+
+        const X& operator[]( size_t index ) const
+        {
+            return (mapped != 0) ? mapped[index] : (*owned)[index];
+        }
+
+        X& operator[]( size_t index )
+        {
+            return detach()[index];
+        }
+
+        const X* data() const
+        {
+            return (mapped != 0) ? mapped : (owned ? owned->data() : 0);
+        }
+
+        size_t size() const
+        {
+            return (mapped != 0) ? mapped_count : (owned ? owned->size() : 0);
+        }
+
+        size_t capacity() const
+        {
+            return (mapped != 0) ? mapped_count : (owned ? owned->capacity() : 0);
+        }
+
+        void push_back( const X& value )
+        {
+            detach().push_back( value );
+        }
+
+        void reserve( size_t count )
+        {
+            detach().reserve( count );
+        }
+
+        void resize( size_t count, const X& value = X() )
+        {
+            detach().resize( count, value );
+        }
+
+    private:
+
+        std::shared_ptr<std::vector<X>> owned;  // elements once the array has been changed, shared with copies
+        const X* mapped;                        // elements within a mapping, null when the owned elements are used
+        size_t mapped_count;                    // number of mapped elements
+
+};
+
+#endif
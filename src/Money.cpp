@@ -0,0 +1,70 @@
+#include <cmath>
+#include <cstdint>
+
+#include "Money.h"
+
+Money toMoney( double dollars )
+{
+    return static_cast<Money>( std::llround( dollars * MONEY_PER_DOLLAR ) );
+}
+
+double toDollars( Money amount )
+{
+    return static_cast<double>( amount ) / MONEY_PER_DOLLAR;
+}
+
+Quantity toQuantity( int count )
+{
+    return count;
+}
+
+Quantity toQuantity( double pounds )
+{
+    return static_cast<Quantity>( std::llround( pounds * MILLI_POUNDS_PER_POUND ) );
+}
+
+int64_t toRate( double fraction )
+{
+    return static_cast<int64_t>( std::llround( fraction * RATE_SCALE ) );
+}
+
+// Narrows an exact result to Money, holding anything beyond its range at the nearest end
+static Money saturateMoney( __int128 value )
+{
+    if(value > INT64_MAX)
+    {
+        return INT64_MAX;
+    }
+    if(value < INT64_MIN)
+    {
+        return INT64_MIN;
+    }
+
+    return static_cast<Money>( value );
+}
+
+Money scaleMoney( Money amount, int64_t numerator, int64_t denominator )
+{
+    __int128 product = static_cast<__int128>( amount ) * numerator;
+
+    // whole items need no rounding
+    if(denominator == 1)
+    {
+        return saturateMoney( product );
+    }
+
+    __int128 quotient = product / denominator;
+    __int128 remainder = product % denominator;
+
+    // round half away from zero, the remainder carries the sign of the product
+    if(remainder < 0)
+    {
+        remainder = -remainder;
+    }
+    if(remainder * 2 >= denominator)
+    {
+        quotient += (product < 0) ? -1 : 1;
+    }
+
+    return saturateMoney( quotient );
+}
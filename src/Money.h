@@ -0,0 +1,87 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+
+/// \typedef Money
+/// \brief Amount of currency held as a whole number of ten-thousandths of a dollar
+///
+/// All prices, markdowns, discount prices and totals are kept as 64 bit integers rather than floating point
+/// values. Sums of Money are exact, so the total of a cart does not depend on the order in which its lines
+/// are added together. The unit is one hundredth of a cent so that per pound prices applied to fractional
+/// weights keep precision beyond the cent until the customer is charged.
+typedef int64_t Money;
+
+/// \brief Number of Money units in one dollar
+const Money MONEY_PER_DOLLAR = 10000;
+
+/// \typedef Quantity
+/// \brief Amount of an item held as a whole number of units
+///
+/// Fixed price items are counted in whole items. Weight based items are counted in thousandths of a pound,
+/// so adding and removing weight is exact and an amount removed always matches the amount that was added.
+typedef int64_t Quantity;
+
+/// \brief Number of Quantity units in one pound of a weight based item
+const Quantity MILLI_POUNDS_PER_POUND = 1000;
+
+/// \brief Number of units that a discount rate of 1.0 is held as, so rates are kept to the millionth
+const int64_t RATE_SCALE = 1000000;
+
+/// \struct QuantityTraits
+/// \brief Describes how the amounts used by the public API map onto Quantity units
+///
+/// The amount of a fixed price item is given as an int and the amount of a weight based item as a double
+/// number of pounds. UNITS is the number of Quantity units in one of those amounts.
+template <class T>
+struct QuantityTraits;
+
+template <>
+struct QuantityTraits<int>
+{
+    static const Quantity UNITS = 1;
+};
+
+template <>
+struct QuantityTraits<double>
+{
+    static const Quantity UNITS = MILLI_POUNDS_PER_POUND;
+};
+
+/// \brief Converts dollars to Money, rounding half away from zero to the nearest Money unit
+///
+/// \param dollars Amount of currency as given to the public API
+Money toMoney( double dollars );
+
+/// \brief Converts Money to dollars for reporting through the public API
+///
+/// \param amount Amount of currency being reported
+double toDollars( Money amount );
+
+/// \brief Converts a count of items to a Quantity
+///
+/// \param count Number of items
+Quantity toQuantity( int count );
+
+/// \brief Converts pounds to a Quantity, rounding half away from zero to the nearest thousandth of a pound
+///
+/// \param pounds Weight of the item
+Quantity toQuantity( double pounds );
+
+/// \brief Converts a fraction between 0 and 1 to a rate out of RATE_SCALE, rounding half away from zero
+///
+/// \param fraction Portion of the price, such as the amount taken off by a discount
+int64_t toRate( double fraction );
+
+/// \brief Multiplies an amount of Money by the ratio numerator / denominator
+///
+/// This is the only place where Money is rounded. The product is computed with 128 bit intermediates so it
+/// can not overflow, and the result is rounded half away from zero to the nearest Money unit. A result beyond
+/// the range of Money is saturated to the nearest value Money can hold rather than wrapping around.
+///
+/// \param amount Amount of currency being scaled
+/// \param numerator Multiplier applied to the amount
+/// \param denominator Divisor applied to the product, must be greater than zero
+Money scaleMoney( Money amount, int64_t numerator, int64_t denominator );
+
+#endif
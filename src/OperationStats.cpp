@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Types.h"
+#include "OperationStats.h"
+
+#if POS_STATS
+
+// Each power of two is split into 2^SUB_BUCKET_BITS buckets, and values of 2^MAX_EXPONENT ticks or more
+// share the last bucket
+static const unsigned SUB_BUCKET_BITS = 4;
+static const unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+static const unsigned MAX_EXPONENT = 44;
+static const size_t HISTOGRAM_BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+// Number of entries in the per-thread cache of counters, a thread normally serves a single PointOfSale
+static const size_t CACHE_SIZE = 4;
+
+// Counters of a single thread, only ever written by that thread
+struct alignas(64) OperationStats::Counters
+{
+    std::thread::id thread;
+    std::atomic<uint64_t> codes[STATS_OP_COUNT][RETURN_CODE_COUNT];
+    std::atomic<uint64_t> max[STATS_OP_COUNT];
+    std::atomic<uint64_t> buckets[STATS_OP_COUNT][HISTOGRAM_BUCKETS];
+};
+
+struct CacheEntry
+{
+    uint64_t owner;                     // id of the OperationStats, ids are never reused
+    void* counters;
+};
+
+static std::atomic<uint64_t> next_id( 1 );
+static thread_local CacheEntry cache[CACHE_SIZE];
+
+// Only the owning thread writes a counter, so a plain load and store is enough and no atomic
+// read-modify-write is needed
+static inline void increment( std::atomic<uint64_t>& counter )
+{
+    counter.store( counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+}
+
+static inline size_t bucketOf( uint64_t ticks )
+{
+    if(ticks < SUB_BUCKETS)
+    {
+        return static_cast<size_t>( ticks );
+    }
+
+    unsigned exponent = 63 - static_cast<unsigned>( __builtin_clzll( ticks ) );
+    if(exponent > MAX_EXPONENT)
+    {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+
+    unsigned sub = static_cast<unsigned>( ticks >> (exponent - SUB_BUCKET_BITS) ) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+// Highest value held by a bucket
+static uint64_t bucketLimit( size_t bucket )
+{
+    if(bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    unsigned exponent = static_cast<unsigned>( bucket / SUB_BUCKETS ) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    uint64_t width = uint64_t( 1 ) << (exponent - SUB_BUCKET_BITS);
+    return ((SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS)) + width - 1;
+}
+
+// Clock readings taken when the library first timed an operation, used to turn ticks into nanoseconds
+struct ClockOrigin
+{
+    uint64_t ticks;
+    std::chrono::steady_clock::time_point time;
+};
+
+static const ClockOrigin& clockOrigin()
+{
+    static const ClockOrigin origin = { OperationStats::now(), std::chrono::steady_clock::now() };
+    return origin;
+}
+
+// Nanoseconds per tick, measured over everything since the origin so it becomes more precise as the process runs
+static double nanosecondsPerTick()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    const ClockOrigin& origin = clockOrigin();
+    uint64_t ticks = OperationStats::now() - origin.ticks;
+    double nanoseconds = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - origin.time ).count();
+
+    return (ticks > 0 && nanoseconds > 0) ? nanoseconds / static_cast<double>( ticks ) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+OperationStats::OperationStats() : id( next_id.fetch_add( 1 ) )
+{
+    clockOrigin();
+
+    // the thread creating the object is normally the one that scans on it, so its counters are made now
+    // and the scan path never has to allocate
+    cache[id % CACHE_SIZE] = { id, registerThread() };
+}
+
+OperationStats::~OperationStats()
+{
+
+}
+
+uint64_t OperationStats::now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    // the time stamp counter runs at a constant rate on every processor the library targets, and is read
+    // in about half the time of steady_clock
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+void OperationStats::record( StatsOp_t op, ReturnCode_t code, uint64_t start )
+{
+    uint64_t ticks = now() - start;
+
+    CacheEntry& entry = cache[id % CACHE_SIZE];
+    if(entry.owner != id)
+    {
+        entry.counters = registerThread();
+        entry.owner = id;
+    }
+    Counters* counters = static_cast<Counters*>( entry.counters );
+
+    increment( counters->codes[op][code] );
+    increment( counters->buckets[op][bucketOf( ticks )] );
+    if(ticks > counters->max[op].load( std::memory_order_relaxed ))
+    {
+        counters->max[op].store( ticks, std::memory_order_relaxed );
+    }
+}
+
+OperationStats::Counters* OperationStats::registerThread()
+{
+    std::lock_guard<std::mutex> guard( lock );
+
+    // a thread that has already recorded calls, but was since evicted from the cache, keeps its counters
+    std::thread::id self = std::this_thread::get_id();
+    for(const std::unique_ptr<Counters>& counters : threads)
+    {
+        if(counters->thread == self)
+        {
+            return counters.get();
+        }
+    }
+
+    std::unique_ptr<Counters> counters( new Counters() );
+    counters->thread = self;
+    for(size_t op = 0; op < STATS_OP_COUNT; op++)
+    {
+        for(std::atomic<uint64_t>& count : counters->codes[op])
+        {
+            count.store( 0, std::memory_order_relaxed );
+        }
+        for(std::atomic<uint64_t>& count : counters->buckets[op])
+        {
+            count.store( 0, std::memory_order_relaxed );
+        }
+        counters->max[op].store( 0, std::memory_order_relaxed );
+    }
+
+    threads.push_back( std::move( counters ) );
+    return threads.back().get();
+}
+
+void OperationStats::getSnapshot( PointOfSaleStats* pStats ) const
+{
+    std::vector<uint64_t> buckets( HISTOGRAM_BUCKETS );
+    double scale = nanosecondsPerTick();
+
+    std::lock_guard<std::mutex> guard( lock );
+    for(size_t op = 0; op < STATS_OP_COUNT; op++)
+    {
+        OperationSummary& summary = pStats->operations[op];
+        std::memset( &summary, 0, sizeof(summary) );
+        std::fill( buckets.begin(), buckets.end(), 0 );
+
+        uint64_t max = 0;
+        for(const std::unique_ptr<Counters>& counters : threads)
+        {
+            for(size_t code = 0; code < RETURN_CODE_COUNT; code++)
+            {
+                summary.codes[code] += counters->codes[op][code].load( std::memory_order_relaxed );
+            }
+            for(size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+            {
+                buckets[bucket] += counters->buckets[op][bucket].load( std::memory_order_relaxed );
+            }
+            max = std::max( max, counters->max[op].load( std::memory_order_relaxed ) );
+        }
+
+        // the histogram is read separately from the codes, so it is the histogram that gives the count the
+        // percentiles are taken from
+        uint64_t total = 0;
+        for(size_t code = 0; code < RETURN_CODE_COUNT; code++)
+        {
+            summary.count += summary.codes[code];
+        }
+        for(uint64_t count : buckets)
+        {
+            total += count;
+        }
+
+        double fractions[] = { 0.50, 0.99, 0.999 };
+        double* results[] = { &summary.latency_p50, &summary.latency_p99, &summary.latency_p999 };
+        for(size_t i = 0; i < 3 && total > 0; i++)
+        {
+            uint64_t rank = std::max<uint64_t>( 1, static_cast<uint64_t>( std::ceil( fractions[i] * total ) ) );
+            uint64_t seen = 0;
+            size_t bucket = 0;
+            while(seen + buckets[bucket] < rank)
+            {
+                seen += buckets[bucket++];
+            }
+            *results[i] = static_cast<double>( std::min( bucketLimit( bucket ), max ) ) * scale;
+        }
+        summary.latency_max = static_cast<double>( max ) * scale;
+    }
+}
+
+#endif
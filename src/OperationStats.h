@@ -0,0 +1,156 @@
+#ifndef OPERATION_STATS_H
+#define OPERATION_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Types.h"
+
+/// \brief Set to 0, normally through the POINT_OF_SALE_STATS CMake option, to build without operation statistics
+#ifndef POS_STATS
+#define POS_STATS 1
+#endif
+
+/// \enum StatsOp_t
+/// \brief Describes the PointOfSale calls whose latency and results are tracked
+typedef enum
+{
+    STATS_ADD_TO_CART,          ///< Every variant of PointOfSale::addToCart
+    STATS_REMOVE_FROM_CART,     ///< Every variant of PointOfSale::removeFromCart
+    STATS_GET_PRE_TAX_TOTAL,    ///< PointOfSale::getPreTaxTotal and PointOfSale::getPreTaxTotalMoney
+    STATS_ADD_TO_CART_BATCH,    ///< PointOfSale::addToCartBatch, timed and counted once per batch with the code it returned
+    STATS_OP_COUNT,             ///< Number of tracked calls, not a call itself
+} StatsOp_t;
+
+/// \brief Number of values of ReturnCode_t
+static const size_t RETURN_CODE_COUNT = ITEM_NOT_IN_CART + 1;
+
+/// \struct OperationSummary
+/// \brief Calls made to one operation, and how long they took
+///
+/// Latencies are in nanoseconds and are accurate to within about 6% of the value.
+struct OperationSummary
+{
+    uint64_t count;                         ///< Number of calls made
+    uint64_t codes[RETURN_CODE_COUNT];      ///< Number of calls that returned each ReturnCode_t, indexed by the code
+    double latency_p50;                     ///< Median time taken by a call
+    double latency_p99;                     ///< 99th percentile of the time taken by a call
+    double latency_p999;                    ///< 99.9th percentile of the time taken by a call
+    double latency_max;                     ///< Longest time taken by a call
+};
+
+/// \struct PointOfSaleStats
+/// \brief Snapshot of the calls made to a PointOfSale
+struct PointOfSaleStats
+{
+    OperationSummary operations[STATS_OP_COUNT];  ///< Summary of each operation, indexed by StatsOp_t
+};
+
+#if POS_STATS
+
+/// \class OperationStats
+/// \brief Counts the results of each tracked operation and keeps a histogram of how long they take
+///
+/// Every thread that records a call is given its own set of counters, and only ever writes to that set. The
+/// counters of the thread that created the object are made up front; any other thread's are made the first
+/// time it records a call. Recording a call therefore takes no locks and shares no cache lines with other
+/// threads; the counters are only combined when a snapshot is taken.
+///
+/// Latencies are kept in a log-linear histogram, in the manner of HdrHistogram: each power of two is split
+/// into 16 equal buckets, so every bucket is within 1/16 of the values it holds, from a nanosecond up to
+/// several hours. The histogram is a fixed array, so recording never allocates.
+class OperationStats
+{
+    public:
+
+        OperationStats();
+        ~OperationStats();
+
+        /// \brief Reads the clock used to time operations
+        static uint64_t now();
+
+        /// \brief Records a call made by the calling thread
+        ///
+        /// \param op The operation that was called
+        /// \param code Result of the call
+        /// \param start Value of now when the call began
+        void record( StatsOp_t op, ReturnCode_t code, uint64_t start );
+
+        /// \brief Combines the counters of every thread
+        ///
+        /// May be called from any thread while calls are being recorded. Calls recorded while the snapshot is
+        /// being taken may or may not be included.
+        ///
+        /// \param pStats Location that the snapshot is stored
+        void getSnapshot( PointOfSaleStats* pStats ) const;
+
+    private:
+
+        struct Counters;
+
+        /// \brief Finds or creates the counters of the calling thread
+        Counters* registerThread();
+
+        uint64_t id;                                    // identifies this object to the per-thread cache
+        mutable std::mutex lock;                        // guards threads, only taken the first time a thread records
+        std::vector<std::unique_ptr<Counters>> threads; // counters of every thread that has recorded a call
+
+};
+
+/// \class OperationTimer
+/// \brief Times a single tracked call, from its construction until done is called
+class OperationTimer
+{
+    public:
+
+        OperationTimer( OperationStats& stats, StatsOp_t op ) : stats( stats ), op( op ), start( OperationStats::now() )
+        {
+
+        }
+
+        /// \brief Records the call and hands back its result
+        ReturnCode_t done( ReturnCode_t code )
+        {
+            stats.record( op, code, start );
+            return code;
+        }
+
+    private:
+
+        OperationStats& stats;
+        StatsOp_t op;
+        uint64_t start;
+
+};
+
+#else
+
+// Statistics are compiled out: the classes keep their interface so that callers build unchanged, but hold and do nothing
+
+class OperationStats
+{
+
+};
+
+class OperationTimer
+{
+    public:
+
+        OperationTimer( OperationStats&, StatsOp_t )
+        {
+
+        }
+
+        ReturnCode_t done( ReturnCode_t code )
+        {
+            return code;
+        }
+
+};
+
+#endif
+
+#endif
@@ -1,10 +1,15 @@
-#include <string>
+#include <string_view>
+#include <vector>
 
 #include "Types.h"
 #include "PointOfSale.h"
-#include "CartItem.h"
 
-PointOfSale::PointOfSale()
+PointOfSale::PointOfSale() : cart( catalog, &arena )
+{
+
+}
+
+PointOfSale::PointOfSale( std::pmr::memory_resource* upstream ) : arena( upstream ), cart( catalog, &arena )
 {
 
 }
@@ -14,445 +19,458 @@ PointOfSale::~PointOfSale()
     
 }
 
-ReturnCode_t PointOfSale::setItemPrice( std::string sku, double price )
+ReturnCode_t PointOfSale::setItemPrice( std::string_view sku, double price )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    if(sku.length() == 0)
+    // updates to registered items go through the same checks as a handle
+    SkuHandle handle = catalog.resolveSku(sku);
+    if(handle != INVALID_SKU_HANDLE)
     {
-        return INVALID_SKU;
+        return setItemPrice( handle, price );
     }
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+    return catalog.setItemPrice( sku, price );
+}
 
-    // ensure that item hasn't already been added to system as a weight based
-    if(w_it != weight_items.end())
+ReturnCode_t PointOfSale::setPerPoundPrice( std::string_view sku, double price )
+{
+    // updates to registered items go through the same checks as a handle
+    SkuHandle handle = catalog.resolveSku(sku);
+    if(handle != INVALID_SKU_HANDLE)
     {
-        return ITEM_CONFLICT;
+        return setPerPoundPrice( handle, price );
     }
 
-    // if the item is already registered then call function to update price
-    if(f_it != fixed_items.end())
-    {
-        return f_it->second->setPrice(price);
-    }
-    else
+    return catalog.setPerPoundPrice( sku, price );
+}
+
+ReturnCode_t PointOfSale::setItemPrice( SkuHandle handle, double price )
+{
+    // the price of an item is locked once it has been scanned into the cart, but problems
+    // with the price itself are still reported first, using the same checks as the catalog
+    if(cart.isInCart(handle))
     {
-        CartItem<int>* fixed = new CartItem<int>();
-        ReturnCode_t code = fixed->setPrice(price);
-        fixed_items[sku] = fixed;
-        return code;
+        ReturnCode_t code = catalog.checkItemPrice( handle, price );
+        return (code == OK) ? PRICE_UPDATE_NOT_AVAILABLE : code;
     }
 
+    return catalog.setItemPrice( handle, price );
 }
 
-ReturnCode_t PointOfSale::setPerPoundPrice( std::string sku, double price )
+ReturnCode_t PointOfSale::setPerPoundPrice( SkuHandle handle, double price )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    if(sku.length() == 0)
+    // the price of an item is locked once it has been scanned into the cart, but problems
+    // with the price itself are still reported first, using the same checks as the catalog
+    if(cart.isInCart(handle))
     {
-        return INVALID_SKU;
+        ReturnCode_t code = catalog.checkPerPoundPrice( handle, price );
+        return (code == OK) ? PRICE_UPDATE_NOT_AVAILABLE : code;
     }
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+    return catalog.setPerPoundPrice( handle, price );
+}
 
-    // ensure that item hasn't already been added to system as a fixed based
-    if(f_it != fixed_items.end())
+SkuHandle PointOfSale::resolveSku( std::string_view sku ) const
+{
+    return catalog.resolveSku( sku );
+}
+
+ReturnCode_t PointOfSale::addToCart( SkuHandle handle, int count )
+{
+    OperationTimer timer( stats, STATS_ADD_TO_CART );
+    ReturnCode_t code = cart.addToCart( handle, count );
+    if(code == OK)
     {
-        return ITEM_CONFLICT;
+        code = journalChange( JOURNAL_ADD, { std::string_view(), handle, FIXED_PRICE_ITEM, static_cast<double>( count ) } );
     }
+    return timer.done( code );
+}
 
-    // if the item is already registered then call function to update price
-    if(w_it != weight_items.end())
+ReturnCode_t PointOfSale::addToCart( SkuHandle handle, double pounds )
+{
+    OperationTimer timer( stats, STATS_ADD_TO_CART );
+    ReturnCode_t code = cart.addToCart( handle, pounds );
+    if(code == OK)
     {
-        return w_it->second->setPrice(price);
+        code = journalChange( JOURNAL_ADD, { std::string_view(), handle, WEIGHT_BASED_ITEM, pounds } );
     }
-    else
+    return timer.done( code );
+}
+
+ReturnCode_t PointOfSale::addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes )
+{
+    OperationTimer timer( stats, STATS_ADD_TO_CART_BATCH );
+    ReturnCode_t code = cart.addToCartBatch( records, count, codes );
+    for(size_t i = 0; i < count && journal; i++)
     {
-        CartItem<double>* weight = new CartItem<double>();
-        ReturnCode_t code = weight->setPrice(price);
-        weight_items[sku] = weight;
-        return code;
+        if(codes[i] == OK)
+        {
+            codes[i] = journalChange( JOURNAL_ADD, records[i] );
+            code = (codes[i] == OK) ? code : ERROR;
+        }
     }
+    return timer.done( code );
 }
 
-ReturnCode_t PointOfSale::addToCart( std::string sku, int count )
+ReturnCode_t PointOfSale::removeFromCart( SkuHandle handle, int count )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    if(sku.length() == 0)
+    OperationTimer timer( stats, STATS_REMOVE_FROM_CART );
+    ReturnCode_t code = cart.removeFromCart( handle, count );
+    if(code == OK)
     {
-        return INVALID_SKU;
+        code = journalChange( JOURNAL_REMOVE, { std::string_view(), handle, FIXED_PRICE_ITEM, static_cast<double>( count ) } );
     }
+    return timer.done( code );
+}
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
-
-    // check to see if price for this sku has already been added as a weight based item
-    if(w_it != weight_items.end())
+ReturnCode_t PointOfSale::removeFromCart( SkuHandle handle, double pounds )
+{
+    OperationTimer timer( stats, STATS_REMOVE_FROM_CART );
+    ReturnCode_t code = cart.removeFromCart( handle, pounds );
+    if(code == OK)
     {
-        return ITEM_CONFLICT;
+        code = journalChange( JOURNAL_REMOVE, { std::string_view(), handle, WEIGHT_BASED_ITEM, pounds } );
     }
+    return timer.done( code );
+}
 
-    // An item won't be added to the system if not given a valid price. As such, the existence
-    // of the item in the map means that a price has been defined
-    if(f_it == fixed_items.end())
+ReturnCode_t PointOfSale::addToCart( std::string_view sku, int count )
+{
+    OperationTimer timer( stats, STATS_ADD_TO_CART );
+    ReturnCode_t code = cart.addToCart( sku, count );
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        code = journalChange( JOURNAL_ADD, { sku, INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, static_cast<double>( count ) } );
     }
-
-    return f_it->second->addToCart( count );
+    return timer.done( code );
 }
 
-ReturnCode_t PointOfSale::addToCart( std::string sku, double pounds )
+ReturnCode_t PointOfSale::addToCart( std::string_view sku, double pounds )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    if(sku.length() == 0)
+    OperationTimer timer( stats, STATS_ADD_TO_CART );
+    ReturnCode_t code = cart.addToCart( sku, pounds );
+    if(code == OK)
     {
-        return INVALID_SKU;
+        code = journalChange( JOURNAL_ADD, { sku, INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, pounds } );
     }
+    return timer.done( code );
+}
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
-
-    // check to see if price for this sku has already been added as a fixed price item
-    if(f_it != fixed_items.end())
+ReturnCode_t PointOfSale::removeFromCart( std::string_view sku, int count )
+{
+    OperationTimer timer( stats, STATS_REMOVE_FROM_CART );
+    ReturnCode_t code = cart.removeFromCart( sku, count );
+    if(code == OK)
     {
-        return ITEM_CONFLICT;
+        code = journalChange( JOURNAL_REMOVE, { sku, INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, static_cast<double>( count ) } );
     }
+    return timer.done( code );
+}
 
-    // An item won't be added to the system if not given a valid price. As such, the existence
-    // of the item in the map means that a price has been defined
-    if(w_it == weight_items.end())
+ReturnCode_t PointOfSale::removeFromCart( std::string_view sku, double pounds )
+{
+    OperationTimer timer( stats, STATS_REMOVE_FROM_CART );
+    ReturnCode_t code = cart.removeFromCart( sku, pounds );
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        code = journalChange( JOURNAL_REMOVE, { sku, INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, pounds } );
     }
-
-    return w_it->second->addToCart( pounds );
+    return timer.done( code );
 }
 
-ReturnCode_t PointOfSale::removeFromCart( std::string sku, int count )
+double PointOfSale::getPreTaxTotal()
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
+    OperationTimer timer( stats, STATS_GET_PRE_TAX_TOTAL );
+    double total = cart.getPreTaxTotal();
+    timer.done( OK );
+    return total;
+}
 
-    if(sku.length() == 0)
-    {
-        return INVALID_SKU;
-    }
+Money PointOfSale::getPreTaxTotalMoney()
+{
+    OperationTimer timer( stats, STATS_GET_PRE_TAX_TOTAL );
+    Money total = cart.getPreTaxTotalMoney();
+    timer.done( OK );
+    return total;
+}
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+ReturnCode_t PointOfSale::newTransaction()
+{
+    cart.newTransaction();
 
-    // check to see if item was registered as a weight based item
-    if(w_it != weight_items.end())
-    {
-        return ITEM_CONFLICT;
-    }
+    return journal ? journal->newTransaction() : OK;
+}
 
-    // check to see that it was registered as a fixed item
-    if(f_it == fixed_items.end())
+ReturnCode_t PointOfSale::getStats( PointOfSaleStats* pStats ) const
+{
+    if(pStats == 0)
     {
-        return ITEM_NOT_IN_CART;
+        return INVALID_ARG;
     }
 
-    return f_it->second->removeFromCart( count );
+#if POS_STATS
+    stats.getSnapshot( pStats );
+    return OK;
+#else
+    return ERROR;
+#endif
 }
 
-ReturnCode_t PointOfSale::removeFromCart( std::string sku, double pounds )
+ReturnCode_t PointOfSale::openJournal( const std::string& path, std::chrono::microseconds window )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    if(sku.length() == 0)
+    if(journal)
     {
-        return INVALID_SKU;
+        return ERROR;
     }
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
-
-    // check to see if item was registered as a fixed price item
-    if(f_it != fixed_items.end())
+    std::unique_ptr<ScanJournal> opened( new ScanJournal() );
+    std::vector<JournalEntry> entries;
+    ReturnCode_t code = opened->open( path, window, &entries );
+    if(code != OK)
     {
-        return ITEM_CONFLICT;
+        return code;
     }
 
-    // check to see that it was registered as a fixed item
-    if(w_it == weight_items.end())
+    // the changes are already in the journal, so they are made before it is attached to the cart
+    cart.newTransaction();
+    for(const JournalEntry& entry : entries)
     {
-        return ITEM_NOT_IN_CART;
+        replayChange( entry );
     }
 
-    return w_it->second->removeFromCart( pounds );
+    journal = std::move( opened );
+    return OK;
 }
 
-double PointOfSale::getPreTaxTotal()
+ReturnCode_t PointOfSale::syncJournal()
 {
-    double total = 0.0;
-    double price = 0.0;
-
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
+    return journal ? journal->sync() : ERROR;
+}
 
-    // calculate totals for each of the fixed price items in cart
-    f_it = fixed_items.begin();
-    while( f_it != fixed_items.end() )
+ReturnCode_t PointOfSale::journalChange( JournalOp_t op, const ScanRecord& record )
+{
+    if(!journal)
     {
-        f_it->second->computePreTax( &price );
-
-        // increment the total based on this item
-        total += price;
-        f_it++;
+        return OK;
     }
 
-    // calculate totals for each of the weight based item in cart
-    w_it = weight_items.begin();
-    while( w_it != weight_items.end() )
+    // handles depend on the order the catalog was configured in, so the item is always recorded by its SKU
+    ScanRecord entry = record;
+    if(entry.handle != INVALID_SKU_HANDLE)
     {
-        w_it->second->computePreTax( &price );
+        entry.sku = catalog.getSku( entry.handle );
+        entry.handle = INVALID_SKU_HANDLE;
+    }
 
-        // increment the total based on this item
-        total += price;
-        w_it++;
+    ReturnCode_t code = journal->append( op, entry );
+    if(code != OK)
+    {
+        // a change that can not be recorded is taken back out of the cart, so the call fails as a whole
+        applyChange( (op == JOURNAL_ADD) ? JOURNAL_REMOVE : JOURNAL_ADD, catalog.resolveSku( entry.sku ), record.type,
+                     record.amount );
     }
 
-    return total;
+    return code;
 }
 
-ReturnCode_t PointOfSale::setMarkdown( std::string sku, double price )
+void PointOfSale::replayChange( const JournalEntry& entry )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
+    // entries without a SKU were written through a handle by an earlier version of the journal
+    SkuHandle handle = entry.sku.empty() ? entry.handle : catalog.resolveSku( entry.sku );
 
-    if(sku.length() == 0)
-    {
-        return INVALID_SKU;
-    }
+    applyChange( entry.op, handle, entry.type, entry.amount );
+}
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+ReturnCode_t PointOfSale::applyChange( JournalOp_t op, SkuHandle handle, ItemType_t type, double amount )
+{
+    int count = static_cast<int>( amount );
 
-    // check to see that this item has been defined and that a price has been set
-    if(f_it == fixed_items.end() && w_it == weight_items.end())
+    if(op == JOURNAL_ADD && type == FIXED_PRICE_ITEM)
     {
-        return NO_PRICE_DEFINED;
+        return cart.addToCart( handle, count );
     }
-    else if(f_it != fixed_items.end())
+    else if(op == JOURNAL_ADD)
     {
-        return f_it->second->applyMarkdown( price );
+        return cart.addToCart( handle, amount );
     }
-    else
+    else if(type == FIXED_PRICE_ITEM)
     {
-        return w_it->second->applyMarkdown( price );
+        return cart.removeFromCart( handle, count );
     }
 
+    return cart.removeFromCart( handle, amount );
 }
-        
-ReturnCode_t PointOfSale::applyGetXForYDiscount  ( std::string sku, int buy_x, double amount )
-{
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
 
+ReturnCode_t PointOfSale::setMarkdown( std::string_view sku, double price )
+{
     if(sku.length() == 0)
     {
         return INVALID_SKU;
     }
-    if(buy_x <= 0 || amount < 0)
-    {
-        return INVALID_DISCOUNT;
-    }
 
-    // check to see if item was registered as a weight based item
-    if(w_it != weight_items.end())
+    return setMarkdown( catalog.resolveSku(sku), price );
+}
+
+ReturnCode_t PointOfSale::setMarkdown( SkuHandle handle, double price )
+{
+    // the markdown is locked once the item has been scanned, but problems
+    // with the markdown itself are still reported first
+    if(cart.isInCart(handle))
     {
-        return ITEM_CONFLICT;
+        ReturnCode_t code = catalog.checkMarkdown( handle, price );
+        return (code == OK) ? PRICE_UPDATE_NOT_AVAILABLE : code;
     }
 
-    if(f_it == fixed_items.end())
+    return catalog.setMarkdown( handle, price );
+}
+        
+ReturnCode_t PointOfSale::applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount )
+{
+    ReturnCode_t code = catalog.applyGetXForYDiscount( sku, buy_x, amount );
+
+    // discounts may change while the item is in the cart, so price the line again
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return f_it->second->applyGetXforPriceDiscount( buy_x, amount );
+    return code;
 }
 
-ReturnCode_t PointOfSale::applyGetXForYDiscount  ( std::string sku, int buy_x, double amount, int limit )
+ReturnCode_t PointOfSale::applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+    ReturnCode_t code = catalog.applyGetXForYDiscount( sku, buy_x, amount, limit );
 
-    if(sku.length() == 0)
+    if(code == OK)
     {
-        return INVALID_SKU;
-    }
-    if(buy_x <= 0 || amount < 0 || limit <= 0)
-    {
-        return INVALID_DISCOUNT;
+        cart.refreshItem( sku );
     }
 
-    // check to see if item was registered as a weight based item
-    if(w_it != weight_items.end())
-    {
-        return ITEM_CONFLICT;
-    }
+    return code;
+}
 
-    if(f_it == fixed_items.end())
+ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off )
+{
+    ReturnCode_t code = catalog.applyBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off );
+
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return f_it->second->applyGetXforPriceDiscount( buy_x, amount, limit );
+    return code;
 }
 
-ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string sku, int buy_x, int get_y, double percent_off )
+ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+    ReturnCode_t code = catalog.applyBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off );
 
-    if(sku.length() == 0)
+    if(code == OK)
     {
-        return INVALID_SKU;
-    }
-    if(buy_x <= 0 || get_y < 0 || percent_off >= 1.0 || percent_off < 0.0)
-    {
-        return INVALID_DISCOUNT;
+        cart.refreshItem( sku );
     }
 
-    // check to see if item was registered as a weight based item
-    if(w_it != weight_items.end())
-    {
-        return ITEM_CONFLICT;
-    }
+    return code;
+}
+
+ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit )
+{
+    ReturnCode_t code = catalog.applyBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off, limit );
 
-    if(f_it == fixed_items.end())
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return f_it->second->applyBuyXGetYDiscount( buy_x, get_y, percent_off );
+    return code;
 }
 
-ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string sku, double buy_x, double get_y, double percent_off )
+ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
+    ReturnCode_t code = catalog.applyBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off, limit );
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
-
-    if(sku.length() == 0)
-    {
-        return INVALID_SKU;
-    }
-    if(buy_x <= 0 || get_y < 0 || percent_off >= 1.0 || percent_off < 0.0)
+    if(code == OK)
     {
-        return INVALID_DISCOUNT;
+        cart.refreshItem( sku );
     }
 
-    // check to see if item was registered as a weight based item
-    if(f_it != fixed_items.end())
-    {
-        return ITEM_CONFLICT;
-    }
+    return code;
+}
+
+ReturnCode_t PointOfSale::addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount )
+{
+    ReturnCode_t code = catalog.addGetXForYDiscount( sku, buy_x, amount );
 
-    if(w_it == weight_items.end())
+    // discounts may change while the item is in the cart, so price the line again
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return w_it->second->applyBuyXGetYDiscount( buy_x, get_y, percent_off );
+    return code;
 }
 
-ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string sku, int buy_x, int get_y, double percent_off, int limit )
+ReturnCode_t PointOfSale::addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
+    ReturnCode_t code = catalog.addGetXForYDiscount( sku, buy_x, amount, limit );
 
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
-
-    if(sku.length() == 0)
-    {
-        return INVALID_SKU;
-    }
-    if(buy_x <= 0 || get_y < 0 || percent_off >= 1.0 || percent_off < 0.0 || limit < 0)
+    if(code == OK)
     {
-        return INVALID_DISCOUNT;
+        cart.refreshItem( sku );
     }
 
-    // check to see if item was registered as a weight based item
-    if(w_it != weight_items.end())
-    {
-        return ITEM_CONFLICT;
-    }
+    return code;
+}
+
+ReturnCode_t PointOfSale::addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off )
+{
+    ReturnCode_t code = catalog.addBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off );
 
-    if(f_it == fixed_items.end())
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return f_it->second->applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit );
-    return ERROR;
+    return code;
 }
 
-ReturnCode_t PointOfSale::applyBuyXGetYAtDiscount( std::string sku, double buy_x, double get_y, double percent_off, double limit )
+ReturnCode_t PointOfSale::addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off )
 {
-    map<string, CartItem<int>*>::iterator f_it;
-    map<string, CartItem<double>*>::iterator w_it;
-
-    // perform search in both maps for the given sku
-    f_it = fixed_items.find(sku);
-    w_it = weight_items.find(sku);
+    ReturnCode_t code = catalog.addBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off );
 
-    if(sku.length() == 0)
-    {
-        return INVALID_SKU;
-    }
-    if(buy_x <= 0 || get_y < 0 || percent_off >= 1.0 || percent_off < 0.0 || limit < 0)
+    if(code == OK)
     {
-        return INVALID_DISCOUNT;
+        cart.refreshItem( sku );
     }
 
-    // check to see if item was registered as a weight based item
-    if(f_it != fixed_items.end())
+    return code;
+}
+
+ReturnCode_t PointOfSale::addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit )
+{
+    ReturnCode_t code = catalog.addBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off, limit );
+
+    if(code == OK)
     {
-        return ITEM_CONFLICT;
+        cart.refreshItem( sku );
     }
 
-    if(w_it == weight_items.end())
+    return code;
+}
+
+ReturnCode_t PointOfSale::addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit )
+{
+    ReturnCode_t code = catalog.addBuyXGetYAtDiscount( sku, buy_x, get_y, percent_off, limit );
+
+    if(code == OK)
     {
-        return NO_PRICE_DEFINED;
+        cart.refreshItem( sku );
     }
 
-    return w_it->second->applyBuyXGetYDiscount( buy_x, get_y, percent_off, limit );
-}
\ No newline at end of file
+    return code;
+}
+
+ReturnCode_t PointOfSale::setPriceTables( int quantity, size_t item_count )
+{
+    // a table holds exactly the prices the discount gives, so no line in the cart changes
+    return catalog.setPriceTables( quantity, item_count );
+}
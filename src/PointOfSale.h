@@ -1,11 +1,19 @@
 #ifndef POINT_OF_SALE_H
 #define POINT_OF_SALE_H
 
+#include <chrono>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <map>
 
 #include "Types.h"
-#include "CartItem.h"
+#include "Money.h"
+#include "Catalog.h"
+#include "Cart.h"
+#include "ScanJournal.h"
+#include "OperationStats.h"
 
 using namespace std;
 
@@ -28,11 +36,29 @@ using namespace std;
 /// sold by the pound. The second discount is a bundling where the customer gets X number of items for a set price. Each of the
 /// discounts also support a limit whereby the customer is now allowed to get the discount on more than the specified number of items,
 /// or pounds.
+///
+/// Internally, the configuration is kept in a Catalog and the scanned items are kept in a Cart. Deployments that run many
+/// checkouts against the same prices can use those classes directly so that a single catalog is shared by every cart.
+///
+/// The memory used to track the items in the cart is taken from an arena owned by the PointOfSale. The arena only
+/// grows while the cart is sized for the items of the catalog, is reused by every transaction, and is released in
+/// one step when the PointOfSale is destroyed.
+///
+/// Every API accepts the SKU as a std::string_view. Barcodes handed over as character arrays or string literals are
+/// looked up in place, so scanning an item does not allocate memory or copy the SKU.
 class PointOfSale
 {
     public:
 
         PointOfSale();
+
+        /// \brief Creates a PointOfSale whose cart arena takes its blocks from the given resource
+        ///
+        /// Giving the arena a std::pmr::monotonic_buffer_resource over a preallocated buffer keeps the scan path
+        /// away from the global heap entirely.
+        ///
+        /// \param upstream Source of the blocks used by the cart arena, must outlive the PointOfSale
+        PointOfSale( std::pmr::memory_resource* upstream );
         ~PointOfSale();
 
         /// \brief Provides ability to enable a marked down price on an item
@@ -43,15 +69,63 @@ class PointOfSale
         ///
         /// \param sku Represents the itemt hat is being added
         /// \param price Amount of discount to apply to the item
-        ReturnCode_t setMarkdown( std::string sku, double price );
+        ReturnCode_t setMarkdown( std::string_view sku, double price );
 
         /// \brief Calculates the pre-tax total for all items within cart
         ///
         /// The PointOfSale system keep track of the items in the shopping cart. The items in the cart and
         /// any assoicated discounts and/or markdowns are taken into account when calculating the total
-        /// cost of the cart.
+        /// cost of the cart. The total is maintained as items, prices and discounts change, so retrieving
+        /// it after every scan does not require the cart to be priced again.
+        ///
+        /// Internally the total is kept as an exact integer number of hundredths of a cent. Each line is
+        /// rounded half away from zero to that unit when it is priced, and the total is the exact sum of
+        /// the lines, so the result does not depend on the order in which items were scanned.
         double getPreTaxTotal();
 
+        /// \brief Provides the exact pre-tax total for all items within the cart, in Money units
+        Money getPreTaxTotalMoney();
+
+        /// \brief Empties the cart so that the next customer can be checked out
+        ///
+        /// All price, markdown and discount configuration is kept. Starting a new transaction takes the same
+        /// time regardless of how many items were scanned or how many items are in the catalog, so there is
+        /// no need to create a new PointOfSale between customers.
+        ///
+        /// \return OK, or the code returned by the journal when one is open and could not be emptied, in which
+        ///         case the cart is still emptied but the journal may hold the previous customer after a restart
+        ReturnCode_t newTransaction();
+
+        /// \brief Records every change to the cart in a journal so that the cart survives the process stopping
+        ///
+        /// Every item added to or removed from the cart from then on is written to the journal, which is emptied
+        /// when a new transaction is started. Items are always recorded by SKU, including those scanned through a
+        /// handle, so the journal can be replayed against a catalog configured in a different order. A scan the
+        /// journal can not record, such as one made once writing to the file has failed, is taken back out of the
+        /// cart and the call returns the code given by the journal. If the journal already holds changes, left behind by a PointOfSale
+        /// that stopped part way through a customer, the cart is emptied and those changes are made to it again,
+        /// giving exactly the cart as it was. The prices must therefore be configured before the journal is opened.
+        ///
+        /// \param path Location of the journal file
+        /// \param window Longest time a change may go without being flushed to the disk, zero to flush every change
+        /// \return OK, INVALID_ARG when the file cannot be opened, or ERROR when it is not a journal or one is already open
+        ReturnCode_t openJournal( const std::string& path, std::chrono::microseconds window = ScanJournal::DEFAULT_WINDOW );
+
+        /// \brief Waits until every change made to the cart has been flushed to the journal on disk
+        ///
+        /// \return OK, or ERROR when no journal is open or it could not be written to
+        ReturnCode_t syncJournal();
+
+        /// \brief Provides the number of calls made to addToCart, removeFromCart, getPreTaxTotal and addToCartBatch,
+        /// the codes they returned and the percentiles of how long they took
+        ///
+        /// Calls are counted from when the PointOfSale was created, on every thread that has used it. Taking a
+        /// snapshot does not slow down the calls being made at the same time.
+        ///
+        /// \param pStats Location that the snapshot is stored
+        /// \return OK, INVALID_ARG if pStats is null, or ERROR when the library was built without statistics
+        ReturnCode_t getStats( PointOfSaleStats* pStats ) const;
+
         /// \brief Provides ability to setup a fixed price for a SKU
         ///
         /// The PointOfSale class supports fixed price and weight based items being added to the cart. The
@@ -63,7 +137,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param price The price per unit of the item within the cart
-        ReturnCode_t setItemPrice( std::string sku, double price );
+        ReturnCode_t setItemPrice( std::string_view sku, double price );
 
         /// \brief Provides ability to setup a per pound based price for a SKU
         ///
@@ -77,7 +151,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param price The price per pound of the unit being added to the cart
-        ReturnCode_t setPerPoundPrice( std::string sku, double price );
+        ReturnCode_t setPerPoundPrice( std::string_view sku, double price );
 
         /// \brief Adds fixed price items to the cart
         ///
@@ -87,7 +161,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param pound Amount of the item that should be added to the cart
-        ReturnCode_t addToCart( std::string sku, int count );
+        ReturnCode_t addToCart( std::string_view sku, int count );
 
         /// \brief Adds weight to an item in the cart
         ///
@@ -98,7 +172,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param pound Amount of the item that should be added to the cart, in pounds
-        ReturnCode_t addToCart( std::string sku, double weight );
+        ReturnCode_t addToCart( std::string_view sku, double weight );
 
         /// \brief Removes fixed price items from cart
         ///
@@ -109,7 +183,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param count The number of items that need to removed from the cart
-        ReturnCode_t removeFromCart( std::string sku, int count );
+        ReturnCode_t removeFromCart( std::string_view sku, int count );
 
         /// \brief Removes portion of weight based item from shopping cart
         ///
@@ -120,7 +194,7 @@ class PointOfSale
         ///
         /// \param sku Represents the item that is being added
         /// \param weight Amount of the item that should be removed from the cart, in pounds
-        ReturnCode_t removeFromCart( std::string sku, double weight );
+        ReturnCode_t removeFromCart( std::string_view sku, double weight );
 
         /// \brief Applys a buy X items for the Z price
         ///
@@ -131,7 +205,7 @@ class PointOfSale
         /// \param sku Represents the item that is being added
         /// \param buy_x Number of items that must be purchased for discount to apply
         /// \param amount Cost for purchasing the number of specified items
-        ReturnCode_t applyGetXForYDiscount  ( std::string sku, int buy_x, double amount );
+        ReturnCode_t applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount );
 
         /// \brief Applys a buy X items for the Z price
         ///
@@ -143,7 +217,7 @@ class PointOfSale
         /// \param sku Represents the item that is being added
         /// \param buy_x Number of items that must be purchased for discount to apply
         /// \param amount Cost for purchasing the number of specified items
-        ReturnCode_t applyGetXForYDiscount  ( std::string sku, int buy_x, double amount, int limit );
+        ReturnCode_t applyGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit );
 
         /// \brief Applies a discount that allows the customer to purchae items at discounted rate after purchasing a qualified number of items
         ///
@@ -155,7 +229,7 @@ class PointOfSale
         /// \param buy_x The number of items that must be purchased at full price to receive discount
         /// \param buy_y The number of items that customer is allowed to buy at discounted rate
         /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
-        ReturnCode_t applyBuyXGetYAtDiscount( std::string sku, int buy_x, int get_y, double percent_off );
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off );
 
         /// \brief Applies a discount that allows the customer to purchae items at discounted rate after purchasing a qualified number of items
         ///
@@ -169,7 +243,7 @@ class PointOfSale
         /// \param buy_y The number of items that customer is allowed to buy at discounted rate
         /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
         /// \param limit The number of items that are allowed to be purchased with this discount
-        ReturnCode_t applyBuyXGetYAtDiscount( std::string sku, int buy_x, int get_y, double percent_off, int limit );
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit );
 
         /// \brief Applies a discount that allows the customer to purchae items at discounted rate after purchasing a qualified number of items
         ///
@@ -182,7 +256,7 @@ class PointOfSale
         /// \param buy_x The number of pounds that must be purchased at full price to receive discount
         /// \param buy_y The number of pounds that customer is allowed to buy at discounted rate
         /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
-        ReturnCode_t applyBuyXGetYAtDiscount( std::string sku, double buy_x, double get_y, double percent_off );
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off );
 
         /// \brief Applies a discount that allows the customer to purchae items at discounted rate after purchasing a qualified number of items
         ///
@@ -196,12 +270,161 @@ class PointOfSale
         /// \param buy_y The number of pounds that customer is allowed to buy at discounted rate
         /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
         /// \param limit The number of pounds that are allowed to be purchased with this discount
-        ReturnCode_t applyBuyXGetYAtDiscount( std::string sku, double buy_x, double get_y, double percent_off, double limit );
+        ReturnCode_t applyBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Offers a buy X items for the Z price alongside the discounts already configured for the item
+        ///
+        /// Promotions often overlap, such as a loyalty bundle price running alongside a weekend buy X get Y offer.
+        /// Where the apply functions replace the discount of an item, the add functions keep each discount already
+        /// offered, and every line is charged the cheapest way of combining them. See Catalog::addGetXForYDiscount.
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        ReturnCode_t addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount );
+
+        /// \brief Offers a buy X items for the Z price, with a limit, alongside the discounts already configured for the item
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x Number of items that must be purchased for discount to apply
+        /// \param amount Cost for purchasing the number of specified items
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addGetXForYDiscount  ( std::string_view sku, int buy_x, double amount, int limit );
+
+        /// \brief Offers a buy X get Y discount alongside the discounts already configured for the item
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, alongside the discounts already configured for the item
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of items that must be purchased at full price to receive discount
+        /// \param get_y The number of items that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y items. Must be between 0 and 1.0
+        /// \param limit The number of items that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, int buy_x, int get_y, double percent_off, int limit );
+
+        /// \brief Offers a buy X get Y discount on a weight based item alongside the discounts already configured for it
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off );
+
+        /// \brief Offers a buy X get Y discount, with a limit, on a weight based item alongside the discounts already configured for it
+        ///
+        /// \param sku Represents the item that is being configured
+        /// \param buy_x The number of pounds that must be purchased at full price to receive discount
+        /// \param get_y The number of pounds that customer is allowed to buy at discounted rate
+        /// \param percent_off The percentage of discount on the y pounds. Must be between 0 and 1.0
+        /// \param limit The number of pounds that are allowed to be purchased with this discount
+        ReturnCode_t addBuyXGetYAtDiscount( std::string_view sku, double buy_x, double get_y, double percent_off, double limit );
+
+        /// \brief Keeps the price of every count up to a limit for discounted fixed price items
+        ///
+        /// Scanning an item with a table prices its line with a single lookup instead of working through the
+        /// discount. The items are chosen by position rather than by how often they are scanned, and weight
+        /// based items are never given a table. See Catalog::setPriceTables.
+        ///
+        /// \param quantity Largest count held by each table, zero turns the tables off, no more than
+        ///        MAX_PRICE_TABLE_AMOUNT
+        /// \param item_count Most items that are given a table
+        /// \return OK, or INVALID_ARG for a negative quantity or one above MAX_PRICE_TABLE_AMOUNT
+        ReturnCode_t setPriceTables( int quantity, size_t item_count );
+
+        /// \brief Converts a SKU into a handle that can be used in place of the string
+        ///
+        /// Front ends that see the same barcodes over and over can resolve each SKU once and use the
+        /// returned handle for every following operation. The handle indexes straight into the storage
+        /// for the item, so no hashing or string comparisons are performed. The handle for a SKU never
+        /// changes once the SKU has been given a price.
+        ///
+        /// \param sku Represents the item being looked up
+        /// \return Handle for the item, or INVALID_SKU_HANDLE if no price has been defined for the SKU
+        SkuHandle resolveSku( std::string_view sku ) const;
+
+        /// \brief Adds fixed price items to the cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param count Amount of the item that should be added to the cart
+        ReturnCode_t addToCart( SkuHandle handle, int count );
+
+        /// \brief Adds weight to an item in the cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param weight Amount of the item that should be added to the cart, in pounds
+        ReturnCode_t addToCart( SkuHandle handle, double weight );
+
+        /// \brief Adds a whole basket of items to the cart at once
+        ///
+        /// Orders placed online and recalled suspended transactions arrive as complete baskets. Each record
+        /// names the item by SKU or by handle along with how it is sold and the amount. The records are checked
+        /// exactly as they would be by addToCart, but the line for each item is priced only once per batch
+        /// regardless of how many records refer to it.
+        ///
+        /// \param records The scans being added to the cart
+        /// \param count Number of records
+        /// \param codes Location that the result of each record is stored, must hold count entries
+        /// \return OK when every record was added, otherwise ERROR with the reason for each failure in codes
+        ReturnCode_t addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes );
+
+        /// \brief Removes fixed price items from cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being removed
+        /// \param count The number of items that need to removed from the cart
+        ReturnCode_t removeFromCart( SkuHandle handle, int count );
+
+        /// \brief Removes portion of weight based item from shopping cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being removed
+        /// \param weight Amount of the item that should be removed from the cart, in pounds
+        ReturnCode_t removeFromCart( SkuHandle handle, double weight );
+
+        /// \brief Updates the price of a fixed price item using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item whose price is being updated
+        /// \param price The price per unit of the item within the cart
+        ReturnCode_t setItemPrice( SkuHandle handle, double price );
+
+        /// \brief Updates the price of a weight based item using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item whose price is being updated
+        /// \param price The price per pound of the item
+        ReturnCode_t setPerPoundPrice( SkuHandle handle, double price );
+
+        /// \brief Provides ability to enable a marked down price on an item using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item whose markdown is being updated
+        /// \param price Amount of discount to apply to the item
+        ReturnCode_t setMarkdown( SkuHandle handle, double price );
+
     protected:
 
     private:
-        map<string, CartItem<int>*>  fixed_items;
-        map<string, CartItem<double>*> weight_items;
+
+        /// \brief Writes a change already made to the cart to the journal, if one is open
+        ///
+        /// The item is always recorded by its SKU. A change the journal refuses is taken back out of the cart.
+        ///
+        /// \return OK, or the code returned by the journal
+        ReturnCode_t journalChange( JournalOp_t op, const ScanRecord& record );
+
+        /// \brief Makes a change read back from the journal to the cart
+        void replayChange( const JournalEntry& entry );
+
+        /// \brief Adds an amount of an item to the cart or removes it, without recording it in the journal
+        ReturnCode_t applyChange( JournalOp_t op, SkuHandle handle, ItemType_t type, double amount );
+
+        Catalog catalog; // prices configured through this object
+        std::pmr::monotonic_buffer_resource arena; // memory used by the cart, released with the PointOfSale
+        Cart cart;       // items scanned for the customer, priced against the catalog
+        std::unique_ptr<ScanJournal> journal; // changes to the cart, when journaling has been enabled
+        OperationStats stats;     // counts and times the calls made on the scan path
 
 };
 
@@ -0,0 +1,57 @@
+#include "Types.h"
+#include "PricingKernel.h"
+
+// The vector kernels live in their own files so they can be compiled for instruction
+// sets that the rest of the library must not assume are present.
+extern const bool SSE42_KERNEL_BUILT;
+extern const bool AVX2_KERNEL_BUILT;
+
+Money priceLinesSse42( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced );
+Money priceLinesAvx2( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced );
+
+bool isPricingKernelSupported( PricingKernel_t kernel )
+{
+    switch(kernel)
+    {
+        case SCALAR_KERNEL:
+            return true;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        case SSE42_KERNEL:
+            return SSE42_KERNEL_BUILT && __builtin_cpu_supports( "sse4.2" );
+        case AVX2_KERNEL:
+            return AVX2_KERNEL_BUILT && __builtin_cpu_supports( "avx2" );
+#endif
+        default:
+            return false;
+    }
+}
+
+PricingKernel_t getPricingKernel()
+{
+    static const PricingKernel_t selected = isPricingKernelSupported( AVX2_KERNEL )  ? AVX2_KERNEL  :
+                                            isPricingKernelSupported( SSE42_KERNEL ) ? SSE42_KERNEL :
+                                                                                       SCALAR_KERNEL;
+    return selected;
+}
+
+Money priceLines( PricingKernel_t kernel, const PricingColumns& items, const Quantity* amounts, Money* totals,
+                  size_t count, size_t* pUnpriced )
+{
+    if(kernel == AVX2_KERNEL)
+    {
+        return priceLinesAvx2( items, amounts, totals, count, pUnpriced );
+    }
+    else if(kernel == SSE42_KERNEL)
+    {
+        return priceLinesSse42( items, amounts, totals, count, pUnpriced );
+    }
+
+    // the scalar kernel is run by the caller, so every line is left for it
+    for(size_t i = 0; i < count; i++)
+    {
+        totals[i] = UNPRICED_LINE;
+    }
+    *pUnpriced = count;
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#ifndef PRICING_KERNEL_H
+#define PRICING_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Types.h"
+#include "Money.h"
+#include "DiscountPolicy.h"
+
+/// \enum PricingKernel_t
+/// \brief Identifies the implementation used to price many lines at once
+typedef enum
+{
+    SCALAR_KERNEL,  ///< Prices one line at a time, available on every processor
+    SSE42_KERNEL,   ///< Prices two lines at a time using SSE4.2 instructions
+    AVX2_KERNEL,    ///< Prices four lines at a time using AVX2 instructions
+} PricingKernel_t;
+
+/// \brief Bit within the item flags that is set once a valid price has been configured
+const uint8_t ITEM_PRICE_SET = 0x01;
+
+/// \brief Value stored for a line that a vector kernel was not able to price exactly
+const Money UNPRICED_LINE = INT64_MIN;
+
+/// \struct PricingColumns
+/// \brief Locates the arrays holding the configuration of a run of items
+///
+/// Each column holds one field for every item, so element i of every column belongs to the same item. The
+/// discounts are held in a pool for each type, located through the discount index of the item. The layout
+/// matches the storage of ItemStore.
+struct PricingColumns
+{
+    const Money*            net_price;       ///< Price after the markdown has been taken off
+    const uint8_t*          discount_type;   ///< DiscountType_t of each item
+    const uint32_t*         discount_index;  ///< Position of the discount of each item within the pool for its type
+    const BundleDiscount*   bundles;         ///< Pool of X_FOR_FLAT discounts
+    const BuyXGetYDiscount* buy_x_get_y;     ///< Pool of BUY_X_GET_Y_FOR_Z_LIMIT_W discounts
+    Quantity                units;           ///< Quantity units in one item, or one pound
+};
+
+/// \brief Indicates whether the kernel was built and can run on this processor
+///
+/// \param kernel The implementation being checked
+bool isPricingKernelSupported( PricingKernel_t kernel );
+
+/// \brief Provides the fastest kernel that is supported, the choice is made once when first called
+PricingKernel_t getPricingKernel();
+
+/// \brief Prices a run of lines using one of the vector kernels
+///
+/// The vector kernels compute in double precision and check every intermediate value against the range
+/// where doubles hold integers exactly. Lines that stay within that range receive exactly the same cost as
+/// CatalogItem::computePreTax. Lines that do not, lines of items offering STACKED_DISCOUNTS, and any lines
+/// left over after the last full group of lanes, are stored as UNPRICED_LINE and left out of the returned sum
+/// so the caller can price them one at a time.
+///
+/// \param kernel The vector kernel to use, must be supported
+/// \param items Configuration of each item
+/// \param amounts Amount of each item in the cart
+/// \param totals Location that the pre-tax cost of each line is stored
+/// \param count Number of lines to price
+/// \param pUnpriced Location that the number of lines stored as UNPRICED_LINE is stored
+/// \return Sum of the pre-tax cost of every line that was priced
+Money priceLines( PricingKernel_t kernel, const PricingColumns& items, const Quantity* amounts, Money* totals,
+                  size_t count, size_t* pUnpriced );
+
+#endif
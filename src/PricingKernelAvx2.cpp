@@ -0,0 +1,112 @@
+#include <cstring>
+
+#include "Types.h"
+#include "PricingKernel.h"
+
+// This file is compiled with AVX2 enabled. Nothing outside of it may call into
+// it unless isPricingKernelSupported has confirmed the processor supports AVX2.
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include "PricingLanes.h"
+
+extern const bool AVX2_KERNEL_BUILT = true;
+
+namespace
+{
+    struct Avx2Lanes
+    {
+        typedef __m256d V;
+        typedef __m256i I;
+
+        static const size_t WIDTH = 4;
+
+        static I loadI( const int64_t* p ) { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ); }
+        static I setI( int64_t value ) { return _mm256_set1_epi64x( value ); }
+        static I andI( I a, I b ) { return _mm256_and_si256( a, b ); }
+        static I addI( I a, I b ) { return _mm256_add_epi64( a, b ); }
+        static void storeI( int64_t* p, I value ) { _mm256_storeu_si256( reinterpret_cast<__m256i*>( p ), value ); }
+
+        static I loadBytes( const uint8_t* p )
+        {
+            int32_t bytes;
+            std::memcpy( &bytes, p, sizeof(bytes) );
+            return _mm256_cvtepu8_epi64( _mm_cvtsi32_si128( bytes ) );
+        }
+
+        static I loadIndexes( const uint32_t* p )
+        {
+            return _mm256_cvtepu32_epi64( _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ) );
+        }
+
+        // lanes outside the mask are not read at all, so they may hold any position
+        static I gatherI( const int64_t* base, I positions, V mask )
+        {
+            return _mm256_mask_i64gather_epi64( _mm256_setzero_si256(), reinterpret_cast<const long long*>( base ),
+                                                positions, _mm256_castpd_si256( mask ), 8 );
+        }
+
+        static I ltI( I a, I b ) { return _mm256_cmpgt_epi64( b, a ); }
+
+        static I inRange( I x )
+        {
+            return _mm256_cmpeq_epi64( _mm256_srli_epi64( x, 52 ), _mm256_setzero_si256() );
+        }
+
+        static I asBits( V mask ) { return _mm256_castpd_si256( mask ); }
+        static V asMask( I mask ) { return _mm256_castsi256_pd( mask ); }
+
+        // placing the integer in the mantissa of 2^52 and subtracting 2^52 gives its exact value
+        static V toDouble( I x )
+        {
+            V biased = _mm256_castsi256_pd( _mm256_or_si256( x, _mm256_set1_epi64x( 0x4330000000000000LL ) ) );
+            return _mm256_sub_pd( biased, _mm256_set1_pd( 4503599627370496.0 ) );
+        }
+
+        static I toInt( V x )
+        {
+            I biased = _mm256_castpd_si256( _mm256_add_pd( x, _mm256_set1_pd( 4503599627370496.0 ) ) );
+            return _mm256_xor_si256( biased, _mm256_set1_epi64x( 0x4330000000000000LL ) );
+        }
+
+        static V set( double value ) { return _mm256_set1_pd( value ); }
+        static V add( V a, V b ) { return _mm256_add_pd( a, b ); }
+        static V sub( V a, V b ) { return _mm256_sub_pd( a, b ); }
+        static V mul( V a, V b ) { return _mm256_mul_pd( a, b ); }
+        static V div( V a, V b ) { return _mm256_div_pd( a, b ); }
+        static V floor( V a ) { return _mm256_floor_pd( a ); }
+        static V min( V a, V b ) { return _mm256_min_pd( a, b ); }
+        static V max( V a, V b ) { return _mm256_max_pd( a, b ); }
+        static V lt( V a, V b ) { return _mm256_cmp_pd( a, b, _CMP_LT_OQ ); }
+        static V le( V a, V b ) { return _mm256_cmp_pd( a, b, _CMP_LE_OQ ); }
+        static V eq( V a, V b ) { return _mm256_cmp_pd( a, b, _CMP_EQ_OQ ); }
+        static V andMask( V a, V mask ) { return _mm256_and_pd( a, mask ); }
+        static V orMask( V a, V b ) { return _mm256_or_pd( a, b ); }
+        static V blend( V a, V b, V mask ) { return _mm256_blendv_pd( a, b, mask ); }
+        static int movemask( V mask ) { return _mm256_movemask_pd( mask ); }
+    };
+}
+
+Money priceLinesAvx2( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced )
+{
+    return priceLinesWith<Avx2Lanes>( items, amounts, totals, count, pUnpriced );
+}
+
+#else
+
+extern const bool AVX2_KERNEL_BUILT = false;
+
+Money priceLinesAvx2( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced )
+{
+    // not built for this target, leave every line for the scalar kernel
+    for(size_t i = 0; i < count; i++)
+    {
+        totals[i] = UNPRICED_LINE;
+    }
+    *pUnpriced = count;
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include <cstring>
+
+#include "Types.h"
+#include "PricingKernel.h"
+
+// This file is compiled with SSE4.2 enabled. Nothing outside of it may call into
+// it unless isPricingKernelSupported has confirmed the processor supports SSE4.2.
+#if defined(__SSE4_2__)
+
+#include <immintrin.h>
+
+#include "PricingLanes.h"
+
+extern const bool SSE42_KERNEL_BUILT = true;
+
+namespace
+{
+    struct Sse42Lanes
+    {
+        typedef __m128d V;
+        typedef __m128i I;
+
+        static const size_t WIDTH = 2;
+
+        static I loadI( const int64_t* p ) { return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) ); }
+        static I setI( int64_t value ) { return _mm_set1_epi64x( value ); }
+        static I andI( I a, I b ) { return _mm_and_si128( a, b ); }
+        static I addI( I a, I b ) { return _mm_add_epi64( a, b ); }
+        static void storeI( int64_t* p, I value ) { _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), value ); }
+
+        static I loadBytes( const uint8_t* p )
+        {
+            uint16_t bytes;
+            std::memcpy( &bytes, p, sizeof(bytes) );
+            return _mm_cvtepu8_epi64( _mm_cvtsi32_si128( bytes ) );
+        }
+
+        static I loadIndexes( const uint32_t* p )
+        {
+            return _mm_cvtepu32_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( p ) ) );
+        }
+
+        // there is no gather instruction, so each lane within the mask is read on its own
+        static I gatherI( const int64_t* base, I positions, V mask )
+        {
+            int lanes = _mm_movemask_pd( mask );
+            int64_t low = (lanes & 1) ? base[_mm_cvtsi128_si64( positions )] : 0;
+            int64_t high = (lanes & 2) ? base[_mm_extract_epi64( positions, 1 )] : 0;
+            return _mm_set_epi64x( high, low );
+        }
+
+        static I ltI( I a, I b ) { return _mm_cmpgt_epi64( b, a ); }
+
+        static I inRange( I x )
+        {
+            return _mm_cmpeq_epi64( _mm_srli_epi64( x, 52 ), _mm_setzero_si128() );
+        }
+
+        static I asBits( V mask ) { return _mm_castpd_si128( mask ); }
+        static V asMask( I mask ) { return _mm_castsi128_pd( mask ); }
+
+        // placing the integer in the mantissa of 2^52 and subtracting 2^52 gives its exact value
+        static V toDouble( I x )
+        {
+            V biased = _mm_castsi128_pd( _mm_or_si128( x, _mm_set1_epi64x( 0x4330000000000000LL ) ) );
+            return _mm_sub_pd( biased, _mm_set1_pd( 4503599627370496.0 ) );
+        }
+
+        static I toInt( V x )
+        {
+            I biased = _mm_castpd_si128( _mm_add_pd( x, _mm_set1_pd( 4503599627370496.0 ) ) );
+            return _mm_xor_si128( biased, _mm_set1_epi64x( 0x4330000000000000LL ) );
+        }
+
+        static V set( double value ) { return _mm_set1_pd( value ); }
+        static V add( V a, V b ) { return _mm_add_pd( a, b ); }
+        static V sub( V a, V b ) { return _mm_sub_pd( a, b ); }
+        static V mul( V a, V b ) { return _mm_mul_pd( a, b ); }
+        static V div( V a, V b ) { return _mm_div_pd( a, b ); }
+        static V floor( V a ) { return _mm_floor_pd( a ); }
+        static V min( V a, V b ) { return _mm_min_pd( a, b ); }
+        static V max( V a, V b ) { return _mm_max_pd( a, b ); }
+        static V lt( V a, V b ) { return _mm_cmplt_pd( a, b ); }
+        static V le( V a, V b ) { return _mm_cmple_pd( a, b ); }
+        static V eq( V a, V b ) { return _mm_cmpeq_pd( a, b ); }
+        static V andMask( V a, V mask ) { return _mm_and_pd( a, mask ); }
+        static V orMask( V a, V b ) { return _mm_or_pd( a, b ); }
+        static V blend( V a, V b, V mask ) { return _mm_blendv_pd( a, b, mask ); }
+        static int movemask( V mask ) { return _mm_movemask_pd( mask ); }
+    };
+}
+
+Money priceLinesSse42( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced )
+{
+    return priceLinesWith<Sse42Lanes>( items, amounts, totals, count, pUnpriced );
+}
+
+#else
+
+extern const bool SSE42_KERNEL_BUILT = false;
+
+Money priceLinesSse42( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count, size_t* pUnpriced )
+{
+    // not built for this target, leave every line for the scalar kernel
+    for(size_t i = 0; i < count; i++)
+    {
+        totals[i] = UNPRICED_LINE;
+    }
+    *pUnpriced = count;
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,259 @@
+#ifndef PRICING_LANES_H
+#define PRICING_LANES_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Types.h"
+#include "Money.h"
+#include "PricingKernel.h"
+
+// Pricing logic shared by the vector kernels. Each kernel file describes its
+// instruction set through a lanes class and instantiates priceLinesWith for it.
+// Everything here has internal linkage so that code compiled for one instruction
+// set can never be picked by the linker in place of another.
+//
+// The lanes class provides
+//   V, I                  vectors of doubles and of 64 bit integers
+//   WIDTH                 number of lanes within each vector
+//   loadI, loadBytes      load 64 bit integers, or bytes widened to 64 bits
+//   loadIndexes           load 32 bit positions widened to 64 bits
+//   gatherI               load the 64 bit integer at a position of each lane within a mask, zero elsewhere
+//   setI, andI, addI, ltI integer helpers
+//   inRange               all ones in lanes where 0 <= x < 2^52
+//   asMask, asBits        reinterpret masks between integer and double vectors
+//   toDouble, toInt       exact conversions for integers within 0 <= x < 2^52
+//   storeI, movemask      store integers, collect the sign bit of each lane
+//   set, add, sub, mul, div, floor, min, max, lt, le, eq, andMask, orMask, blend
+namespace
+{
+    // 2^53, every integer below this value is held exactly by a double
+    const double EXACT_LIMIT = 9007199254740992.0;
+
+    // Reads one field of the discounts of the lanes within the mask from a pool of discounts,
+    // given the position of each lane's discount within the pool
+    template <class L, class P>
+    typename L::I gatherField( const P* pool, size_t offset, typename L::I positions, typename L::V mask )
+    {
+        static_assert( sizeof(P) % sizeof(int64_t) == 0, "discount fields must be 64 bit words" );
+
+        // the gather counts in 64 bit words, so each position is scaled by the words in a discount
+        typename L::I words = positions;
+        for(size_t i = 1; i < sizeof(P) / sizeof(int64_t); i++)
+        {
+            words = L::addI( words, positions );
+        }
+
+        return L::gatherI( reinterpret_cast<const int64_t*>( pool ) + offset / sizeof(int64_t), words, mask );
+    }
+
+    // Divides whole numbers held as doubles, giving the exact floor of the quotient along
+    // with the remainder. The rounded division can land one away from the true floor
+    // when the quotient is just below a whole number, so the result is corrected using
+    // the remainder, which is computed exactly.
+    template <class L>
+    typename L::V floorDivide( typename L::V n, typename L::V d, typename L::V* pRemainder )
+    {
+        typedef typename L::V V;
+        const V zero = L::set( 0.0 );
+        const V one = L::set( 1.0 );
+
+        V q = L::floor( L::div( n, d ) );
+        V r = L::sub( n, L::mul( q, d ) );
+
+        V low = L::lt( r, zero );
+        q = L::blend( q, L::sub( q, one ), low );
+        r = L::blend( r, L::add( r, d ), low );
+
+        V high = L::le( d, r );
+        q = L::blend( q, L::add( q, one ), high );
+        r = L::blend( r, L::sub( r, d ), high );
+
+        *pRemainder = r;
+        return q;
+    }
+
+    // Divides whole numbers held as doubles, rounding half away from zero the same way as scaleMoney
+    template <class L>
+    typename L::V roundDivide( typename L::V n, typename L::V d )
+    {
+        typename L::V r;
+        typename L::V q = floorDivide<L>( n, d, &r );
+
+        return L::blend( q, L::add( q, L::set( 1.0 ) ), L::le( d, L::add( r, r ) ) );
+    }
+
+    template <class L>
+    Money priceLinesWith( const PricingColumns& items, const Quantity* amounts, Money* totals, size_t count,
+                          size_t* pUnpriced )
+    {
+        typedef typename L::V V;
+        typedef typename L::I I;
+
+        const V zero = L::set( 0.0 );
+        const V one = L::set( 1.0 );
+        const V exact_limit = L::set( EXACT_LIMIT );
+        const V flat_type = L::set( X_FOR_FLAT );
+        const V buy_type = L::set( BUY_X_GET_Y_FOR_Z_LIMIT_W );
+        const V rate_scale = L::set( static_cast<double>( RATE_SCALE ) );
+        const V units = L::set( static_cast<double>( items.units ) );
+        const V rate_units = L::set( static_cast<double>( items.units * RATE_SCALE ) );
+        const I no_limit = L::setI( NO_LIMIT );
+        const bool whole_units = (items.units == 1);
+        const int all_lanes = (1 << L::WIDTH) - 1;
+
+        I sums = L::setI( 0 );
+
+        Money total = 0;
+        size_t unpriced = 0;
+        size_t i = 0;
+
+        for(; i + L::WIDTH <= count; i += L::WIDTH)
+        {
+            I amount_bits = L::loadI( amounts + i );
+            I net_bits = L::loadI( items.net_price + i );
+
+            V amount = L::toDouble( amount_bits );
+            V net = L::toDouble( net_bits );
+            V type = L::toDouble( L::loadBytes( items.discount_type + i ) );
+
+            // every input must convert to a double exactly, and stacked discounts are left for the scalar kernel
+            I in_range = L::andI( L::inRange( amount_bits ), L::inRange( net_bits ) );
+            in_range = L::andI( in_range, L::asBits( L::le( type, buy_type ) ) );
+
+            V is_flat = L::eq( type, flat_type );
+            V is_buy = L::eq( type, buy_type );
+
+            V bundles = zero;
+            V flat_total = zero;
+            V discounted = zero;
+            V percent_product = zero;
+            V percent_total = zero;
+            V x = zero;
+
+            // most groups of lines carry no discount at all, so the discount configuration
+            // is only read when at least one of the lines needs it
+            int flat_lanes = L::movemask( is_flat );
+            int buy_lanes = L::movemask( is_buy );
+            if(flat_lanes | buy_lanes)
+            {
+                // each discount is gathered from the pool for its type, lanes of another type read zero
+                I positions = L::loadIndexes( items.discount_index + i );
+                I x_bits = L::setI( 0 );
+                I y_bits = L::setI( 0 );
+                I limit_bits = L::setI( 0 );
+                I rate_bits = L::setI( 0 );
+                I flat_bits = L::setI( 0 );
+
+                if(flat_lanes)
+                {
+                    const BundleDiscount* pool = items.bundles;
+                    x_bits = gatherField<L>( pool, offsetof(BundleDiscount, size), positions, is_flat );
+                    limit_bits = gatherField<L>( pool, offsetof(BundleDiscount, limit), positions, is_flat );
+                    flat_bits = gatherField<L>( pool, offsetof(BundleDiscount, bundle_price), positions, is_flat );
+                }
+
+                if(buy_lanes)
+                {
+                    const BuyXGetYDiscount* pool = items.buy_x_get_y;
+                    x_bits = L::addI( x_bits, gatherField<L>( pool, offsetof(BuyXGetYDiscount, buy), positions, is_buy ) );
+                    y_bits = gatherField<L>( pool, offsetof(BuyXGetYDiscount, get), positions, is_buy );
+                    limit_bits = L::addI( limit_bits, gatherField<L>( pool, offsetof(BuyXGetYDiscount, limit), positions, is_buy ) );
+                    rate_bits = gatherField<L>( pool, offsetof(BuyXGetYDiscount, rate), positions, is_buy );
+                }
+
+                // a discount without a limit is treated as a limit of zero that is not applied, which keeps
+                // every limit within the range that converts exactly
+                I limited_bits = L::ltI( limit_bits, no_limit );
+                limit_bits = L::andI( limit_bits, limited_bits );
+
+                in_range = L::andI( in_range, L::andI( L::inRange( x_bits ), L::inRange( limit_bits ) ) );
+                x = L::toDouble( x_bits );
+
+                V limit = L::toDouble( limit_bits );
+                V remainder;
+
+                if(flat_lanes)
+                {
+                    in_range = L::andI( in_range, L::inRange( flat_bits ) );
+
+                    // complete bundles sold at the flat price, capped by the limit when one is set. Lanes
+                    // without this discount divide by one and then have their bundles cleared.
+                    is_flat = L::andMask( is_flat, L::lt( zero, x ) );
+                    V bundle = L::blend( one, x, is_flat );
+                    bundles = floorDivide<L>( amount, bundle, &remainder );
+                    V limit_bundles = floorDivide<L>( limit, bundle, &remainder );
+                    bundles = L::blend( bundles, L::min( bundles, limit_bundles ), L::lt( zero, limit ) );
+                    bundles = L::andMask( bundles, is_flat );
+                    flat_total = L::mul( bundles, L::toDouble( flat_bits ) );
+                }
+
+                if(buy_lanes)
+                {
+                    in_range = L::andI( in_range, L::andI( L::inRange( y_bits ), L::inRange( rate_bits ) ) );
+
+                    V y = L::toDouble( y_bits );
+                    V rate = L::toDouble( rate_bits );
+                    V limited = L::asMask( limited_bits );
+
+                    // items earned at a percentage off by complete and partial cycles
+                    V cycle = L::add( x, y );
+                    is_buy = L::andMask( is_buy, L::lt( zero, cycle ) );
+                    V eligible = L::blend( amount, limit, L::andMask( limited, L::lt( limit, amount ) ) );
+                    V cycles = floorDivide<L>( eligible, L::blend( one, cycle, is_buy ), &remainder );
+                    V partial = L::sub( L::sub( eligible, L::mul( cycles, cycle ) ), x );
+                    discounted = L::andMask( L::add( L::mul( cycles, y ), L::max( partial, zero ) ), is_buy );
+                    percent_product = L::mul( L::mul( net, discounted ), L::sub( rate_scale, rate ) );
+                    percent_total = roundDivide<L>( percent_product, rate_units );
+                }
+            }
+
+            // everything else is sold at the marked down price, whole items need no rounding
+            V remain = L::sub( L::sub( amount, L::mul( bundles, x ) ), discounted );
+            V full_product = L::mul( net, remain );
+            V full_total = whole_units ? full_product : roundDivide<L>( full_product, units );
+
+            V line = L::add( L::add( flat_total, percent_total ), full_total );
+
+            // a product that reached 2^53 may have been rounded, those lines are left for the scalar kernel
+            V largest = L::max( L::max( flat_total, percent_product ), L::max( full_product, line ) );
+            V exact = L::andMask( L::asMask( in_range ), L::lt( largest, exact_limit ) );
+            I line_bits = L::toInt( line );
+
+            L::storeI( totals + i, line_bits );
+            sums = L::addI( sums, L::andI( line_bits, L::asBits( exact ) ) );
+
+            int priced = L::movemask( exact );
+            if(priced != all_lanes)
+            {
+                for(size_t lane = 0; lane < L::WIDTH; lane++)
+                {
+                    if(!(priced & (1 << lane)))
+                    {
+                        totals[i + lane] = UNPRICED_LINE;
+                        unpriced++;
+                    }
+                }
+            }
+        }
+
+        int64_t lanes[L::WIDTH];
+        L::storeI( lanes, sums );
+        for(size_t lane = 0; lane < L::WIDTH; lane++)
+        {
+            total += lanes[lane];
+        }
+
+        // lines that do not fill a whole vector are left for the scalar kernel
+        for(; i < count; i++)
+        {
+            totals[i] = UNPRICED_LINE;
+            unpriced++;
+        }
+
+        *pUnpriced = unpriced;
+        return total;
+    }
+}
+
+#endif
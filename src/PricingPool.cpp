@@ -0,0 +1,185 @@
+#include <thread>
+
+#include "Types.h"
+#include "PricingPool.h"
+
+// Pool and worker that the current thread belongs to, so tasks queued by a task stay with its worker
+static thread_local const PricingPool* current_pool = 0;
+static thread_local size_t current_worker = 0;
+
+PricingPool::PricingPool( const StoreEngine& engine, unsigned count ) : next_worker( 0 ), stolen( 0 )
+{
+    queued = 0;
+    outstanding = 0;
+    stopping = false;
+
+    if(count < 1)
+    {
+        count = std::thread::hardware_concurrency();
+    }
+    if(count < 1)
+    {
+        count = 1;
+    }
+
+    // every worker exists before any of them starts, since any of them may be stolen from
+    for(unsigned i = 0; i < count; i++)
+    {
+        workers.emplace_back( new Worker() );
+        workers.back()->lane = engine.openLane();
+    }
+
+    for(unsigned i = 0; i < count; i++)
+    {
+        workers[i]->thread = std::thread( &PricingPool::run, this, i );
+    }
+}
+
+PricingPool::~PricingPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock( idle_lock );
+        stopping = true;
+    }
+    idle.notify_all();
+
+    for(std::unique_ptr<Worker>& worker : workers)
+    {
+        worker->thread.join();
+    }
+}
+
+void PricingPool::submit( PricingTask task, TaskPriority_t priority )
+{
+    size_t index = (current_pool == this) ? current_worker : next_worker++ % workers.size();
+
+    // The task is counted before it can be taken. Otherwise a worker could take and finish it first, taking
+    // the counts below what is really queued and outstanding, and letting wait return while tasks still run.
+    {
+        std::lock_guard<std::mutex> lock( idle_lock );
+        queued++;
+        outstanding++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( workers[index]->lock );
+        workers[index]->queues[priority].push_back( std::move( task ) );
+    }
+    idle.notify_one();
+}
+
+void PricingPool::submitCart( const ScanRecord* records, size_t count, ReturnCode_t* codes, Money* pTotal,
+                              TaskPriority_t priority )
+{
+    submit( [records, count, codes, pTotal]( Lane& lane )
+    {
+        lane.addToCartBatch( records, count, codes );
+        *pTotal = lane.getPreTaxTotalMoney();
+    }, priority );
+}
+
+void PricingPool::wait()
+{
+    std::unique_lock<std::mutex> lock( idle_lock );
+    finished.wait( lock, [this]() { return outstanding == 0; } );
+}
+
+size_t PricingPool::getWorkerCount() const
+{
+    return workers.size();
+}
+
+size_t PricingPool::getStolenCount() const
+{
+    return stolen.load();
+}
+
+void PricingPool::run( size_t index )
+{
+    current_pool = this;
+    current_worker = index;
+
+    Lane& lane = *workers[index]->lane;
+    PricingTask task;
+
+    while(true)
+    {
+        if(takeTask( index, &task ))
+        {
+            // the customer is ended once the task is done, so a waiting worker holds no catalog version
+            task( lane );
+            lane.newTransaction();
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock( idle_lock );
+            if(--outstanding == 0)
+            {
+                finished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( idle_lock );
+        idle.wait( lock, [this]() { return queued > 0 || stopping; } );
+        if(stopping && queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool PricingPool::takeTask( size_t index, PricingTask* pTask )
+{
+    static const TaskPriority_t PRIORITIES[2] = { INTERACTIVE_PRIORITY, BATCH_PRIORITY };
+    bool found = false;
+
+    // every queue is searched for interactive work before any batch work is taken. Interactive work is
+    // taken oldest first so that none of it waits behind later arrivals, while a worker's own batch work
+    // is taken newest first so that tasks split from a job run while its data is still in the cache.
+    for(size_t p = 0; p < 2 && !found; p++)
+    {
+        found = popTask( *workers[index], PRIORITIES[p], PRIORITIES[p] == BATCH_PRIORITY, pTask );
+        for(size_t i = 1; i < workers.size() && !found; i++)
+        {
+            found = popTask( *workers[(index + i) % workers.size()], PRIORITIES[p], false, pTask );
+            if(found)
+            {
+                stolen++;
+            }
+        }
+    }
+
+    if(found)
+    {
+        std::lock_guard<std::mutex> lock( idle_lock );
+        queued--;
+    }
+
+    return found;
+}
+
+bool PricingPool::popTask( Worker& worker, TaskPriority_t priority, bool newest, PricingTask* pTask )
+{
+    std::lock_guard<std::mutex> lock( worker.lock );
+    std::deque<PricingTask>& queue = worker.queues[priority];
+
+    if(queue.empty())
+    {
+        return false;
+    }
+
+    if(newest)
+    {
+        *pTask = std::move( queue.back() );
+        queue.pop_back();
+    }
+    else
+    {
+        *pTask = std::move( queue.front() );
+        queue.pop_front();
+    }
+
+    return true;
+}
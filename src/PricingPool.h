@@ -0,0 +1,121 @@
+#ifndef PRICING_POOL_H
+#define PRICING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Types.h"
+#include "Money.h"
+#include "Cart.h"
+#include "StoreEngine.h"
+
+/// \enum TaskPriority_t
+/// \brief Describes how urgently a task given to a PricingPool must be run
+typedef enum
+{
+    INTERACTIVE_PRIORITY,       ///< Someone is waiting on the result, such as a lane or an online order
+    BATCH_PRIORITY,             ///< Background work, such as repricing, run whenever no interactive work is queued
+} TaskPriority_t;
+
+/// \brief Work run by a PricingPool, given the lane of the worker running it
+typedef std::function<void( Lane& )> PricingTask;
+
+/// \class PricingPool
+/// \brief Work stealing thread pool that prices carts against the catalog of a StoreEngine
+///
+/// Every worker thread owns a lane opened from the engine, and a queue for each priority. A task given to the
+/// pool from outside is placed on the queues of the workers in turn, while a task given by a task that is
+/// already running stays with the worker running it. A worker takes interactive tasks from its own queue
+/// oldest first, and batch tasks newest first so that work split from a job stays on the same core. Once
+/// its own queue is empty it steals the oldest task from the other workers.
+///
+/// Interactive tasks always come first: a worker only takes a batch task once there are no interactive
+/// tasks left in its own queue or any other queue. A task is never interrupted once it has started, so the
+/// delay seen by an interactive task is at most the length of one batch task on each worker.
+///
+/// Each task is started on a new transaction of the worker's lane, so it is priced against the latest
+/// version of the catalog and sees none of the items scanned by the task before it.
+class PricingPool
+{
+    public:
+
+        /// \brief Starts the workers of the pool
+        ///
+        /// \param engine Source of the catalog used by every worker, the lanes of the pool may outlive it
+        /// \param count Number of worker threads, values below 1 are treated as the number of processors
+        PricingPool( const StoreEngine& engine, unsigned count = 0 );
+
+        /// \brief Runs every task that has been queued and stops the workers
+        ~PricingPool();
+
+        /// \brief Queues a task to be run by one of the workers
+        ///
+        /// \param task Work to run, given the lane of the worker running it
+        /// \param priority Whether the task is interactive or batch work
+        void submit( PricingTask task, TaskPriority_t priority );
+
+        /// \brief Queues a whole cart of scans to be priced
+        ///
+        /// The records, codes and total must remain valid until the cart has been priced, which is known
+        /// once wait returns.
+        ///
+        /// \param records The scans of the cart, as with Cart::addToCartBatch
+        /// \param count Number of records
+        /// \param codes Location that the result of each record is stored, must hold count entries
+        /// \param pTotal Location that the pre-tax total of the cart is stored
+        /// \param priority Whether the cart is interactive or batch work
+        void submitCart( const ScanRecord* records, size_t count, ReturnCode_t* codes, Money* pTotal,
+                         TaskPriority_t priority );
+
+        /// \brief Waits until every task queued so far, and every task they queued, has been run
+        ///
+        /// Must not be called from within a task.
+        void wait();
+
+        /// \brief Provides the number of worker threads
+        size_t getWorkerCount() const;
+
+        /// \brief Provides the number of tasks that were run by a worker other than the one they were queued with
+        size_t getStolenCount() const;
+
+    private:
+
+        /// \brief Queues and lane of a single worker thread
+        struct Worker
+        {
+            std::mutex lock;                    // guards both queues
+            std::deque<PricingTask> queues[2];  // tasks waiting to run, by priority
+            std::unique_ptr<Lane> lane;         // lane every task of the worker is priced on
+            std::thread thread;
+        };
+
+        /// \brief Runs tasks on a worker until the pool stops
+        void run( size_t index );
+
+        /// \brief Takes the next task for a worker, from its own queues or from another worker
+        bool takeTask( size_t index, PricingTask* pTask );
+
+        /// \brief Takes a task of one priority from a worker, either the newest or the oldest
+        bool popTask( Worker& worker, TaskPriority_t priority, bool newest, PricingTask* pTask );
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<size_t> next_worker;   // worker given the next task queued from outside the pool
+        std::atomic<size_t> stolen;        // tasks taken from another worker
+
+        std::mutex idle_lock;              // guards the counts below and stopping
+        std::condition_variable idle;      // signalled when a task is queued or the pool stops
+        std::condition_variable finished;  // signalled when the last outstanding task completes
+        size_t queued;                     // tasks sitting in a queue, counted just before they are placed there
+        size_t outstanding;                // tasks queued or running
+        bool stopping;
+
+};
+
+#endif
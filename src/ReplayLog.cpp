@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <string_view>
+#include <thread>
+
+#include "Types.h"
+#include "ReplayLog.h"
+
+// Name of every event, in the order of ReplayOp_t
+static const char* EVENT_NAMES[REPLAY_OP_COUNT] = { "setItemPrice", "setPerPoundPrice", "setMarkdown", "addToCart",
+                                                    "removeFromCart", "getPreTaxTotal", "newTransaction" };
+
+// Waits shorter than this are spun rather than slept, as sleeping overshoots by about this much
+static const std::chrono::microseconds SPIN_LIMIT( 100 );
+
+static std::string_view trim( std::string_view field )
+{
+    while(field.length() > 0 && field.front() == ' ')
+    {
+        field.remove_prefix( 1 );
+    }
+
+    while(field.length() > 0 && (field.back() == ' ' || field.back() == '\r'))
+    {
+        field.remove_suffix( 1 );
+    }
+
+    return field;
+}
+
+// Converts the whole of a field, rejecting anything that is not a finite number
+static bool parseValue( std::string_view field, double* pValue )
+{
+    const char* end = field.data() + field.length();
+    std::from_chars_result result = std::from_chars( field.data(), end, *pValue );
+
+    return field.length() > 0 && result.ec == std::errc() && result.ptr == end && std::isfinite( *pValue );
+}
+
+// Money unit matching the number of decimal places a total was written with
+static Money totalUnit( std::string_view field )
+{
+    size_t point = field.find( '.' );
+    size_t places = (point == std::string_view::npos) ? 0 : field.length() - point - 1;
+
+    Money unit = toMoney( 1.0 );
+    for(size_t i = 0; i < places && unit > 1; i++)
+    {
+        unit /= 10;
+    }
+    return unit;
+}
+
+// Rounds half away from zero to a whole number of units
+static Money roundTo( Money amount, Money unit )
+{
+    Money half = unit / 2;
+    Money units = (amount >= 0) ? (amount + half) / unit : (amount - half) / unit;
+    return units * unit;
+}
+
+static double percentile( const std::vector<uint64_t>& sorted, double fraction )
+{
+    if(sorted.empty())
+    {
+        return 0;
+    }
+
+    size_t index = static_cast<size_t>( std::ceil( fraction * sorted.size() ) );
+    return static_cast<double>( sorted[std::min( sorted.size(), std::max<size_t>( index, 1 ) ) - 1] );
+}
+
+ReplayLog::ReplayLog()
+{
+
+}
+
+ReplayLog::~ReplayLog()
+{
+
+}
+
+ReturnCode_t ReplayLog::loadFile( const std::string& path, size_t* pLine )
+{
+    std::ifstream file( path, std::ios::binary );
+    if(!file)
+    {
+        return INVALID_ARG;
+    }
+
+    return loadStream( file, pLine );
+}
+
+ReturnCode_t ReplayLog::loadStream( std::istream& input, size_t* pLine )
+{
+    std::string text;
+    size_t line = 0;
+
+    events.clear();
+    while(std::getline( input, text ))
+    {
+        line++;
+
+        std::string_view row = trim( text );
+        if(row.length() == 0 || row.front() == '#')
+        {
+            continue;
+        }
+
+        std::string_view fields[4];
+        size_t count = 0;
+        size_t comma = 0;
+        while(count < 4 && comma != std::string_view::npos)
+        {
+            comma = row.find( ',' );
+            fields[count++] = trim( row.substr( 0, comma ) );
+            row.remove_prefix( (comma == std::string_view::npos) ? row.length() : comma + 1 );
+        }
+
+        Event event = { 0, REPLAY_NEW_TRANSACTION, std::string(), 0, false, false, 1, line };
+        double time = 0;
+        size_t op = REPLAY_OP_COUNT;
+
+        // paced replays wait for each event relative to the first, so times may never go backwards
+        double earliest = events.empty() ? 0 : static_cast<double>( events.back().time );
+        if(count >= 2 && parseValue( fields[0], &time ) && time >= earliest && time < 18446744073709551616.0)
+        {
+            op = std::find( EVENT_NAMES, EVENT_NAMES + REPLAY_OP_COUNT, fields[1] ) - EVENT_NAMES;
+        }
+
+        event.time = static_cast<uint64_t>( time );
+        event.op = static_cast<ReplayOp_t>( op );
+        bool valid = op < REPLAY_OP_COUNT && comma == std::string_view::npos;
+
+        if(valid && event.op == REPLAY_GET_PRE_TAX_TOTAL)
+        {
+            event.checked = count == 4 && fields[3].length() > 0;
+            valid = !event.checked || parseValue( fields[3], &event.value );
+            event.unit = event.checked ? totalUnit( fields[3] ) : 1;
+        }
+        else if(valid && event.op != REPLAY_NEW_TRANSACTION)
+        {
+            valid = count == 4 && fields[2].length() > 0 && parseValue( fields[3], &event.value );
+            event.sku = fields[2];
+            event.weight = fields[3].find( '.' ) != std::string_view::npos;
+        }
+
+        // amounts of fixed price items must be whole numbers that an int is able to hold
+        if(valid && (event.op == REPLAY_ADD_TO_CART || event.op == REPLAY_REMOVE_FROM_CART) && !event.weight &&
+           (std::fabs( event.value ) > 2147483647.0 || event.value != std::floor( event.value )))
+        {
+            valid = false;
+        }
+
+        if(!valid)
+        {
+            if(pLine != 0)
+            {
+                *pLine = line;
+            }
+            events.clear();
+            return ERROR;
+        }
+
+        events.push_back( event );
+    }
+
+    return OK;
+}
+
+size_t ReplayLog::size() const
+{
+    return events.size();
+}
+
+const char* ReplayLog::getEventName( ReplayOp_t op )
+{
+    return (op < REPLAY_OP_COUNT) ? EVENT_NAMES[op] : "";
+}
+
+ReturnCode_t ReplayLog::apply( PointOfSale& sale, const Event& event, Money* pTotal )
+{
+    switch(event.op)
+    {
+        case REPLAY_SET_ITEM_PRICE:
+            return sale.setItemPrice( event.sku, event.value );
+        case REPLAY_SET_PER_POUND_PRICE:
+            return sale.setPerPoundPrice( event.sku, event.value );
+        case REPLAY_SET_MARKDOWN:
+            return sale.setMarkdown( event.sku, event.value );
+        case REPLAY_ADD_TO_CART:
+            if(event.weight)
+            {
+                return sale.addToCart( event.sku, event.value );
+            }
+            return sale.addToCart( event.sku, static_cast<int>( event.value ) );
+        case REPLAY_REMOVE_FROM_CART:
+            if(event.weight)
+            {
+                return sale.removeFromCart( event.sku, event.value );
+            }
+            return sale.removeFromCart( event.sku, static_cast<int>( event.value ) );
+        case REPLAY_GET_PRE_TAX_TOTAL:
+            *pTotal = sale.getPreTaxTotalMoney();
+            return OK;
+        case REPLAY_NEW_TRANSACTION:
+            return sale.newTransaction();
+        default:
+            return ERROR;
+    }
+}
+
+void ReplayLog::replay( PointOfSale& sale, bool paced, ReplayReport* pReport ) const
+{
+    std::vector<uint64_t> latencies( events.size() );
+    std::vector<Money> totals( events.size(), 0 );
+    std::vector<ReturnCode_t> codes( events.size() );
+
+    pReport->events = events.size();
+    pReport->totals_checked = 0;
+    pReport->mismatches.clear();
+    pReport->calls_failed = 0;
+    std::fill( pReport->failed, pReport->failed + REPLAY_OP_COUNT, 0 );
+
+    // the totals and codes are only checked once the replay is over, so the comparison is not part of the timings
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        if(paced)
+        {
+            // recordings need not start from zero, so the first event is due straight away
+            std::chrono::steady_clock::time_point due = start + std::chrono::microseconds( events[i].time - events[0].time );
+            if(due - std::chrono::steady_clock::now() > SPIN_LIMIT)
+            {
+                std::this_thread::sleep_until( due - SPIN_LIMIT );
+            }
+            while(std::chrono::steady_clock::now() < due)
+            {
+
+            }
+        }
+
+        std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+        codes[i] = apply( sale, events[i], &totals[i] );
+        std::chrono::steady_clock::time_point after = std::chrono::steady_clock::now();
+
+        latencies[i] = static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( after - before ).count() );
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for(size_t i = 0; i < events.size(); i++)
+    {
+        if(codes[i] != OK)
+        {
+            pReport->calls_failed++;
+            pReport->failed[events[i].op]++;
+        }
+
+        if(events[i].checked)
+        {
+            Money expected = toMoney( events[i].value );
+            Money actual = roundTo( totals[i], events[i].unit );
+
+            pReport->totals_checked++;
+            if(actual != expected)
+            {
+                pReport->mismatches.push_back( { events[i].line, expected, actual } );
+            }
+        }
+    }
+
+    std::sort( latencies.begin(), latencies.end() );
+    pReport->seconds = elapsed.count();
+    pReport->events_per_second = (elapsed.count() > 0) ? events.size() / elapsed.count() : 0;
+    pReport->latency_p50 = percentile( latencies, 0.50 );
+    pReport->latency_p90 = percentile( latencies, 0.90 );
+    pReport->latency_p99 = percentile( latencies, 0.99 );
+    pReport->latency_p999 = percentile( latencies, 0.999 );
+    pReport->latency_max = latencies.empty() ? 0 : static_cast<double>( latencies.back() );
+}
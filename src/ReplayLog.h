@@ -0,0 +1,132 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "Money.h"
+#include "PointOfSale.h"
+
+/// \enum ReplayOp_t
+/// \brief Describes the PointOfSale call made by an event of a recorded log
+typedef enum
+{
+    REPLAY_SET_ITEM_PRICE,      ///< PointOfSale::setItemPrice
+    REPLAY_SET_PER_POUND_PRICE, ///< PointOfSale::setPerPoundPrice
+    REPLAY_SET_MARKDOWN,        ///< PointOfSale::setMarkdown
+    REPLAY_ADD_TO_CART,         ///< PointOfSale::addToCart
+    REPLAY_REMOVE_FROM_CART,    ///< PointOfSale::removeFromCart
+    REPLAY_GET_PRE_TAX_TOTAL,   ///< PointOfSale::getPreTaxTotal, checked against the recorded total when one is given
+    REPLAY_NEW_TRANSACTION,     ///< PointOfSale::newTransaction
+    REPLAY_OP_COUNT,            ///< Number of kinds of event, not an event itself
+} ReplayOp_t;
+
+/// \struct ReplayMismatch
+/// \brief Identifies a total that came out differently from the one recorded
+struct ReplayMismatch
+{
+    size_t line;        ///< Line of the log holding the event, starting from 1
+    Money expected;     ///< Total recorded in the log
+    Money actual;       ///< Total given by the library, rounded the same way as the recorded total
+};
+
+/// \struct ReplayReport
+/// \brief Summarizes a replay of a recorded log
+struct ReplayReport
+{
+    size_t events;                          ///< Number of events replayed
+    size_t totals_checked;                  ///< Number of totals compared against the log
+    std::vector<ReplayMismatch> mismatches; ///< Every total that did not match, in log order
+    size_t calls_failed;                    ///< Number of calls that returned anything other than OK
+    size_t failed[REPLAY_OP_COUNT];         ///< Calls of each kind that did not return OK, indexed by ReplayOp_t
+    double seconds;                         ///< Time taken by the whole replay
+    double events_per_second;               ///< Events replayed per second
+    double latency_p50;                     ///< Median time taken by a single event, in nanoseconds
+    double latency_p90;                     ///< 90th percentile of the time taken by an event, in nanoseconds
+    double latency_p99;                     ///< 99th percentile of the time taken by an event, in nanoseconds
+    double latency_p999;                    ///< 99.9th percentile of the time taken by an event, in nanoseconds
+    double latency_max;                     ///< Longest time taken by an event, in nanoseconds
+};
+
+/// \class ReplayLog
+/// \brief Recorded sequence of PointOfSale calls that can be replayed against the library
+///
+/// Each line of a log records one call:
+///
+///     time_us,event,sku,value
+///
+/// The time is when the call was made, in microseconds from the start of the recording, and never goes back
+/// from one event to the next. The event is the name of the call: setItemPrice, setPerPoundPrice, setMarkdown,
+/// addToCart, removeFromCart, getPreTaxTotal or newTransaction. The value is the price, markdown or amount given
+/// to the call. An amount written with a decimal point is a weight in pounds and one without is a count of items,
+/// just as the double and int variants of addToCart are chosen in code, so a whole number of pounds must be
+/// written as 2.0 rather than 2. For getPreTaxTotal the value is the total the call returned, which is
+/// compared at the number of decimal places it was written with, and may be left out. The sku and value are
+/// left out where the call takes none. Blank lines and lines starting with '#' are skipped.
+///
+/// The whole log is read into memory before it is replayed, so reading the file has no effect on the timings.
+class ReplayLog
+{
+    public:
+
+        ReplayLog();
+        ~ReplayLog();
+
+        /// \brief Reads a log from a file, replacing any events already read
+        ///
+        /// \param path Location of the log
+        /// \param pLine Location that the line of the first malformed event is stored, may be null
+        /// \return OK, INVALID_ARG when the file cannot be opened, or ERROR when an event is malformed or recorded
+        ///         earlier than the event before it
+        ReturnCode_t loadFile( const std::string& path, size_t* pLine );
+
+        /// \brief Reads a log from a stream, replacing any events already read
+        ///
+        /// \param input Stream holding the log
+        /// \param pLine Location that the line of the first malformed event is stored, may be null
+        /// \return OK, or ERROR when an event is malformed or recorded earlier than the event before it
+        ReturnCode_t loadStream( std::istream& input, size_t* pLine );
+
+        /// \brief Provides the number of events in the log
+        size_t size() const;
+
+        /// \brief Makes every call of the log against a PointOfSale
+        ///
+        /// Calls that return anything other than OK, such as scans of unknown SKUs or rejected prices, are counted
+        /// in the report rather than stopping the replay.
+        ///
+        /// \param sale The PointOfSale receiving the calls, normally newly created
+        /// \param paced Whether to wait until each event is due rather than replaying as fast as possible
+        /// \param pReport Location that the outcome of the replay is stored
+        void replay( PointOfSale& sale, bool paced, ReplayReport* pReport ) const;
+
+        /// \brief Provides the name a kind of event is written with in a log
+        static const char* getEventName( ReplayOp_t op );
+
+    private:
+
+        /// \brief One recorded call
+        struct Event
+        {
+            uint64_t time;      // microseconds from the start of the recording
+            ReplayOp_t op;
+            std::string sku;
+            double value;       // price, markdown, amount or recorded total
+            bool weight;        // whether the amount is a weight rather than a count
+            bool checked;       // whether a recorded total was given
+            Money unit;         // precision the recorded total was written with
+            size_t line;
+        };
+
+        /// \brief Makes the call of one event, storing the total given by getPreTaxTotal
+        static ReturnCode_t apply( PointOfSale& sale, const Event& event, Money* pTotal );
+
+        std::vector<Event> events;
+
+};
+
+#endif
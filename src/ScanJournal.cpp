@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Types.h"
+#include "ScanJournal.h"
+
+// Version 1 is the header below followed by entries, each an EntryHeader and the characters of its SKU
+static const char JOURNAL_MAGIC[8] = { 'P', 'O', 'S', 'J', 'R', 'N', 'L', 0 };
+static const uint32_t JOURNAL_VERSION = 1;
+
+// Size the buffer may reach before it is written without waiting for the end of the window
+static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+struct JournalHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;  // size of an EntryHeader, which differs between ABIs
+};
+
+struct EntryHeader
+{
+    uint32_t checksum;    // of everything after this field, including the SKU
+    uint8_t op;
+    uint8_t type;
+    uint16_t sku_length;
+    SkuHandle handle;
+    double amount;
+};
+
+const std::chrono::microseconds ScanJournal::DEFAULT_WINDOW( 2000 );
+
+// FNV-1a, continued from the given hash
+static uint32_t checksum( const char* data, size_t length, uint32_t hash )
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ static_cast<uint8_t>( data[i] )) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t checksumEntry( const EntryHeader& header, const char* sku )
+{
+    const char* fields = reinterpret_cast<const char*>( &header ) + sizeof(header.checksum);
+    uint32_t hash = checksum( fields, sizeof(EntryHeader) - sizeof(header.checksum), 2166136261u );
+    return checksum( sku, header.sku_length, hash );
+}
+
+// Writes all of the data, carrying on after partial writes
+static bool writeAll( int descriptor, const char* data, size_t length )
+{
+    while(length > 0)
+    {
+        ssize_t written = ::write( descriptor, data, length );
+        if(written < 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>( written );
+    }
+    return true;
+}
+
+ScanJournal::ScanJournal() : descriptor( -1 ), window( DEFAULT_WINDOW )
+{
+    appended = 0;
+    durable = 0;
+    truncate = false;
+    requested = false;
+    stopping = false;
+    failed = false;
+    sync_count = 0;
+}
+
+ScanJournal::~ScanJournal()
+{
+    if(flusher.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard( lock );
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+    }
+
+    if(descriptor >= 0)
+    {
+        close( descriptor );
+    }
+}
+
+ReturnCode_t ScanJournal::open( const std::string& path, std::chrono::microseconds window, std::vector<JournalEntry>* pEntries )
+{
+    if(descriptor >= 0)
+    {
+        return ERROR;
+    }
+
+    descriptor = ::open( path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    if(descriptor < 0)
+    {
+        return INVALID_ARG;
+    }
+
+    ReturnCode_t code = readEntries( pEntries );
+    if(code != OK)
+    {
+        close( descriptor );
+        descriptor = -1;
+        return code;
+    }
+
+    this->window = window;
+    flusher = std::thread( &ScanJournal::flushLoop, this );
+    return OK;
+}
+
+ReturnCode_t ScanJournal::readEntries( std::vector<JournalEntry>* pEntries )
+{
+    struct stat status;
+    if(fstat( descriptor, &status ) != 0)
+    {
+        return ERROR;
+    }
+
+    std::vector<char> contents( static_cast<size_t>( status.st_size ) );
+    if(pread( descriptor, contents.data(), contents.size(), 0 ) != static_cast<ssize_t>( contents.size() ))
+    {
+        return ERROR;
+    }
+
+    JournalHeader header;
+    std::memset( &header, 0, sizeof(header) );
+    std::memcpy( header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC) );
+    header.version = JOURNAL_VERSION;
+    header.entry_size = sizeof(EntryHeader);
+
+    // a new file, or one that stopped before its header was complete, is started from scratch
+    if(contents.size() < sizeof(JournalHeader))
+    {
+        if(!std::equal( contents.begin(), contents.end(), reinterpret_cast<const char*>( &header ) ))
+        {
+            return ERROR;
+        }
+        if(ftruncate( descriptor, 0 ) != 0 || !writeAll( descriptor, reinterpret_cast<const char*>( &header ), sizeof(header) ) ||
+           fdatasync( descriptor ) != 0)
+        {
+            return ERROR;
+        }
+        return OK;
+    }
+
+    if(std::memcmp( contents.data(), &header, sizeof(header) ) != 0)
+    {
+        return ERROR;
+    }
+
+    size_t offset = sizeof(JournalHeader);
+    while(offset + sizeof(EntryHeader) <= contents.size())
+    {
+        EntryHeader entry;
+        std::memcpy( &entry, contents.data() + offset, sizeof(entry) );
+
+        const char* sku = contents.data() + offset + sizeof(EntryHeader);
+        if(entry.sku_length > contents.size() - offset - sizeof(EntryHeader) || checksumEntry( entry, sku ) != entry.checksum)
+        {
+            break;
+        }
+
+        if(pEntries != 0)
+        {
+            pEntries->push_back( { static_cast<JournalOp_t>( entry.op ), std::string( sku, entry.sku_length ), entry.handle,
+                                   static_cast<ItemType_t>( entry.type ), entry.amount } );
+        }
+        offset += sizeof(EntryHeader) + entry.sku_length;
+    }
+
+    // whatever follows the last complete entry was cut off, and later entries must not be appended after it
+    if(offset != contents.size() && ftruncate( descriptor, static_cast<off_t>( offset ) ) != 0)
+    {
+        return ERROR;
+    }
+
+    return OK;
+}
+
+ReturnCode_t ScanJournal::append( JournalOp_t op, const ScanRecord& record )
+{
+    EntryHeader entry;
+    std::memset( &entry, 0, sizeof(entry) );
+
+    // the SKU is only needed when the handle was not given
+    std::string_view sku = (record.handle == INVALID_SKU_HANDLE) ? record.sku : std::string_view();
+    if(sku.length() > UINT16_MAX)
+    {
+        return INVALID_ARG;
+    }
+
+    entry.op = static_cast<uint8_t>( op );
+    entry.type = static_cast<uint8_t>( record.type );
+    entry.sku_length = static_cast<uint16_t>( sku.length() );
+    entry.handle = record.handle;
+    entry.amount = record.amount;
+    entry.checksum = checksumEntry( entry, sku.data() );
+
+    std::unique_lock<std::mutex> guard( lock );
+    if(descriptor < 0 || failed)
+    {
+        return ERROR;
+    }
+
+    const char* bytes = reinterpret_cast<const char*>( &entry );
+    buffer.insert( buffer.end(), bytes, bytes + sizeof(entry) );
+    buffer.insert( buffer.end(), sku.data(), sku.data() + entry.sku_length );
+    uint64_t sequence = ++appended;
+
+    if(window.count() == 0)
+    {
+        requested = true;
+        wake.notify_one();
+        return waitFor( guard, sequence );
+    }
+
+    if(buffer.size() >= FLUSH_THRESHOLD)
+    {
+        requested = true;
+        wake.notify_one();
+    }
+
+    return OK;
+}
+
+ReturnCode_t ScanJournal::newTransaction()
+{
+    std::unique_lock<std::mutex> guard( lock );
+    if(descriptor < 0 || failed)
+    {
+        return ERROR;
+    }
+
+    // nothing recorded for the previous customer is needed any more
+    buffer.clear();
+    truncate = true;
+    uint64_t sequence = ++appended;
+
+    if(window.count() == 0)
+    {
+        requested = true;
+        wake.notify_one();
+        return waitFor( guard, sequence );
+    }
+
+    return OK;
+}
+
+ReturnCode_t ScanJournal::sync()
+{
+    std::unique_lock<std::mutex> guard( lock );
+    if(descriptor < 0)
+    {
+        return ERROR;
+    }
+
+    uint64_t sequence = appended;
+    requested = true;
+    wake.notify_one();
+    return waitFor( guard, sequence );
+}
+
+ReturnCode_t ScanJournal::waitFor( std::unique_lock<std::mutex>& guard, uint64_t sequence )
+{
+    flushed.wait( guard, [this, sequence]() { return durable >= sequence || failed; } );
+    return failed ? ERROR : OK;
+}
+
+size_t ScanJournal::getSyncCount() const
+{
+    std::lock_guard<std::mutex> guard( lock );
+    return sync_count;
+}
+
+void ScanJournal::flushLoop()
+{
+    std::vector<char> writing;
+    std::unique_lock<std::mutex> guard( lock );
+
+    while(true)
+    {
+        // sleep until the window ends, unless a caller is waiting on the disk or the buffer is full
+        if(window.count() == 0)
+        {
+            wake.wait( guard, [this]() { return stopping || requested; } );
+        }
+        else
+        {
+            wake.wait_for( guard, window, [this]() { return stopping || requested; } );
+        }
+        requested = false;
+
+        if(durable == appended)
+        {
+            if(stopping)
+            {
+                return;
+            }
+            continue;
+        }
+
+        bool empty_first = truncate;
+        uint64_t sequence = appended;
+        truncate = false;
+        writing.swap( buffer );
+
+        // callers keep appending to the other buffer while this one is written
+        guard.unlock();
+        bool written = !empty_first || ftruncate( descriptor, sizeof(JournalHeader) ) == 0;
+        written = written && writeAll( descriptor, writing.data(), writing.size() ) && fdatasync( descriptor ) == 0;
+        writing.clear();
+        guard.lock();
+
+        sync_count++;
+        if(written)
+        {
+            durable = sequence;
+        }
+        else
+        {
+            failed = true;
+        }
+        flushed.notify_all();
+
+        if(failed)
+        {
+            return;
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef SCAN_JOURNAL_H
+#define SCAN_JOURNAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Types.h"
+#include "Cart.h"
+
+/// \enum JournalOp_t
+/// \brief Describes the change to the cart recorded by an entry of a ScanJournal
+typedef enum
+{
+    JOURNAL_ADD = 1,            ///< The amount was added to the cart
+    JOURNAL_REMOVE = 2,         ///< The amount was removed from the cart
+} JournalOp_t;
+
+/// \struct JournalEntry
+/// \brief A change to the cart read back from a journal
+struct JournalEntry
+{
+    JournalOp_t op;        ///< Whether the amount was added or removed
+    std::string sku;       ///< Represents the item, empty when the change was made through a handle
+    SkuHandle handle;      ///< Identifies the item when the sku is empty
+    ItemType_t type;       ///< Whether the amount is a count of items or a weight
+    double amount;         ///< Number of items or pounds, exactly as given to the cart
+};
+
+/// \class ScanJournal
+/// \brief Append only file recording every change made to a cart so that the cart can be rebuilt after a crash
+///
+/// Each change is appended to a buffer in memory, which costs a copy of the SKU and no system calls. A
+/// background thread writes the buffer to the file and flushes it to the disk at least once per durability
+/// window, so a single flush covers every change made during the window. A crash loses at most the changes
+/// made during the last window. A window of zero makes every change wait until it is on the disk.
+///
+/// The file only ever holds the changes made to the current customer. Starting a new transaction empties it,
+/// so it stays small and reading it back takes no time at all.
+///
+/// Changes made through a SKU are recorded with the SKU. Changes made through a handle alone are recorded with
+/// the handle, which only identifies the same item when the catalog is configured in the same order after the
+/// restart. PointOfSale therefore looks the SKU up from the handle and always records the SKU.
+///
+/// Every entry carries a checksum. An entry that was only partly written when the process stopped is
+/// dropped when the journal is opened again, along with anything after it.
+class ScanJournal
+{
+    public:
+
+        /// \brief Durability window used unless another is given
+        static const std::chrono::microseconds DEFAULT_WINDOW;
+
+        ScanJournal();
+
+        /// \brief Writes and flushes every change still in memory before closing the file
+        ~ScanJournal();
+
+        /// \brief Opens a journal, creating it if needed, and reads back the changes it holds
+        ///
+        /// \param path Location of the journal file
+        /// \param window Longest time a change may stay in memory before it is flushed to the disk
+        /// \param pEntries Location that the changes already in the journal are stored, in the order they were made
+        /// \return OK, INVALID_ARG when the file cannot be opened, or ERROR when it is not a journal
+        ReturnCode_t open( const std::string& path, std::chrono::microseconds window, std::vector<JournalEntry>* pEntries );
+
+        /// \brief Records a change made to the cart
+        ///
+        /// \param op Whether the amount was added or removed
+        /// \param record The item and amount of the change, as given to the cart
+        /// \return OK, INVALID_ARG if the SKU is longer than 65535 characters, or ERROR if the journal could not be written to
+        ReturnCode_t append( JournalOp_t op, const ScanRecord& record );
+
+        /// \brief Empties the journal for the next customer
+        ReturnCode_t newTransaction();
+
+        /// \brief Waits until every change recorded so far has been flushed to the disk
+        ///
+        /// \return OK, or ERROR if the journal could not be written to
+        ReturnCode_t sync();
+
+        /// \brief Provides the number of times the file has been flushed to the disk
+        size_t getSyncCount() const;
+
+    private:
+
+        /// \brief Writes the buffer to the file and flushes it, once per window, until the journal is closed
+        void flushLoop();
+
+        /// \brief Reads every complete entry of the file and drops anything after them
+        ReturnCode_t readEntries( std::vector<JournalEntry>* pEntries );
+
+        /// \brief Waits until the given entry has been flushed, the lock must be held
+        ReturnCode_t waitFor( std::unique_lock<std::mutex>& lock, uint64_t sequence );
+
+        int descriptor;                      // file being appended to, or -1 when closed
+        std::chrono::microseconds window;
+
+        mutable std::mutex lock;             // guards everything below
+        std::condition_variable wake;        // signals the flushing thread that it is needed sooner
+        std::condition_variable flushed;     // signals waiting callers that more entries are on the disk
+        std::vector<char> buffer;            // entries not yet written to the file
+        uint64_t appended;                   // number of changes and new transactions recorded since opening
+        uint64_t durable;                    // number of those known to be on the disk
+        bool truncate;                       // set when the file must be emptied before the buffer is written
+        bool requested;                      // set when the buffer must be written before the window ends
+        bool stopping;
+        bool failed;                         // set once writing to the file has failed
+        size_t sync_count;
+        std::thread flusher;
+
+};
+
+#endif
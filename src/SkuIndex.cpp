@@ -0,0 +1,156 @@
+#include <cstring>
+
+#include "SkuIndex.h"
+
+// The table starts small and doubles whenever it becomes more than 70% full
+// so that probe sequences remain short.
+static const size_t INITIAL_CAPACITY = 16;
+static const size_t MAX_LOAD_PERCENT = 70;
+
+SkuIndex::SkuIndex()
+{
+    slots.resize( INITIAL_CAPACITY );
+    count = 0;
+}
+
+SkuIndex::~SkuIndex()
+{
+
+}
+
+uint64_t SkuIndex::hash( const char* sku, size_t length )
+{
+    // 64 bit FNV-1a
+    uint64_t value = 14695981039346656037ULL;
+    for(size_t i = 0; i < length; i++)
+    {
+        value ^= static_cast<unsigned char>( sku[i] );
+        value *= 1099511628211ULL;
+    }
+
+    // zero marks an empty slot, so it is never used as the hash of a key
+    return (value == 0) ? 1 : value;
+}
+
+const SkuEntry* SkuIndex::find( const char* sku, size_t length ) const
+{
+    size_t position = probe( hash( sku, length ), sku, length );
+
+    if(slots[position].hash == 0)
+    {
+        return 0;
+    }
+
+    return &slots[position].entry;
+}
+
+const SkuEntry* SkuIndex::find( std::string_view sku ) const
+{
+    return find( sku.data(), sku.length() );
+}
+
+void SkuIndex::insert( std::string_view sku, SkuEntry entry )
+{
+    if((count + 1) * 100 > slots.size() * MAX_LOAD_PERCENT)
+    {
+        resize( slots.size() * 2 );
+    }
+
+    uint64_t key_hash = hash( sku.data(), sku.length() );
+    size_t position = probe( key_hash, sku.data(), sku.length() );
+
+    Slot& slot = slots[position];
+    slot.hash = key_hash;
+    slot.key_offset = static_cast<uint32_t>( keys.size() );
+    slot.key_length = static_cast<uint32_t>( sku.length() );
+    slot.entry = entry;
+
+    MappedArray<KeyRef>& positions = (entry.type == WEIGHT_BASED_ITEM) ? weight_keys : fixed_keys;
+    if(positions.size() <= entry.index)
+    {
+        positions.resize( entry.index + 1, KeyRef{ 0, 0 } );
+    }
+    positions[entry.index] = { slot.key_offset, slot.key_length };
+
+    std::vector<char>& pool = keys.detach();
+    pool.insert( pool.end(), sku.begin(), sku.end() );
+    count++;
+}
+
+std::string_view SkuIndex::getSku( SkuEntry entry ) const
+{
+    const MappedArray<KeyRef>& positions = (entry.type == WEIGHT_BASED_ITEM) ? weight_keys : fixed_keys;
+    if(entry.index >= positions.size())
+    {
+        return std::string_view();
+    }
+
+    const KeyRef& key = positions[entry.index];
+    return std::string_view( keys.data() + key.offset, key.length );
+}
+
+void SkuIndex::reserve( size_t expected )
+{
+    size_t capacity = slots.size();
+    while(expected * 100 > capacity * MAX_LOAD_PERCENT)
+    {
+        capacity *= 2;
+    }
+
+    // the table is rehashed at most once no matter how many keys follow
+    if(capacity != slots.size())
+    {
+        resize( capacity );
+    }
+}
+
+size_t SkuIndex::size() const
+{
+    return count;
+}
+
+size_t SkuIndex::probe( uint64_t key_hash, const char* sku, size_t length ) const
+{
+    size_t mask = slots.size() - 1;
+    size_t position = static_cast<size_t>( key_hash ) & mask;
+
+    // walk forward until the key or an empty slot is found, the load limit
+    // guarantees that an empty slot always exists
+    while(slots[position].hash != 0)
+    {
+        const Slot& slot = slots[position];
+        if(slot.hash == key_hash && slot.key_length == length &&
+           std::memcmp( keys.data() + slot.key_offset, sku, length ) == 0)
+        {
+            break;
+        }
+
+        position = (position + 1) & mask;
+    }
+
+    return position;
+}
+
+void SkuIndex::resize( size_t capacity )
+{
+    std::vector<Slot> previous( capacity );
+    previous.swap( slots.detach() );
+
+    size_t mask = slots.size() - 1;
+    for(size_t i = 0; i < previous.size(); i++)
+    {
+        if(previous[i].hash == 0)
+        {
+            continue;
+        }
+
+        // keys are unique, so only an empty slot needs to be located
+        size_t position = static_cast<size_t>( previous[i].hash ) & mask;
+        while(slots[position].hash != 0)
+        {
+            position = (position + 1) & mask;
+        }
+
+        slots[position] = previous[i];
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef SKU_INDEX_H
+#define SKU_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+#include "MappedArray.h"
+
+/// \struct SkuEntry
+/// \brief Identifies the storage for a SKU registered within the catalog
+///
+/// A SKU is either a fixed price item or a weight based item. The entry records which of the
+/// two it is along with the position of its configuration in the storage for that type.
+struct SkuEntry
+{
+    ItemType_t type;   ///< Whether the SKU is sold per item or per pound
+    uint32_t index;    ///< Position of the item within the storage for its type
+};
+
+/// \brief Converts an entry into the handle that is given out for the SKU
+///
+/// The most significant bit of the handle records the type of the item and the remaining bits
+/// hold the position of the item within the storage for that type.
+inline SkuHandle makeSkuHandle( const SkuEntry& entry )
+{
+    return ((entry.type == WEIGHT_BASED_ITEM) ? 0x80000000u : 0u) | entry.index;
+}
+
+/// \brief Recovers the entry from a handle created by makeSkuHandle
+inline SkuEntry getSkuEntry( SkuHandle handle )
+{
+    SkuEntry entry = { (handle & 0x80000000u) ? WEIGHT_BASED_ITEM : FIXED_PRICE_ITEM, handle & 0x7FFFFFFFu };
+    return entry;
+}
+
+/// \class SkuIndex
+/// \brief Maps SKU strings to the storage of their configuration using a single hash table
+///
+/// The SkuIndex class replaces separate ordered maps for each type of item with one open addressing
+/// hash table. Finding a SKU costs a single hash of the string followed by a linear probe that
+/// compares cached hashes before comparing any characters. The hash of every key is stored in its
+/// slot, so growing the table never needs to hash the strings again.
+///
+/// The characters of every key are kept in one contiguous pool and the slots refer to them by
+/// offset. The key of each item is also recorded by its position, so a handle can be turned back into
+/// its SKU without searching the table. This keeps the table free of per-key allocations, and since nothing in the table is a
+/// pointer it can be saved to a CatalogImage and searched in place once the image is mapped.
+class SkuIndex
+{
+    public:
+
+        SkuIndex();
+        ~SkuIndex();
+
+        /// \brief Looks up the entry for a SKU
+        ///
+        /// \param sku Characters of the SKU being looked up
+        /// \param length Number of characters in the SKU
+        /// \return The entry for the SKU, or null if the SKU has not been registered
+        const SkuEntry* find( const char* sku, size_t length ) const;
+
+        /// \brief Looks up the entry for a SKU
+        ///
+        /// \param sku Represents the item being looked up
+        /// \return The entry for the SKU, or null if the SKU has not been registered
+        const SkuEntry* find( std::string_view sku ) const;
+
+        /// \brief Provides the SKU registered for an entry
+        ///
+        /// \param entry Location of the configuration for the item
+        /// \return Characters of the SKU, or an empty view if no SKU has been registered for the entry
+        std::string_view getSku( SkuEntry entry ) const;
+
+        /// \brief Registers a SKU with the index
+        ///
+        /// \param sku Represents the item being registered, must not already be registered
+        /// \param entry Location of the configuration for the item
+        void insert( std::string_view sku, SkuEntry entry );
+
+        /// \brief Sizes the table so that a number of SKUs can be registered without growing it
+        ///
+        /// \param expected Total number of SKUs the index is expected to hold
+        void reserve( size_t expected );
+
+        /// \brief Provides the number of SKUs registered with the index
+        size_t size() const;
+
+        /// \brief Computes the hash used to place a SKU within the table
+        ///
+        /// \param sku Characters of the SKU
+        /// \param length Number of characters in the SKU
+        static uint64_t hash( const char* sku, size_t length );
+
+    private:
+
+        friend class CatalogImage;
+
+        /// \brief Single position within the hash table
+        struct Slot
+        {
+            uint64_t hash;        // cached hash of the key, zero when the slot is empty
+            uint32_t key_offset;  // position of the key within the key pool
+            uint32_t key_length;  // number of characters in the key
+            SkuEntry entry;       // value associated with the key
+        };
+
+        /// \brief Location of the characters of a key within the key pool
+        struct KeyRef
+        {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        /// \brief Finds the slot holding the SKU, or the empty slot where it belongs
+        size_t probe( uint64_t hash, const char* sku, size_t length ) const;
+
+        /// \brief Changes the size of the table, placing every key using its cached hash
+        void resize( size_t capacity );
+
+        MappedArray<Slot> slots; // table of slots, size is always a power of two
+        MappedArray<char> keys;  // characters of every registered key
+        MappedArray<KeyRef> fixed_keys;   // key of every fixed price item, by position within its storage
+        MappedArray<KeyRef> weight_keys;  // key of every weight based item, by position within its storage
+        size_t count;            // number of slots in use
+
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+#include "StoreEngine.h"
+
+// Epoch announced by a lane that is not reading any version
+static const uint64_t LANE_IDLE = UINT64_MAX;
+
+/// \brief One immutable version of the catalog
+struct CatalogVersion
+{
+    std::shared_ptr<const Catalog> catalog;
+    uint64_t number;         // counts up from 1 with every publication
+    uint64_t retired_epoch;  // epoch that began when the version was replaced
+};
+
+/// \brief Epoch announced by a single lane, kept on its own cache line since only that lane writes it
+struct alignas(64) LaneEpoch
+{
+    std::atomic<uint64_t> epoch;
+};
+
+/// \brief State shared between an engine and its lanes
+struct EngineState
+{
+    ~EngineState()
+    {
+        delete current.load();
+    }
+
+    /// \brief Makes a catalog the latest version and frees what it can, the updater lock must be held
+    void publish( std::shared_ptr<const Catalog> catalog )
+    {
+        std::lock_guard<std::mutex> lock( writer );
+
+        CatalogVersion* replaced = current.load();
+        CatalogVersion* next = new CatalogVersion{ catalog, replaced->number + 1, 0 };
+
+        // the new version is made the latest before the epoch advances, see Lane::pinLatest
+        current.store( next );
+        uint64_t advanced = epoch.fetch_add( 1 ) + 1;
+
+        replaced->retired_epoch = advanced;
+        retired.emplace_back( replaced );
+
+        reclaim();
+    }
+
+    /// \brief Frees the replaced versions that every lane has moved past, the writer lock must be held
+    void reclaim()
+    {
+        uint64_t oldest = LANE_IDLE;
+        for(const std::unique_ptr<LaneEpoch>& lane : lanes)
+        {
+            oldest = std::min( oldest, lane->epoch.load() );
+        }
+
+        // a lane that announced an epoch at or after the replacement took the version after it was replaced
+        retired.erase( std::remove_if( retired.begin(), retired.end(),
+                                       [oldest]( const std::unique_ptr<CatalogVersion>& version )
+                                       { return version->retired_epoch <= oldest; } ),
+                       retired.end() );
+    }
+
+    std::atomic<CatalogVersion*> current;  // latest version, read by lanes
+    std::atomic<uint64_t> epoch;           // advanced on every publication, read by lanes
+
+    std::mutex updater;                                    // held by a writer from taking the latest version to publishing
+    std::mutex writer;                                     // held while publishing and while lanes open or close
+    std::vector<std::unique_ptr<LaneEpoch>> lanes;         // epoch of every open lane
+    std::vector<std::unique_ptr<CatalogVersion>> retired;  // replaced versions that may still be read
+};
+
+// Reads the latest version while a lane is between customers, announcing its epoch only for the read
+template <class F>
+static auto readLatest( EngineState& state, LaneEpoch& epoch, F read )
+{
+    epoch.epoch.store( state.epoch.load() );
+    auto result = read( *state.current.load() );
+    epoch.epoch.store( LANE_IDLE );
+    return result;
+}
+
+Lane::Lane( std::shared_ptr<EngineState> state )
+    : state( state ), epoch( openEpoch( *state ) ), version( 0 ), cart( pinLatest(), &arena )
+{
+    // the cart is empty, so the lane waits for its first customer without holding a version
+    unpin();
+}
+
+Lane::~Lane()
+{
+    epoch->epoch.store( LANE_IDLE );
+
+    std::lock_guard<std::mutex> lock( state->writer );
+    state->lanes.erase( std::find_if( state->lanes.begin(), state->lanes.end(),
+                                      [this]( const std::unique_ptr<LaneEpoch>& lane ) { return lane.get() == epoch; } ) );
+}
+
+LaneEpoch* Lane::openEpoch( EngineState& state )
+{
+    std::unique_ptr<LaneEpoch> announced( new LaneEpoch() );
+    announced->epoch.store( LANE_IDLE );
+    LaneEpoch* epoch = announced.get();
+
+    std::lock_guard<std::mutex> lock( state.writer );
+    state.lanes.push_back( std::move( announced ) );
+    return epoch;
+}
+
+const Catalog& Lane::pinLatest()
+{
+    // The epoch must be announced before the version is read. A writer that frees a version only does so
+    // after seeing an announced epoch later than the replacement, and that epoch can only have been read
+    // once the replacement was already the latest version.
+    epoch->epoch.store( state->epoch.load() );
+    version = state->current.load();
+    return *version->catalog;
+}
+
+void Lane::pin()
+{
+    if(version == 0)
+    {
+        cart.newTransaction( pinLatest() );
+    }
+}
+
+void Lane::unpin()
+{
+    version = 0;
+    epoch->epoch.store( LANE_IDLE );
+}
+
+SkuHandle Lane::resolveSku( std::string_view sku ) const
+{
+    if(version == 0)
+    {
+        return readLatest( *state, *epoch, [sku]( const CatalogVersion& latest )
+                           { return latest.catalog->resolveSku( sku ); } );
+    }
+
+    return version->catalog->resolveSku( sku );
+}
+
+ReturnCode_t Lane::addToCart( std::string_view sku, int count )
+{
+    pin();
+    return cart.addToCart( sku, count );
+}
+
+ReturnCode_t Lane::addToCart( std::string_view sku, double weight )
+{
+    pin();
+    return cart.addToCart( sku, weight );
+}
+
+ReturnCode_t Lane::addToCart( SkuHandle handle, int count )
+{
+    pin();
+    return cart.addToCart( handle, count );
+}
+
+ReturnCode_t Lane::addToCart( SkuHandle handle, double weight )
+{
+    pin();
+    return cart.addToCart( handle, weight );
+}
+
+ReturnCode_t Lane::removeFromCart( std::string_view sku, int count )
+{
+    pin();
+    return cart.removeFromCart( sku, count );
+}
+
+ReturnCode_t Lane::removeFromCart( std::string_view sku, double weight )
+{
+    pin();
+    return cart.removeFromCart( sku, weight );
+}
+
+ReturnCode_t Lane::addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes )
+{
+    pin();
+    return cart.addToCartBatch( records, count, codes );
+}
+
+double Lane::getPreTaxTotal() const
+{
+    return cart.getPreTaxTotal();
+}
+
+Money Lane::getPreTaxTotalMoney() const
+{
+    return cart.getPreTaxTotalMoney();
+}
+
+void Lane::newTransaction()
+{
+    // the cart only takes the catalog of the next customer once they are started by pin
+    cart.newTransaction();
+    unpin();
+}
+
+uint64_t Lane::getVersion() const
+{
+    if(version == 0)
+    {
+        return readLatest( *state, *epoch, []( const CatalogVersion& latest ) { return latest.number; } );
+    }
+
+    return version->number;
+}
+
+StoreEngine::StoreEngine( std::shared_ptr<const Catalog> catalog ) : state( new EngineState() )
+{
+    state->current.store( new CatalogVersion{ catalog, 1, 0 } );
+    state->epoch.store( 1 );
+}
+
+StoreEngine::~StoreEngine()
+{
+
+}
+
+std::unique_ptr<Lane> StoreEngine::openLane() const
+{
+    return std::unique_ptr<Lane>( new Lane( state ) );
+}
+
+ReturnCode_t StoreEngine::update( const std::function<ReturnCode_t( Catalog& )>& changes )
+{
+    // Held until the copy is published, so that no other writer can publish a version this one would replace
+    // without including its changes. Only writers free versions, so the latest one also stays valid meanwhile.
+    std::lock_guard<std::mutex> lock( state->updater );
+
+    // the copy shares every array with the latest version until the changes write to it
+    std::shared_ptr<Catalog> next = std::make_shared<Catalog>( *state->current.load()->catalog );
+
+    ReturnCode_t code = changes( *next );
+    if(code != OK)
+    {
+        return code;
+    }
+
+    state->publish( next );
+    return OK;
+}
+
+void StoreEngine::publish( std::shared_ptr<const Catalog> catalog )
+{
+    std::lock_guard<std::mutex> lock( state->updater );
+    state->publish( catalog );
+}
+
+void StoreEngine::reclaim()
+{
+    std::lock_guard<std::mutex> lock( state->writer );
+    state->reclaim();
+}
+
+std::shared_ptr<const Catalog> StoreEngine::getCatalog() const
+{
+    std::lock_guard<std::mutex> lock( state->writer );
+    return state->current.load()->catalog;
+}
+
+uint64_t StoreEngine::getVersion() const
+{
+    std::lock_guard<std::mutex> lock( state->writer );
+    return state->current.load()->number;
+}
+
+size_t StoreEngine::getRetiredCount() const
+{
+    std::lock_guard<std::mutex> lock( state->writer );
+    return state->retired.size();
+}
@@ -0,0 +1,204 @@
+#ifndef STORE_ENGINE_H
+#define STORE_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+
+#include "Types.h"
+#include "Money.h"
+#include "Catalog.h"
+#include "Cart.h"
+
+struct EngineState;
+struct CatalogVersion;
+struct LaneEpoch;
+
+/// \class Lane
+/// \brief Checkout served by a single thread against the catalog shared by a StoreEngine
+///
+/// Each lane owns its cart along with the arena its cart memory is taken from, so lanes never share
+/// anything that is written. Every lane is placed on its own cache lines so that lanes running on
+/// different cores do not slow each other down. A lane must only be used by one thread at a time.
+///
+/// A lane prices every customer against the catalog version that was current when the first item of the
+/// customer was scanned. Versions published in the meantime are picked up by the next customer, so the
+/// prices never change part way through a checkout. Between customers the lane holds no version at all,
+/// so a lane left waiting for its next customer never keeps a replaced version from being freed.
+class alignas(64) Lane
+{
+    public:
+
+        ~Lane();
+
+        /// \brief Converts a SKU into a handle for the catalog version used by the lane
+        ///
+        /// Handles remain valid in every later version made through StoreEngine::update, since SKUs are
+        /// never removed from a catalog.
+        ///
+        /// \param sku Represents the item being looked up
+        SkuHandle resolveSku( std::string_view sku ) const;
+
+        /// \brief Adds fixed price items to the cart
+        ///
+        /// \param sku Represents the item that is being added
+        /// \param count Number of the items that should be added to the cart
+        ReturnCode_t addToCart( std::string_view sku, int count );
+
+        /// \brief Adds weight to an item in the cart
+        ///
+        /// \param sku Represents the item that is being added
+        /// \param weight Amount of the item that should be added to the cart, in pounds
+        ReturnCode_t addToCart( std::string_view sku, double weight );
+
+        /// \brief Adds fixed price items to the cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param count Number of the items that should be added to the cart
+        ReturnCode_t addToCart( SkuHandle handle, int count );
+
+        /// \brief Adds weight to an item in the cart using a handle from resolveSku
+        ///
+        /// \param handle Identifies the item that is being added
+        /// \param weight Amount of the item that should be added to the cart, in pounds
+        ReturnCode_t addToCart( SkuHandle handle, double weight );
+
+        /// \brief Removes fixed price items from the cart
+        ///
+        /// \param sku Represents the item that is being removed
+        /// \param count The number of items that need to removed from the cart
+        ReturnCode_t removeFromCart( std::string_view sku, int count );
+
+        /// \brief Removes a portion of a weight based item from the cart
+        ///
+        /// \param sku Represents the item that is being removed
+        /// \param weight Amount of the item that should be removed from the cart, in pounds
+        ReturnCode_t removeFromCart( std::string_view sku, double weight );
+
+        /// \brief Adds a whole basket of items to the cart at once, as with Cart::addToCartBatch
+        ///
+        /// \param records The scans being added to the cart
+        /// \param count Number of records
+        /// \param codes Location that the result of each record is stored, must hold count entries
+        ReturnCode_t addToCartBatch( const ScanRecord* records, size_t count, ReturnCode_t* codes );
+
+        /// \brief Provides the pre-tax total for all items within the cart
+        double getPreTaxTotal() const;
+
+        /// \brief Provides the exact pre-tax total for all items within the cart, in Money units
+        Money getPreTaxTotalMoney() const;
+
+        /// \brief Empties the cart and lets go of the catalog version, so the next customer gets the latest one
+        void newTransaction();
+
+        /// \brief Provides the number of the catalog version the current customer is priced against
+        ///
+        /// Between customers this is the latest version, which the next customer will be priced against
+        /// unless another is published first.
+        uint64_t getVersion() const;
+
+    private:
+
+        friend class StoreEngine;
+
+        Lane( std::shared_ptr<EngineState> state );
+
+        /// \brief Registers the epoch of a new lane with the engine
+        static LaneEpoch* openEpoch( EngineState& state );
+
+        /// \brief Announces the epoch the lane is reading in, then takes the latest catalog version
+        ///
+        /// \return The catalog of the version that was taken
+        const Catalog& pinLatest();
+
+        /// \brief Takes the latest catalog version for the customer if the lane is between customers
+        void pin();
+
+        /// \brief Lets go of the version of the customer, announcing that the lane reads nothing
+        void unpin();
+
+        std::shared_ptr<EngineState> state;         // versions and lanes shared with the engine
+        LaneEpoch* epoch;                           // epoch announced by this lane, owned by the state
+        const CatalogVersion* version;              // version used for the current customer, null between customers
+        std::pmr::monotonic_buffer_resource arena;  // memory used by the cart
+        Cart cart;                                  // items scanned for the current customer
+
+};
+
+/// \class StoreEngine
+/// \brief Runs any number of lanes on their own threads against a shared catalog that can be updated live
+///
+/// The engine holds the catalog as a series of immutable versions. Lanes look up and price items without
+/// taking locks: a lane reads the latest version once when it starts a customer, and everything after
+/// that only reads the version it holds. There is a single copy of each version no matter how many
+/// lanes are open, and versions share every array of the catalog that a change did not touch.
+///
+/// Price, markdown and discount changes are made to a copy of the latest version, which is then published
+/// with a single atomic store. The copy shares the arrays of the version it was made from, and only the
+/// arrays the changes write to are copied, see MappedArray. Lanes are never stopped for a change. A customer
+/// already being checked out keeps the version it started with, while the next customer on every lane gets
+/// the new one.
+///
+/// Versions that have been replaced are freed using epoch based reclamation. Each publication advances
+/// a global epoch, and each lane announces the epoch it was in when it took the version it is reading, or
+/// that it is reading nothing between customers. A replaced version is freed by the writer once every open
+/// lane has announced a later epoch or nothing, meaning none of them can still be reading it. Writers are
+/// serialized with each other, but never wait for a lane.
+class StoreEngine
+{
+    public:
+
+        /// \brief Creates an engine whose first version is the given catalog
+        ///
+        /// \param catalog Fully configured catalog, which must not be changed by anyone after this call
+        StoreEngine( std::shared_ptr<const Catalog> catalog );
+        ~StoreEngine();
+
+        /// \brief Opens a new lane with an empty cart, priced against the latest version
+        ///
+        /// Opening a lane is safe from any thread. A lane may outlive the engine.
+        std::unique_ptr<Lane> openLane() const;
+
+        /// \brief Applies a set of changes to a copy of the latest version and publishes the result
+        ///
+        /// The copy shares every array with the latest version until the changes write to it, so an update
+        /// costs about as much as the arrays it changes rather than the whole catalog.
+        /// The changes are made through the usual Catalog functions, such as setItemPrice, setMarkdown and
+        /// the discount functions. When the changes return anything other than OK the copy is discarded
+        /// and nothing is published, so a set of changes is either seen by lanes in full or not at all.
+        ///
+        /// Updates and publications are made one at a time, each starting from the version published by
+        /// the one before, so no set of changes is ever lost. The changes must not call back into the engine.
+        ///
+        /// \param changes Makes the changes to the copy it is given and returns the outcome
+        /// \return The code returned by the changes
+        ReturnCode_t update( const std::function<ReturnCode_t( Catalog& )>& changes );
+
+        /// \brief Publishes a complete catalog as the next version
+        ///
+        /// \param catalog Fully configured catalog, which must not be changed by anyone after this call
+        void publish( std::shared_ptr<const Catalog> catalog );
+
+        /// \brief Frees every replaced version that no lane can still be reading
+        ///
+        /// This is also done on every publication, so it only needs to be called to release memory sooner.
+        void reclaim();
+
+        /// \brief Provides the latest catalog version
+        std::shared_ptr<const Catalog> getCatalog() const;
+
+        /// \brief Provides the number of the latest catalog version, starting from 1
+        uint64_t getVersion() const;
+
+        /// \brief Provides the number of replaced versions that have not been freed yet
+        size_t getRetiredCount() const;
+
+    private:
+
+        std::shared_ptr<EngineState> state;  // shared with every lane so lanes may outlive the engine
+
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <cstdint>
+
 /// \enum ReturnCode_t
 /// \brief Describes possible return codes for API's within the PoS system
 ///
@@ -21,4 +23,40 @@ typedef enum
     ITEM_NOT_IN_CART,           ///< Removal of item not allowed without being in cart  
 } ReturnCode_t;
 
+/// \enum ItemType_t
+/// \brief Describes how an item registered with the PoS system is sold
+///
+/// Every SKU is registered as either a fixed price item or a weight based item when its
+/// price is first configured. The type of the item can not be changed afterwards.
+typedef enum
+{
+    FIXED_PRICE_ITEM,           ///< Item is sold as a whole number of units at a set price per unit
+    WEIGHT_BASED_ITEM,          ///< Item is sold by weight at a set price per pound
+} ItemType_t;
+
+/// \enum DiscountType_t
+/// \brief Describes the discount configured for an item
+///
+/// Configuring a discount replaces any discount that was configured before it. Discounts that are
+/// added instead are offered together, and the item is then described as STACKED_DISCOUNTS.
+typedef enum
+{
+    NO_DISCOUNT,                ///< Every item, or pound, is sold at the marked down price
+    X_FOR_FLAT,                 ///< Bundles of the item are sold for a single price, optionally up to a limit
+    BUY_X_GET_Y_FOR_Z_LIMIT_W,  ///< Items are sold at a percentage off after others are bought at full price
+    STACKED_DISCOUNTS,          ///< Several discounts are offered, and the cheapest way of combining them is used
+} DiscountType_t;
+
+/// \typedef SkuHandle
+/// \brief Compact identifier for a SKU that has been registered with the PoS system
+///
+/// A handle is obtained by resolving a SKU once. It remains valid for as long as the SKU stays registered,
+/// and it allows repeated operations on the same SKU to skip the string lookup entirely. The handle encodes
+/// the type of the item, so operations using a handle go straight to the storage for the item.
+typedef uint32_t SkuHandle;
+
+/// \brief Handle returned when a SKU has not been registered. Operations given this handle behave the same
+/// as they would for an unknown SKU.
+const SkuHandle INVALID_SKU_HANDLE = 0xFFFFFFFFu;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "Catalog.h"
+#include "Cart.h"
+
+class CatalogCartTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       catalog.setItemPrice( "Soup",  1.50 );
+       catalog.setItemPrice( "Chips", 2.00 );
+       catalog.setPerPoundPrice( "Beef", 3.50 );
+
+       catalog.applyGetXForYDiscount( "Chips", 3, 5.00 );
+   }
+
+   // Single catalog shared by every cart within the tests
+   Catalog catalog;
+};
+
+TEST_F (CatalogCartTest, newCartIsEmpty){
+
+    Cart cart( catalog );
+
+    ASSERT_NEAR( cart.getPreTaxTotal(), 0.0, .01 );
+    ASSERT_FALSE( cart.isInCart( "Soup" ) );
+
+}
+
+TEST_F (CatalogCartTest, cartsShareCatalogIndependently){
+
+    Cart first( catalog );
+    Cart second( catalog );
+
+    ASSERT_EQ( OK, first.addToCart( "Chips", 3 ) );
+    ASSERT_EQ( OK, first.addToCart( "Beef", 2.0 ) );
+    ASSERT_EQ( OK, second.addToCart( "Soup", 2 ) );
+
+    ASSERT_NEAR( first.getPreTaxTotal(), 12.0, .01 );
+    ASSERT_NEAR( second.getPreTaxTotal(), 3.0, .01 );
+
+    ASSERT_TRUE( first.isInCart( "Chips" ) );
+    ASSERT_FALSE( second.isInCart( "Chips" ) );
+
+}
+
+TEST_F (CatalogCartTest, cartErrorCodes){
+
+    Cart cart( catalog );
+
+    ASSERT_EQ( INVALID_SKU, cart.addToCart( "", 1 ) );
+    ASSERT_EQ( NO_PRICE_DEFINED, cart.addToCart( "Cookies", 1 ) );
+    ASSERT_EQ( ITEM_CONFLICT, cart.addToCart( "Beef", 1 ) );
+    ASSERT_EQ( ITEM_CONFLICT, cart.addToCart( "Soup", 1.0 ) );
+    ASSERT_EQ( INVALID_ARG, cart.addToCart( "Soup", 0 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, cart.removeFromCart( "Soup", 1 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, cart.removeFromCart( "Cookies", 1 ) );
+
+}
+
+TEST_F (CatalogCartTest, refreshItemAfterCatalogChange){
+
+    Cart cart( catalog );
+
+    ASSERT_EQ( OK, cart.addToCart( "Soup", 4 ) );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 6.0, .01 );
+
+    ASSERT_EQ( OK, catalog.applyGetXForYDiscount( "Soup", 2, 2.00 ) );
+    cart.refreshItem( "Soup" );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 4.0, .01 );
+
+}
+
+TEST_F (CatalogCartTest, invalidPriceDoesNotRegisterSku){
+
+    ASSERT_EQ( INVALID_PRICE, catalog.setItemPrice( "Cookies", 0.0 ) );
+
+    // the sku is still free to be registered as either type
+    ASSERT_EQ( OK, catalog.setPerPoundPrice( "Cookies", 4.0 ) );
+    ASSERT_FALSE( catalog.isFixedItem( "Cookies" ) );
+    ASSERT_TRUE( catalog.isWeightItem( "Cookies" ) );
+
+}
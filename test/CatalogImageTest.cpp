@@ -0,0 +1,200 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "Catalog.h"
+#include "CatalogImage.h"
+#include "Cart.h"
+
+class CatalogImageTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       path = ::testing::TempDir() + "catalog_image_test.bin";
+
+       original.setItemPrice( "Soup", 1.50 );
+       original.setItemPrice( "Chips", 2.00 );
+       original.setPerPoundPrice( "Beef", 3.50 );
+       original.setMarkdown( "Beef", 0.50 );
+       original.applyGetXForYDiscount( "Chips", 3, 5.00, 6 );
+       original.applyBuyXGetYAtDiscount( "Beef", 2.0, 1.0, 0.5 );
+
+       for(int i = 0; i < 1000; i++)
+       {
+           original.setItemPrice( "SKU" + std::to_string(i), 1.00 + i * 0.01 );
+       }
+   }
+
+   void TearDown( ) override
+   {
+       std::remove( path.c_str() );
+   }
+
+   // fills a cart with the same items from a catalog
+   Money priceBasket( const Catalog& catalog )
+   {
+       Cart cart( catalog );
+
+       cart.addToCart( "Soup", 2 );
+       cart.addToCart( "Chips", 7 );
+       cart.addToCart( "Beef", 3.25 );
+       cart.addToCart( "SKU999", 4 );
+
+       return cart.getPreTaxTotalMoney();
+   }
+
+   std::string path;
+   Catalog original;
+};
+
+TEST_F (CatalogImageTest, openedImagePricesLikeTheOriginal){
+
+    Catalog mapped;
+
+    ASSERT_EQ( OK, original.saveImage( path ) );
+    ASSERT_EQ( OK, mapped.openImage( path ) );
+
+    ASSERT_EQ( priceBasket( original ), priceBasket( mapped ) );
+    ASSERT_EQ( original.resolveSku( "SKU500" ), mapped.resolveSku( "SKU500" ) );
+    ASSERT_EQ( original.resolveSku( "Beef" ), mapped.resolveSku( "Beef" ) );
+    ASSERT_EQ( INVALID_SKU_HANDLE, mapped.resolveSku( "Cookies" ) );
+    ASSERT_TRUE( mapped.isWeightItem( "Beef" ) );
+    ASSERT_EQ( "SKU500", mapped.getSku( mapped.resolveSku( "SKU500" ) ) );
+    ASSERT_EQ( "Beef", mapped.getSku( mapped.resolveSku( "Beef" ) ) );
+
+}
+
+TEST_F (CatalogImageTest, changesDoNotReachTheFile){
+
+    Catalog mapped;
+
+    ASSERT_EQ( OK, original.saveImage( path ) );
+    ASSERT_EQ( OK, mapped.openImage( path ) );
+
+    ASSERT_EQ( OK, mapped.setItemPrice( "Soup", 9.00 ) );
+    ASSERT_EQ( OK, mapped.setItemPrice( "Cookies", 3.00 ) );
+    ASSERT_EQ( ITEM_CONFLICT, mapped.setItemPrice( "Beef", 3.00 ) );
+    ASSERT_NE( priceBasket( original ), priceBasket( mapped ) );
+    ASSERT_TRUE( mapped.isFixedItem( "Cookies" ) );
+    ASSERT_TRUE( mapped.isFixedItem( "SKU999" ) );
+
+    Catalog reopened;
+    ASSERT_EQ( OK, reopened.openImage( path ) );
+    ASSERT_EQ( priceBasket( original ), priceBasket( reopened ) );
+    ASSERT_FALSE( reopened.isFixedItem( "Cookies" ) );
+
+}
+
+TEST_F (CatalogImageTest, imageOutlivesReplacement){
+
+    Catalog mapped;
+
+    ASSERT_EQ( OK, original.saveImage( path ) );
+    ASSERT_EQ( OK, mapped.openImage( path ) );
+
+    // writing a new image must not disturb a catalog using the previous one
+    original.setItemPrice( "Soup", 4.00 );
+    ASSERT_EQ( OK, original.saveImage( path ) );
+
+    Catalog updated;
+    ASSERT_EQ( OK, updated.openImage( path ) );
+    ASSERT_EQ( priceBasket( original ), priceBasket( updated ) );
+    ASSERT_EQ( priceBasket( original ) - 2 * 25000, priceBasket( mapped ) );
+
+}
+
+TEST_F (CatalogImageTest, rejectsInvalidFiles){
+
+    Catalog catalog;
+
+    catalog.setItemPrice( "Soup", 1.00 );
+    ASSERT_EQ( INVALID_ARG, catalog.openImage( ::testing::TempDir() + "missing/catalog.bin" ) );
+
+    FILE* file = std::fopen( path.c_str(), "wb" );
+    ASSERT_TRUE( file != 0 );
+    std::fputs( "sku,type,price\nSoup,each,1.50\n", file );
+    std::fclose( file );
+    ASSERT_EQ( ERROR, catalog.openImage( path ) );
+
+    // a truncated image is rejected as well
+    ASSERT_EQ( OK, original.saveImage( path ) );
+    file = std::fopen( path.c_str(), "r+b" );
+    ASSERT_TRUE( file != 0 );
+    std::fseek( file, 0, SEEK_END );
+    long length = std::ftell( file );
+    std::fclose( file );
+    ASSERT_EQ( 0, truncate( path.c_str(), length - 8 ) );
+    ASSERT_EQ( ERROR, catalog.openImage( path ) );
+
+    // the catalog keeps its contents when an image is rejected
+    ASSERT_TRUE( catalog.isFixedItem( "Soup" ) );
+    ASSERT_FALSE( catalog.isFixedItem( "Chips" ) );
+
+}
+
+TEST_F (CatalogImageTest, rejectsCorruptSlot){
+
+    Catalog catalog;
+
+    ASSERT_EQ( OK, original.saveImage( path ) );
+
+    std::ifstream input( path, std::ios::binary );
+    std::string bytes( (std::istreambuf_iterator<char>( input )), std::istreambuf_iterator<char>() );
+    input.close();
+
+    // Soup was registered first, so its slot holds the key at the start of the pool and the first fixed price item
+    const uint32_t fields[4] = { 0, 4, FIXED_PRICE_ITEM, 0 };
+    std::string slot( reinterpret_cast<const char*>( fields ), sizeof(fields) );
+    size_t position = bytes.find( slot );
+    ASSERT_NE( std::string::npos, position );
+    ASSERT_EQ( std::string::npos, bytes.find( slot, position + 1 ) );
+
+    // a key that runs past the end of the pool
+    const uint32_t offset = 0xFFFFFFF0u;
+    std::memcpy( &bytes[position], &offset, sizeof(offset) );
+    std::ofstream output( path, std::ios::binary | std::ios::trunc );
+    output.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ) );
+    output.close();
+
+    ASSERT_EQ( ERROR, catalog.openImage( path ) );
+
+}
+
+TEST_F (CatalogImageTest, emptyCatalog){
+
+    Catalog empty;
+    Catalog mapped;
+
+    ASSERT_EQ( OK, empty.saveImage( path ) );
+    ASSERT_EQ( OK, mapped.openImage( path ) );
+    ASSERT_EQ( INVALID_SKU_HANDLE, mapped.resolveSku( "Soup" ) );
+    ASSERT_EQ( OK, mapped.setItemPrice( "Soup", 1.00 ) );
+    ASSERT_TRUE( mapped.isFixedItem( "Soup" ) );
+
+}
+
+TEST_F (CatalogImageTest, stackedDiscountsKept){
+
+    Catalog mapped;
+
+    ASSERT_EQ( OK, original.addBuyXGetYAtDiscount( "Chips", 1, 1, 0.5 ) );
+    ASSERT_EQ( OK, original.addBuyXGetYAtDiscount( "Beef", 1.0, 1.0, 0.25, 2.0 ) );
+    ASSERT_EQ( OK, original.saveImage( path ) );
+    ASSERT_EQ( OK, mapped.openImage( path ) );
+
+    ASSERT_EQ( priceBasket( original ), priceBasket( mapped ) );
+
+    // the stack read from the file takes further discounts like any other
+    ASSERT_EQ( OK, mapped.addGetXForYDiscount( "Chips", 2, 3.00 ) );
+    ASSERT_EQ( OK, original.addGetXForYDiscount( "Chips", 2, 3.00 ) );
+    ASSERT_EQ( priceBasket( original ), priceBasket( mapped ) );
+
+}
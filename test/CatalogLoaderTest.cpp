@@ -0,0 +1,293 @@
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "Catalog.h"
+#include "CatalogLoader.h"
+#include "Cart.h"
+
+// Builds a price file holding the given number of rows, with every kind of row represented
+static std::string makePriceFile( size_t count )
+{
+    std::string contents = "sku,type,price,markdown,discount,x,y,z,limit\n";
+    char buffer[96];
+
+    for(size_t i = 0; i < count; i++)
+    {
+        switch(i % 5)
+        {
+            case 0:  std::snprintf( buffer, sizeof(buffer), "item%zu,each,%zu.25\n", i, 1 + i % 7 ); break;
+            case 1:  std::snprintf( buffer, sizeof(buffer), "item%zu,lb,%zu.49,0.50\n", i, 2 + i % 3 ); break;
+            case 2:  std::snprintf( buffer, sizeof(buffer), "item%zu,each,2.00,,xfor,3,5.00,6\n", i ); break;
+            case 3:  std::snprintf( buffer, sizeof(buffer), "item%zu,lb,3.99,,bxgy,1.5,1.0,0.5\n", i ); break;
+            default: std::snprintf( buffer, sizeof(buffer), "item%zu,each,-1.00\n", i ); break;
+        }
+
+        contents += buffer;
+    }
+
+    return contents;
+}
+
+// Supplies some contents and then fails, as a file on a failing disk would
+class FailingBuffer : public std::streambuf
+{
+    public:
+
+        FailingBuffer( const std::string& contents ) : contents( contents ), given( false )
+        {
+
+        }
+
+    protected:
+
+        int_type underflow() override
+        {
+            if(given)
+            {
+                throw std::runtime_error( "read failed" );
+            }
+
+            given = true;
+            setg( &contents[0], &contents[0], &contents[0] + contents.size() );
+            return traits_type::to_int_type( contents[0] );
+        }
+
+    private:
+
+        std::string contents;
+        bool given;
+};
+
+TEST (CatalogLoaderTest, loadsCsvRows){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    std::istringstream input( "sku,type,price,markdown\n"
+                              "# weekly specials\n"
+                              "Soup,each,1.50\n"
+                              "\n"
+                              "Chips,each,2.00,,xfor,3,5.00\n"
+                              "Beef,lb,3.50,0.50,bxgy,2,1,0.5,3\n" );
+
+    ASSERT_EQ( OK, loader.loadStream( input, &report ) );
+    ASSERT_EQ( 3u, report.rows_loaded );
+    ASSERT_EQ( 0u, report.rows_failed );
+    ASSERT_TRUE( report.errors.empty() );
+
+    ASSERT_TRUE( catalog.isFixedItem( "Soup" ) );
+    ASSERT_TRUE( catalog.isFixedItem( "Chips" ) );
+    ASSERT_TRUE( catalog.isWeightItem( "Beef" ) );
+
+    Cart cart( catalog );
+    ASSERT_EQ( OK, cart.addToCart( "Chips", 3 ) );
+    ASSERT_EQ( OK, cart.addToCart( "Beef", 3.0 ) );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 5.00 + 2 * 3.00 + 1.50, .0001 );
+
+}
+
+TEST (CatalogLoaderTest, loadsTsvRowsWithWindowsLineEndings){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    std::istringstream input( "Soup\teach\t1.50\r\n"
+                              "Beef\tlb\t3.50\t\tbxgy\t1.0\t1.0\t0.25\r\n" );
+
+    ASSERT_EQ( OK, loader.loadStream( input, &report ) );
+    ASSERT_EQ( 2u, report.rows_loaded );
+
+    Cart cart( catalog );
+    ASSERT_EQ( OK, cart.addToCart( "Soup", 1 ) );
+    ASSERT_EQ( OK, cart.addToCart( "Beef", 2.0 ) );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 1.50 + 3.50 + 3.50 * 0.75, .0001 );
+
+}
+
+TEST (CatalogLoaderTest, reportsRejectedRows){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    std::istringstream input( "Soup,each,1.50\n"
+                              "Free,each,0\n"
+                              "Sale,each,1.00,2.00\n"
+                              "Tins,box,1.00\n"
+                              "Milk,each,abc\n"
+                              "Ham,lb,4.00,,xfor,2,7.00\n"
+                              "Jam,each,3.00,,bxgy,1,1,1.5\n"
+                              "Eggs,each,3.00,,bxgy,1.5,1,0.5\n"
+                              ",each,1.00\n"
+                              "Soup,lb,1.00\n"
+                              "Salt,each\n"
+                              "Tea,each,1.00,,xfor,2,1.50,3,4\n" );
+
+    ASSERT_EQ( ERROR, loader.loadStream( input, &report ) );
+    ASSERT_EQ( 1u, report.rows_loaded );
+    ASSERT_EQ( 11u, report.rows_failed );
+    ASSERT_EQ( 11u, report.errors.size() );
+
+    ReturnCode_t expected[] = { INVALID_PRICE, INVALID_PRICE, INVALID_ARG, INVALID_ARG, ITEM_CONFLICT, INVALID_DISCOUNT,
+                                INVALID_ARG, INVALID_SKU, ITEM_CONFLICT, INVALID_ARG, INVALID_ARG };
+    for(size_t i = 0; i < report.errors.size(); i++)
+    {
+        ASSERT_EQ( i + 2, report.errors[i].line );
+        ASSERT_EQ( expected[i], report.errors[i].code );
+    }
+
+    // rejected rows never register the sku
+    ASSERT_TRUE( catalog.isFixedItem( "Soup" ) );
+    ASSERT_FALSE( catalog.isFixedItem( "Free" ) );
+    ASSERT_FALSE( catalog.isWeightItem( "Ham" ) );
+
+}
+
+TEST (CatalogLoaderTest, headerOnlyOnFirstLine){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    std::istringstream input( "Soup,each,1.50\n"
+                              "SKU,type,price\n"
+                              "sku,each,2.00\n" );
+
+    // a row naming the sku "sku" past the first line is loaded, or reported, like any other
+    ASSERT_EQ( ERROR, loader.loadStream( input, &report ) );
+    ASSERT_EQ( 2u, report.rows_loaded );
+    ASSERT_EQ( 1u, report.rows_failed );
+    ASSERT_EQ( 2u, report.errors[0].line );
+    ASSERT_EQ( INVALID_ARG, report.errors[0].code );
+    ASSERT_TRUE( catalog.isFixedItem( "sku" ) );
+
+}
+
+TEST (CatalogLoaderTest, laterRowsReplaceEarlierRows){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    std::istringstream input( "Chips,each,2.00,,xfor,3,5.00\n"
+                              "Chips,each,2.50\n" );
+
+    catalog.setItemPrice( "Soup", 1.00 );
+    ASSERT_EQ( OK, loader.loadStream( input, 0 ) );
+
+    Cart cart( catalog );
+    ASSERT_EQ( OK, cart.addToCart( "Chips", 3 ) );
+    ASSERT_EQ( OK, cart.addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 8.50, .0001 );
+
+}
+
+TEST (CatalogLoaderTest, chunksAndThreadsDoNotChangeTheOutcome){
+
+    std::string contents = makePriceFile( 2000 );
+
+    Catalog single;
+    CatalogLoader single_loader( single );
+    LoadReport single_report;
+    std::istringstream single_input( contents );
+
+    single_loader.setThreadCount( 1 );
+    ASSERT_EQ( ERROR, single_loader.loadStream( single_input, &single_report ) );
+
+    Catalog chunked;
+    CatalogLoader chunked_loader( chunked );
+    LoadReport chunked_report;
+    std::istringstream chunked_input( contents );
+
+    chunked_loader.setThreadCount( 4 );
+    chunked_loader.setChunkSize( 1000 );
+    ASSERT_EQ( ERROR, chunked_loader.loadStream( chunked_input, &chunked_report ) );
+
+    ASSERT_EQ( 1600u, single_report.rows_loaded );
+    ASSERT_EQ( single_report.rows_loaded, chunked_report.rows_loaded );
+    ASSERT_EQ( single_report.errors.size(), chunked_report.errors.size() );
+    for(size_t i = 0; i < single_report.errors.size(); i++)
+    {
+        ASSERT_EQ( single_report.errors[i].line, chunked_report.errors[i].line );
+        ASSERT_EQ( single_report.errors[i].code, chunked_report.errors[i].code );
+    }
+
+    // the header is line 1, so the fifth row of the file is on line 6
+    ASSERT_EQ( 6u, chunked_report.errors[0].line );
+
+    Cart single_cart( single );
+    Cart chunked_cart( chunked );
+    for(size_t i = 0; i < 2000; i++)
+    {
+        std::string sku = "item" + std::to_string( i );
+        if(i % 5 == 1 || i % 5 == 3)
+        {
+            single_cart.addToCart( sku, 2.5 );
+            chunked_cart.addToCart( sku, 2.5 );
+        }
+        else
+        {
+            single_cart.addToCart( sku, 7 );
+            chunked_cart.addToCart( sku, 7 );
+        }
+    }
+
+    ASSERT_GT( single_cart.getPreTaxTotalMoney(), 0 );
+    ASSERT_EQ( single_cart.getPreTaxTotalMoney(), chunked_cart.getPreTaxTotalMoney() );
+
+}
+
+TEST (CatalogLoaderTest, lineLongerThanChunk){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    std::istringstream input( "Soup,each,1.50\nChips,each,2.00,,xfor,3,5.00\nBeef,lb,3.50" );
+
+    loader.setChunkSize( 4 );
+    ASSERT_EQ( OK, loader.loadStream( input, 0 ) );
+    ASSERT_TRUE( catalog.isFixedItem( "Soup" ) );
+    ASSERT_TRUE( catalog.isFixedItem( "Chips" ) );
+    ASSERT_TRUE( catalog.isWeightItem( "Beef" ) );
+
+}
+
+TEST (CatalogLoaderTest, readErrorIsReported){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    FailingBuffer buffer( "Soup,each,1.50\nChips,each,2.00\nBeef,lb,3." );
+    std::istream input( &buffer );
+
+    // the chunk that was cut short is dropped rather than loaded as if the file ended there
+    loader.setChunkSize( 16 );
+    ASSERT_EQ( ERROR, loader.loadStream( input, &report ) );
+    ASSERT_EQ( 0u, report.rows_failed );
+    ASSERT_TRUE( catalog.isFixedItem( "Soup" ) );
+    ASSERT_FALSE( catalog.isWeightItem( "Beef" ) );
+
+}
+
+TEST (CatalogLoaderTest, loadFile){
+
+    Catalog catalog;
+    CatalogLoader loader( catalog );
+    LoadReport report;
+    std::string path = ::testing::TempDir() + "catalog_loader_test.csv";
+
+    ASSERT_EQ( INVALID_ARG, loader.loadFile( ::testing::TempDir() + "missing/prices.csv", &report ) );
+    ASSERT_EQ( 0u, report.rows_loaded );
+
+    FILE* file = std::fopen( path.c_str(), "w" );
+    ASSERT_TRUE( file != 0 );
+    std::fputs( "Soup,each,1.50\nBeef,lb,3.50\n", file );
+    std::fclose( file );
+
+    ASSERT_EQ( OK, loader.loadFile( path, &report ) );
+    ASSERT_EQ( 2u, report.rows_loaded );
+    ASSERT_GE( report.seconds, 0.0 );
+    ASSERT_TRUE( catalog.isWeightItem( "Beef" ) );
+
+    std::remove( path.c_str() );
+
+}
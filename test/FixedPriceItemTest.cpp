@@ -400,4 +400,48 @@ TEST (FixedPriceItemTest, buyNForXInvalidatedByItemRemoval){
     ASSERT_EQ( OK, item.computePreTax( &tax ));
     ASSERT_NEAR( tax, 9.0, .01 );
 
-}
\ No newline at end of file
+}
+
+TEST (FixedPriceItemTest, buyNGetMOffLimitLargerThanCart){
+
+    double tax = 0.0;
+    CartItem<int> item;
+    ASSERT_EQ( OK, item.setPrice(1.0));
+    ASSERT_EQ( OK, item.addToCart( 6 ) );
+    ASSERT_EQ( OK, item.applyBuyXGetYDiscount( 4, 10, 0.5, 10 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 5.0, .01 ); // 4 + 2 * 0.5
+
+}
+
+TEST (FixedPriceItemTest, buyNGetMOffLargeQuantity){
+
+    double tax = 0.0;
+    CartItem<int> item;
+    ASSERT_EQ( OK, item.setPrice(1.0));
+    ASSERT_EQ( OK, item.addToCart( 100000 ) );
+    ASSERT_EQ( OK, item.applyBuyXGetYDiscount( 4, 2, 0.5 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 83334.0, .01 ); // 16666 full cycles plus 4 full price items
+
+    ASSERT_EQ( OK, item.applyBuyXGetYDiscount( 4, 2, 0.5, 50001 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 91667.0, .01 ); // 8333 cycles below the limit and 4 more full price items
+
+}
+
+TEST (FixedPriceItemTest, buyNForXLargeQuantity){
+
+    double tax = 0.0;
+    CartItem<int> item;
+    ASSERT_EQ( OK, item.setPrice(1.0));
+    ASSERT_EQ( OK, item.addToCart( 100001 ) );
+    ASSERT_EQ( OK, item.applyGetXforPriceDiscount( 3, 2.0 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 66668.0, .01 ); // 33333 bundles plus 2 full price items
+
+    ASSERT_EQ( OK, item.applyGetXforPriceDiscount( 3, 2.0, 1000 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 99668.0, .01 ); // 333 bundles plus 99002 full price items
+
+}
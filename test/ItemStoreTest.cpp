@@ -0,0 +1,310 @@
+#include "gtest/gtest.h"
+#include "ItemStore.h"
+#include "Catalog.h"
+#include "Cart.h"
+
+TEST (ItemStoreTest, itemsCopiedInAndOut){
+
+    ItemStore<double> items;
+    CatalogItem<double> beef;
+
+    ASSERT_EQ( OK, beef.setPrice( 4.00 ) );
+    ASSERT_EQ( OK, beef.applyMarkdown( 0.50 ) );
+    ASSERT_EQ( OK, beef.applyBuyXGetYDiscount( 2.0, 1.0, 0.5, 6.0 ) );
+
+    ASSERT_EQ( 0u, items.append( CatalogItem<double>() ) );
+    ASSERT_EQ( 1u, items.append( beef ) );
+    ASSERT_EQ( 2u, items.size() );
+    ASSERT_FALSE( items.isPriceSet( 0 ) );
+    ASSERT_TRUE( items.isPriceSet( 1 ) );
+
+    // the copy taken out prices exactly the same as the original
+    Money expected = 0;
+    Money stored = 0;
+    Money copied = 0;
+    ASSERT_EQ( OK, beef.computePreTax( 7500, &expected ) );
+    ASSERT_EQ( OK, items.computePreTax( 1, 7500, &stored ) );
+    ASSERT_EQ( OK, items.get( 1 ).computePreTax( 7500, &copied ) );
+    ASSERT_EQ( expected, stored );
+    ASSERT_EQ( expected, copied );
+
+}
+
+TEST (ItemStoreTest, totalsMatchSingleItems){
+
+    ItemStore<int> items;
+    std::vector<Quantity> amounts;
+
+    for(int i = 0; i < 50; i++)
+    {
+        CatalogItem<int> item;
+        item.setPrice( 0.99 + i );
+        if(i % 3 == 0)
+        {
+            item.applyGetXforPriceDiscount( 3, 2.00 + i, 9 );
+        }
+        else if(i % 3 == 1)
+        {
+            item.applyBuyXGetYDiscount( 1, 1, 0.25 );
+        }
+
+        items.append( item );
+        amounts.push_back( i % 11 );
+    }
+
+    std::vector<Money> totals( amounts.size() );
+    Money total = items.computeTotals( amounts.data(), totals.data(), amounts.size() );
+
+    Money sum = 0;
+    for(uint32_t i = 0; i < amounts.size(); i++)
+    {
+        Money line = 0;
+        items.computePreTax( i, amounts[i], &line );
+        ASSERT_EQ( line, totals[i] );
+        sum += line;
+    }
+
+    ASSERT_EQ( sum, total );
+
+}
+
+TEST (ItemStoreTest, refreshAllMatchesRefreshingEachItem){
+
+    Catalog catalog;
+    catalog.setItemPrice( "Soup", 1.50 );
+    catalog.setItemPrice( "Chips", 2.00 );
+    catalog.setPerPoundPrice( "Beef", 3.50 );
+
+    Cart each( catalog );
+    Cart all( catalog );
+    for(Cart* cart : { &each, &all })
+    {
+        cart->addToCart( "Soup", 4 );
+        cart->addToCart( "Chips", 3 );
+        cart->addToCart( "Beef", 2.25 );
+    }
+
+    catalog.applyGetXForYDiscount( "Chips", 3, 5.00 );
+    catalog.applyBuyXGetYAtDiscount( "Beef", 1.0, 1.0, 0.5 );
+
+    each.refreshItem( "Chips" );
+    each.refreshItem( "Beef" );
+    all.refreshAll();
+
+    ASSERT_EQ( each.getPreTaxTotalMoney(), all.getPreTaxTotalMoney() );
+    ASSERT_NEAR( all.getPreTaxTotal(), 6.00 + 5.00 + 3.50 * 1.25 + 1.75, .0001 );
+
+}
+
+TEST (ItemStoreTest, discountsReplacedAcrossTypes){
+
+    ItemStore<int> items;
+    CatalogItem<int> chips;
+    CatalogItem<int> soup;
+
+    ASSERT_EQ( OK, chips.setPrice( 2.00 ) );
+    ASSERT_EQ( OK, chips.applyGetXforPriceDiscount( 3, 5.00 ) );
+    ASSERT_EQ( OK, soup.setPrice( 1.50 ) );
+    ASSERT_EQ( OK, soup.applyBuyXGetYDiscount( 1, 1, 1.0, 4 ) );
+
+    items.append( chips );
+    items.append( soup );
+
+    // each change moves the item between pools, or rewrites its place within one
+    ASSERT_EQ( OK, chips.applyBuyXGetYDiscount( 2, 1, 0.5 ) );
+    items.set( 0, chips );
+    ASSERT_EQ( OK, soup.applyBuyXGetYDiscount( 2, 2, 0.25 ) );
+    items.set( 1, soup );
+    ASSERT_EQ( OK, chips.applyGetXforPriceDiscount( 0, 1.00 ) );
+    items.set( 0, chips );
+
+    ASSERT_EQ( NO_DISCOUNT, getDiscountType( items.get( 0 ).getDiscount() ) );
+    ASSERT_EQ( BUY_X_GET_Y_FOR_Z_LIMIT_W, getDiscountType( items.get( 1 ).getDiscount() ) );
+
+    Money stored = 0;
+    Money expected = 0;
+    for(Quantity amount = 0; amount < 10; amount++)
+    {
+        ASSERT_EQ( OK, items.computePreTax( 0, amount, &stored ) );
+        ASSERT_EQ( OK, chips.computePreTax( amount, &expected ) );
+        ASSERT_EQ( expected, stored );
+        ASSERT_EQ( OK, items.computePreTax( 1, amount, &stored ) );
+        ASSERT_EQ( OK, soup.computePreTax( amount, &expected ) );
+        ASSERT_EQ( expected, stored );
+    }
+
+}
+
+TEST (ItemStoreTest, poolEntriesReused){
+
+    ItemStore<int> items;
+    CatalogItem<int> chips;
+    CatalogItem<int> soup;
+
+    ASSERT_EQ( OK, chips.setPrice( 2.00 ) );
+    ASSERT_EQ( OK, soup.setPrice( 1.50 ) );
+    items.append( chips );
+    items.append( soup );
+
+    // moving items back and forth between types takes no more entries than the items hold at once
+    for(int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ( OK, chips.applyGetXforPriceDiscount( 3, 5.00 - i * 0.01 ) );
+        ASSERT_EQ( OK, soup.applyBuyXGetYDiscount( 1, 1, 0.5 ) );
+        items.set( 0, chips );
+        items.set( 1, soup );
+
+        ASSERT_EQ( OK, chips.applyBuyXGetYDiscount( 2, 1, 0.5 ) );
+        ASSERT_EQ( OK, soup.applyGetXforPriceDiscount( 2, 2.50 ) );
+        items.set( 0, chips );
+        items.set( 1, soup );
+    }
+
+    ASSERT_EQ( 2u, items.getPoolSize( X_FOR_FLAT ) );
+    ASSERT_EQ( 2u, items.getPoolSize( BUY_X_GET_Y_FOR_Z_LIMIT_W ) );
+
+    Money stored = 0;
+    Money expected = 0;
+    for(Quantity amount = 0; amount < 10; amount++)
+    {
+        ASSERT_EQ( OK, items.computePreTax( 0, amount, &stored ) );
+        ASSERT_EQ( OK, chips.computePreTax( amount, &expected ) );
+        ASSERT_EQ( expected, stored );
+        ASSERT_EQ( OK, items.computePreTax( 1, amount, &stored ) );
+        ASSERT_EQ( OK, soup.computePreTax( amount, &expected ) );
+        ASSERT_EQ( expected, stored );
+    }
+
+}
+
+TEST (ItemStoreTest, priceTablesMatchTheDiscount){
+
+    ItemStore<int> items;
+    ItemStore<int> plain;
+
+    items.setPriceTables( 20, 2 );
+    for(int i = 0; i < 4; i++)
+    {
+        CatalogItem<int> item;
+        item.setPrice( 1.99 + i );
+        if(i % 2 == 0)
+        {
+            item.applyGetXforPriceDiscount( 3, 5.00, 9 );
+        }
+        else
+        {
+            item.applyBuyXGetYDiscount( 2, 1, 0.5, 6 );
+        }
+        items.append( item );
+        plain.append( item );
+    }
+
+    // only the first two discounted items are given a table
+    ASSERT_EQ( 2u, items.getPriceTableCount() );
+
+    // a markdown changes every price held by the table
+    CatalogItem<int> changed = items.get( 0 );
+    ASSERT_EQ( OK, changed.applyMarkdown( 0.49 ) );
+    items.set( 0, changed );
+    plain.set( 0, changed );
+
+    // removing a discount hands the table on to the next item given one
+    CatalogItem<int> removed = items.get( 1 );
+    ASSERT_EQ( OK, removed.applyBuyXGetYDiscount( 0, 0, 0.5 ) );
+    items.set( 1, removed );
+    plain.set( 1, removed );
+    ASSERT_EQ( 1u, items.getPriceTableCount() );
+
+    CatalogItem<int> added = items.get( 3 );
+    ASSERT_EQ( OK, added.applyGetXforPriceDiscount( 4, 6.00 ) );
+    items.set( 3, added );
+    plain.set( 3, added );
+    ASSERT_EQ( 2u, items.getPriceTableCount() );
+
+    // amounts inside and beyond the tables price the same as the evaluator
+    for(uint32_t index = 0; index < items.size(); index++)
+    {
+        for(Quantity amount = 0; amount < 30; amount++)
+        {
+            Money tabled = 0;
+            Money evaluated = 0;
+            ASSERT_EQ( OK, items.computePreTax( index, amount, &tabled ) );
+            ASSERT_EQ( OK, plain.computePreTax( index, amount, &evaluated ) );
+            ASSERT_EQ( evaluated, tabled );
+        }
+    }
+
+    items.setPriceTables( 0, 2 );
+    ASSERT_EQ( 0u, items.getPriceTableCount() );
+
+}
+
+TEST (ItemStoreTest, stackedPriceTablesMatchTheDiscount){
+
+    ItemStore<int> items;
+    ItemStore<int> plain;
+    CatalogItem<int> item;
+
+    ASSERT_EQ( OK, item.setPrice( 1.99 ) );
+    ASSERT_EQ( OK, item.applyGetXforPriceDiscount( 3, 5.00, 9 ) );
+    ASSERT_EQ( OK, item.addGetXforPriceDiscount( 7, 10.00 ) );
+    ASSERT_EQ( OK, item.addBuyXGetYDiscount( 2, 1, 0.9, 12 ) );
+    ASSERT_EQ( OK, item.addBuyXGetYDiscount( 4, 3, 0.5 ) );
+
+    items.setPriceTables( 100, 1 );
+    items.append( item );
+    plain.append( item );
+    ASSERT_EQ( 1u, items.getPriceTableCount() );
+
+    // the whole table is worked out in one pass, and must give what pricing each amount on its own gives
+    for(int change = 0; change < 2; change++)
+    {
+        for(Quantity amount = 0; amount <= 120; amount++)
+        {
+            Money tabled = 0;
+            Money evaluated = 0;
+            ASSERT_EQ( OK, items.computePreTax( 0, amount, &tabled ) );
+            ASSERT_EQ( OK, plain.computePreTax( 0, amount, &evaluated ) );
+            ASSERT_EQ( evaluated, tabled ) << amount;
+        }
+
+        ASSERT_EQ( OK, item.applyMarkdown( 0.40 ) );
+        items.set( 0, item );
+        plain.set( 0, item );
+    }
+
+}
+
+TEST (ItemStoreTest, copiesAreIndependent){
+
+    ItemStore<int> items;
+    CatalogItem<int> soup;
+    CatalogItem<int> chips;
+
+    ASSERT_EQ( OK, soup.setPrice( 1.50 ) );
+    ASSERT_EQ( OK, chips.setPrice( 2.00 ) );
+    ASSERT_EQ( OK, chips.applyGetXforPriceDiscount( 3, 5.00, 6 ) );
+    items.append( soup );
+    items.append( chips );
+    items.setPriceTables( 10, 4 );
+
+    // the copy shares the arrays of the original until one of them is changed
+    ItemStore<int> copy( items );
+    ASSERT_EQ( OK, soup.applyMarkdown( 0.50 ) );
+    ASSERT_EQ( OK, chips.applyBuyXGetYDiscount( 1, 1, 0.5 ) );
+    copy.set( 0, soup );
+    copy.set( 1, chips );
+
+    Money original = 0;
+    Money changed = 0;
+    ASSERT_EQ( OK, items.computePreTax( 0, 2, &original ) );
+    ASSERT_EQ( OK, copy.computePreTax( 0, 2, &changed ) );
+    ASSERT_EQ( 30000, original );
+    ASSERT_EQ( 20000, changed );
+
+    ASSERT_EQ( OK, items.computePreTax( 1, 4, &original ) );
+    ASSERT_EQ( OK, copy.computePreTax( 1, 4, &changed ) );
+    ASSERT_EQ( 70000, original );
+    ASSERT_EQ( 60000, changed );
+
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include "Money.h"
+#include "PointOfSale.h"
+
+TEST (MoneyTest, dollarsRoundToNearestUnit){
+
+    ASSERT_EQ( 19900, toMoney( 1.99 ) );
+    ASSERT_EQ( 1, toMoney( 0.00005 ) );
+    ASSERT_EQ( 0, toMoney( 0.00004 ) );
+    ASSERT_EQ( -1, toMoney( -0.00005 ) );
+    ASSERT_DOUBLE_EQ( 1.99, toDollars( 19900 ) );
+
+}
+
+TEST (MoneyTest, poundsRoundToNearestMilliPound){
+
+    ASSERT_EQ( 1234, toQuantity( 1.234 ) );
+    ASSERT_EQ( 1, toQuantity( 0.0005 ) );
+    ASSERT_EQ( 0, toQuantity( 0.0004 ) );
+    ASSERT_EQ( 7, toQuantity( 7 ) );
+
+}
+
+TEST (MoneyTest, scaleRoundsHalfAwayFromZero){
+
+    ASSERT_EQ( 3, scaleMoney( 5, 1, 2 ) );
+    ASSERT_EQ( 2, scaleMoney( 7, 1, 3 ) );
+    ASSERT_EQ( -3, scaleMoney( -5, 1, 2 ) );
+    ASSERT_EQ( 49237, scaleMoney( 39900, 1234, 1000 ) );
+
+}
+
+TEST (MoneyTest, scaleDoesNotOverflow){
+
+    // the intermediate product is far beyond the range of 64 bits
+    ASSERT_EQ( 4000000000000000000LL, scaleMoney( 4000000000000000000LL, RATE_SCALE, RATE_SCALE ) );
+
+    // results beyond the range of Money are held at its ends, for whole items as well as rounded ones
+    ASSERT_EQ( INT64_MAX, scaleMoney( 4000000000000000000LL, 3, 1 ) );
+    ASSERT_EQ( INT64_MIN, scaleMoney( -4000000000000000000LL, 3, 1 ) );
+    ASSERT_EQ( INT64_MAX, scaleMoney( 4000000000000000000LL, 3000, 1000 ) );
+    ASSERT_EQ( INT64_MIN, scaleMoney( 4000000000000000000LL, -3000, 1000 ) );
+
+}
+
+TEST (MoneyTest, weightRemovedExactlyMatchesWeightAdded){
+
+    PointOfSale sale;
+    sale.setPerPoundPrice( "beef", 3.99 );
+
+    for(int i = 0; i < 10; i++)
+    {
+        ASSERT_EQ( OK, sale.addToCart( "beef", 0.1 ) );
+    }
+
+    // ten tenths of a pound is exactly one pound
+    ASSERT_EQ( OK, sale.removeFromCart( "beef", 1.0 ) );
+    ASSERT_EQ( 0, sale.getPreTaxTotalMoney() );
+
+}
+
+TEST (MoneyTest, weightTooSmallToRepresentIsRejected){
+
+    PointOfSale sale;
+    sale.setPerPoundPrice( "beef", 3.99 );
+
+    ASSERT_EQ( INVALID_ARG, sale.addToCart( "beef", 0.0001 ) );
+
+}
+
+TEST (MoneyTest, totalIndependentOfScanOrder){
+
+    PointOfSale forward;
+    PointOfSale backward;
+    const char* skus[] = { "a", "b", "c", "d", "e" };
+    const double weights[] = { 0.333, 1.777, 2.015, 0.001, 9.999 };
+
+    for(PointOfSale* sale : { &forward, &backward })
+    {
+        for(int i = 0; i < 5; i++)
+        {
+            sale->setPerPoundPrice( skus[i], 1.11 * (i + 1) );
+        }
+    }
+
+    for(int i = 0; i < 5; i++)
+    {
+        ASSERT_EQ( OK, forward.addToCart( skus[i], weights[i] ) );
+        ASSERT_EQ( OK, backward.addToCart( skus[4 - i], weights[4 - i] ) );
+    }
+
+    ASSERT_EQ( forward.getPreTaxTotalMoney(), backward.getPreTaxTotalMoney() );
+
+}
+
+TEST (MoneyTest, linesRoundedToNearestUnit){
+
+    PointOfSale sale;
+    sale.setPerPoundPrice( "beef", 3.99 );
+    sale.setItemPrice( "soup", 1.00 );
+    sale.applyBuyXGetYAtDiscount( "soup", 1, 1, 1.0 / 3.0 );
+
+    // 3.99 per pound for 1.234 pounds is 4.92366, rounded to 4.9237
+    ASSERT_EQ( OK, sale.addToCart( "beef", 1.234 ) );
+    ASSERT_EQ( 49237, sale.getPreTaxTotalMoney() );
+
+    // the second soup is 0.666667 after a third off, rounded to 0.6667
+    ASSERT_EQ( OK, sale.addToCart( "soup", 2 ) );
+    ASSERT_EQ( 49237 + 10000 + 6667, sale.getPreTaxTotalMoney() );
+
+}
@@ -0,0 +1,164 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+#include "OperationStats.h"
+
+#if POS_STATS
+
+TEST (OperationStatsTest, countsEveryCallByCode){
+
+    PointOfSale sale;
+    PointOfSaleStats stats;
+
+    sale.setItemPrice( "Soup", 1.50 );
+    sale.setPerPoundPrice( "Beef", 3.50 );
+
+    ASSERT_EQ( OK, sale.addToCart( "Soup", 2 ) );
+    ASSERT_EQ( OK, sale.addToCart( sale.resolveSku( "Beef" ), 1.5 ) );
+    ASSERT_EQ( NO_PRICE_DEFINED, sale.addToCart( "Bread", 1 ) );
+    ASSERT_EQ( ITEM_CONFLICT, sale.addToCart( "Soup", 1.0 ) );
+    ASSERT_EQ( OK, sale.removeFromCart( "Soup", 1 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( "Beef", 5.0 ) );
+    sale.getPreTaxTotal();
+    sale.getPreTaxTotalMoney();
+    sale.getPreTaxTotal();
+
+    ASSERT_EQ( OK, sale.getStats( &stats ) );
+
+    const OperationSummary& add = stats.operations[STATS_ADD_TO_CART];
+    ASSERT_EQ( 4u, add.count );
+    ASSERT_EQ( 2u, add.codes[OK] );
+    ASSERT_EQ( 1u, add.codes[NO_PRICE_DEFINED] );
+    ASSERT_EQ( 1u, add.codes[ITEM_CONFLICT] );
+
+    const OperationSummary& remove = stats.operations[STATS_REMOVE_FROM_CART];
+    ASSERT_EQ( 2u, remove.count );
+    ASSERT_EQ( 1u, remove.codes[OK] );
+    ASSERT_EQ( 1u, remove.codes[ITEM_NOT_IN_CART] );
+
+    const OperationSummary& total = stats.operations[STATS_GET_PRE_TAX_TOTAL];
+    ASSERT_EQ( 3u, total.count );
+    ASSERT_EQ( 3u, total.codes[OK] );
+
+}
+
+TEST (OperationStatsTest, batchesCountedOnce){
+
+    PointOfSale sale;
+    PointOfSaleStats stats;
+
+    sale.setItemPrice( "Soup", 1.50 );
+    sale.setPerPoundPrice( "Beef", 3.50 );
+
+    ScanRecord basket[] = { { "Soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 2 },
+                            { "Beef", INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 1.5 } };
+    ScanRecord rejected[] = { { "Soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+                              { "Bread", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 } };
+    ReturnCode_t codes[2];
+
+    ASSERT_EQ( OK, sale.addToCartBatch( basket, 2, codes ) );
+    ASSERT_EQ( ERROR, sale.addToCartBatch( rejected, 2, codes ) );
+    ASSERT_EQ( NO_PRICE_DEFINED, codes[1] );
+
+    ASSERT_EQ( OK, sale.getStats( &stats ) );
+
+    const OperationSummary& batch = stats.operations[STATS_ADD_TO_CART_BATCH];
+    ASSERT_EQ( 2u, batch.count );
+    ASSERT_EQ( 1u, batch.codes[OK] );
+    ASSERT_EQ( 1u, batch.codes[ERROR] );
+    ASSERT_GT( batch.latency_max, 0 );
+
+    // the records of a batch are not counted as single scans
+    ASSERT_EQ( 0u, stats.operations[STATS_ADD_TO_CART].count );
+
+}
+
+TEST (OperationStatsTest, percentilesAreOrdered){
+
+    PointOfSale sale;
+    PointOfSaleStats stats;
+
+    sale.setItemPrice( "Soup", 1.50 );
+    for(int i = 0; i < 10000; i++)
+    {
+        sale.addToCart( "Soup", 1 );
+        sale.removeFromCart( "Soup", 1 );
+    }
+
+    ASSERT_EQ( OK, sale.getStats( &stats ) );
+
+    for(const OperationSummary& summary : { stats.operations[STATS_ADD_TO_CART], stats.operations[STATS_REMOVE_FROM_CART] })
+    {
+        ASSERT_EQ( 10000u, summary.count );
+        ASSERT_GT( summary.latency_max, 0 );
+        ASSERT_LE( summary.latency_p50, summary.latency_p99 );
+        ASSERT_LE( summary.latency_p99, summary.latency_p999 );
+        ASSERT_LE( summary.latency_p999, summary.latency_max );
+    }
+
+    // nothing has been recorded for the total, so there is nothing to report
+    ASSERT_EQ( 0u, stats.operations[STATS_GET_PRE_TAX_TOTAL].count );
+    ASSERT_EQ( 0, stats.operations[STATS_GET_PRE_TAX_TOTAL].latency_max );
+
+}
+
+TEST (OperationStatsTest, threadsAreCombined){
+
+    PointOfSale sale;
+    PointOfSaleStats stats;
+    std::vector<std::thread> threads;
+
+    sale.setItemPrice( "Soup", 1.50 );
+    sale.addToCart( "Soup", 3 );
+
+    // totalling only reads the cart, so any number of threads may do it at once
+    for(int t = 0; t < 4; t++)
+    {
+        threads.emplace_back( [&sale]() {
+            for(int i = 0; i < 5000; i++)
+            {
+                sale.getPreTaxTotalMoney();
+            }
+        } );
+    }
+
+    // snapshots may be taken while the calls are being made
+    for(int i = 0; i < 10; i++)
+    {
+        ASSERT_EQ( OK, sale.getStats( &stats ) );
+        ASSERT_LE( stats.operations[STATS_GET_PRE_TAX_TOTAL].count, 20000u );
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ( OK, sale.getStats( &stats ) );
+    ASSERT_EQ( 20000u, stats.operations[STATS_GET_PRE_TAX_TOTAL].count );
+    ASSERT_EQ( 1u, stats.operations[STATS_ADD_TO_CART].count );
+
+}
+
+TEST (OperationStatsTest, nullSnapshotRejected){
+
+    PointOfSale sale;
+
+    ASSERT_EQ( INVALID_ARG, sale.getStats( 0 ) );
+
+}
+
+#else
+
+TEST (OperationStatsTest, unavailableWhenCompiledOut){
+
+    PointOfSale sale;
+    PointOfSaleStats stats;
+
+    ASSERT_EQ( ERROR, sale.getStats( &stats ) );
+
+}
+
+#endif
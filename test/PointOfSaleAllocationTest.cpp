@@ -0,0 +1,241 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+
+// Every heap allocation made by the test application passes through the
+// replacements below so that the tests can verify when none take place, and
+// that everything allocated is released again. The counters are atomic since
+// other tests within the application allocate from several threads.
+static std::atomic<size_t> allocation_count( 0 );
+static std::atomic<size_t> live_allocations( 0 );
+
+void* operator new( size_t size )
+{
+    allocation_count++;
+    live_allocations++;
+
+    void* p = std::malloc( size == 0 ? 1 : size );
+    if(p == 0)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void* p ) noexcept
+{
+    live_allocations -= (p != 0) ? 1 : 0;
+    std::free( p );
+}
+
+void operator delete[]( void* p ) noexcept
+{
+    live_allocations -= (p != 0) ? 1 : 0;
+    std::free( p );
+}
+
+void operator delete( void* p, size_t ) noexcept
+{
+    live_allocations -= (p != 0) ? 1 : 0;
+    std::free( p );
+}
+
+void operator delete[]( void* p, size_t ) noexcept
+{
+    live_allocations -= (p != 0) ? 1 : 0;
+    std::free( p );
+}
+
+class AllocationTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       sale.setItemPrice( "012345678905", 2.00 );
+       sale.setItemPrice( "036000291452", 1.25 );
+       sale.setPerPoundPrice( "4011", 0.59 );
+
+       // the first scan of an item sizes the cart for it, so scan each once
+       // before any allocations are counted
+       sale.addToCart( "012345678905", 1 );
+       sale.addToCart( "036000291452", 1 );
+       sale.addToCart( "4011", 1.0 );
+   }
+
+   PointOfSale sale;
+};
+
+TEST_F (AllocationTest, scanLiteralSkuDoesNotAllocate){
+
+    size_t before = allocation_count;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ( OK, sale.addToCart( "012345678905", 1 ) );
+        ASSERT_EQ( OK, sale.addToCart( "4011", 0.5 ) );
+        ASSERT_EQ( OK, sale.removeFromCart( "012345678905", 1 ) );
+        ASSERT_EQ( OK, sale.removeFromCart( "4011", 0.5 ) );
+        sale.getPreTaxTotal();
+    }
+
+    ASSERT_EQ( before, allocation_count );
+
+}
+
+TEST_F (AllocationTest, scanBarcodeBufferDoesNotAllocate){
+
+    // scanners hand over barcodes as character buffers
+    char barcode[32];
+    std::strcpy( barcode, "036000291452" );
+
+    size_t before = allocation_count;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ( OK, sale.addToCart( barcode, 1 ) );
+        ASSERT_EQ( ITEM_CONFLICT, sale.addToCart( barcode, 1.0 ) );
+        ASSERT_EQ( NO_PRICE_DEFINED, sale.addToCart( "999999999999", 1 ) );
+    }
+
+    ASSERT_EQ( before, allocation_count );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 1253.84, .01 );
+
+}
+
+TEST_F (AllocationTest, repeatedBatchesDoNotAllocate){
+
+    ScanRecord records[] = {
+        { "012345678905", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 2 },
+        { "4011", INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 1.25 },
+        { "036000291452", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "012345678905", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+    };
+    ReturnCode_t codes[4];
+
+    // the first batch sizes the lists used to track the changed lines
+    ASSERT_EQ( OK, sale.addToCartBatch( records, 4, codes ) );
+
+    size_t before = allocation_count;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ( OK, sale.addToCartBatch( records, 4, codes ) );
+    }
+
+    ASSERT_EQ( before, allocation_count );
+
+}
+
+TEST_F (AllocationTest, largeStackedWeightDoesNotAllocate){
+
+    // cycles of 3 and 2.5 pounds only line up every 15 pounds, which gives about as wide a range as a stack may have
+    ASSERT_EQ( OK, sale.setPerPoundPrice( "Rice", 1.00 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Rice", 2.0, 1.0, 0.9 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Rice", 1.5, 1.0, 0.5 ) );
+
+    // the first line sizes the space the thread prices stacks with
+    ASSERT_EQ( OK, sale.addToCart( "Rice", 200000.0 ) );
+
+    size_t before = allocation_count;
+
+    for(int i = 0; i < 20; i++)
+    {
+        ASSERT_EQ( OK, sale.addToCart( "Rice", 1000.0 + i ) );
+        ASSERT_EQ( OK, sale.removeFromCart( "Rice", 1000.0 + i ) );
+        ASSERT_EQ( OK, sale.addToCart( "Rice", 7.5 ) );
+    }
+
+    ASSERT_EQ( before, allocation_count );
+
+}
+
+TEST (AllocationLifetimeTest, destroyingSaleReleasesEverything){
+
+    size_t before = live_allocations;
+
+    for(int round = 0; round < 10; round++)
+    {
+        PointOfSale other;
+        char sku[32];
+
+        for(int i = 0; i < 200; i++)
+        {
+            std::snprintf( sku, sizeof(sku), "SKU%d", i );
+            if(i % 4 == 0)
+            {
+                other.setPerPoundPrice( sku, 1.99 );
+                other.applyBuyXGetYAtDiscount( sku, 1.0, 1.0, 0.5 );
+                other.addToCart( sku, 2.5 );
+            }
+            else
+            {
+                other.setItemPrice( sku, 1.00 );
+                other.applyGetXForYDiscount( sku, 3, 2.00 );
+                other.addToCart( sku, 4 );
+            }
+        }
+    }
+
+    ASSERT_EQ( before, live_allocations );
+
+}
+
+TEST_F (AllocationTest, newTransactionDoesNotAllocate){
+
+    size_t before = allocation_count;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        sale.newTransaction();
+        ASSERT_EQ( OK, sale.addToCart( "012345678905", 2 ) );
+        ASSERT_EQ( OK, sale.addToCart( "4011", 0.5 ) );
+    }
+
+    ASSERT_EQ( before, allocation_count );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 4.30, .01 );
+
+}
+
+TEST (AllocationLifetimeTest, cartArenaKeepsScansOffTheHeap){
+
+    // the lane hands the cart a fixed buffer with no way to ask the heap for more
+    static char buffer[1 << 16];
+    std::pmr::monotonic_buffer_resource lane_memory( buffer, sizeof(buffer), std::pmr::null_memory_resource() );
+    PointOfSale other( &lane_memory );
+    char sku[32];
+
+    for(int i = 0; i < 500; i++)
+    {
+        std::snprintf( sku, sizeof(sku), "SKU%d", i );
+        other.setItemPrice( sku, 1.00 );
+    }
+
+    // every scan below is the first of its item, so the cart grows throughout
+    size_t before = allocation_count;
+
+    for(int round = 0; round < 3; round++)
+    {
+        for(int i = 0; i < 500; i++)
+        {
+            std::snprintf( sku, sizeof(sku), "SKU%d", i );
+            ASSERT_EQ( OK, other.addToCart( sku, 1 ) );
+        }
+
+        other.newTransaction();
+    }
+
+    ASSERT_EQ( before, allocation_count );
+
+}
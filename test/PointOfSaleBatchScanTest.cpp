@@ -0,0 +1,115 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+
+class BatchScanTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       for(PointOfSale* sale : { &batch, &single })
+       {
+           sale->setItemPrice( "soup", 1.25 );
+           sale->setItemPrice( "chips", 2.00 );
+           sale->setPerPoundPrice( "beef", 3.99 );
+           sale->applyGetXForYDiscount( "chips", 3, 5.00 );
+           sale->applyBuyXGetYAtDiscount( "beef", 1.0, 1.0, 0.5 );
+       }
+   }
+
+   // applies the records through the single item calls for comparison
+   std::vector<ReturnCode_t> addOneAtATime( const std::vector<ScanRecord>& records )
+   {
+       std::vector<ReturnCode_t> codes;
+
+       for(const ScanRecord& record : records)
+       {
+           if(record.handle != INVALID_SKU_HANDLE && record.type == FIXED_PRICE_ITEM)
+           {
+               codes.push_back( single.addToCart( record.handle, static_cast<int>( record.amount ) ) );
+           }
+           else if(record.handle != INVALID_SKU_HANDLE)
+           {
+               codes.push_back( single.addToCart( record.handle, record.amount ) );
+           }
+           else if(record.type == FIXED_PRICE_ITEM)
+           {
+               codes.push_back( single.addToCart( record.sku, static_cast<int>( record.amount ) ) );
+           }
+           else
+           {
+               codes.push_back( single.addToCart( record.sku, record.amount ) );
+           }
+       }
+
+       return codes;
+   }
+
+   PointOfSale batch;
+   PointOfSale single;
+};
+
+TEST_F (BatchScanTest, emptyBatch){
+
+    ASSERT_EQ( OK, batch.addToCartBatch( 0, 0, 0 ) );
+    ASSERT_NEAR( batch.getPreTaxTotal(), 0.0, .001 );
+
+}
+
+TEST_F (BatchScanTest, repeatedItemsMatchSingleScans){
+
+    std::vector<ScanRecord> records = {
+        { "chips", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 2 },
+        { "beef", INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 0.75 },
+        { "chips", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 2 },
+        { "", batch.resolveSku( "beef" ), WEIGHT_BASED_ITEM, 1.5 },
+        { "chips", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+    };
+    std::vector<ReturnCode_t> codes( records.size() );
+
+    ASSERT_EQ( OK, batch.addToCartBatch( records.data(), records.size(), codes.data() ) );
+    ASSERT_EQ( addOneAtATime( records ), codes );
+    ASSERT_EQ( single.getPreTaxTotalMoney(), batch.getPreTaxTotalMoney() );
+
+    // 4 chips, 2 soup and 2.25 pounds of beef with one pound at half price
+    ASSERT_NEAR( batch.getPreTaxTotal(), 5.00 + 2.00 + 2.50 + 3.99 * 1.25 + 1.995, .0001 );
+
+}
+
+TEST_F (BatchScanTest, failedRecordsReportedAndSkipped){
+
+    std::vector<ScanRecord> records = {
+        { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "candy", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "beef", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+        { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1.5 },
+        { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, -1 },
+        { "beef", INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 0.0 },
+        { "", 0x7FFFFFF0u, FIXED_PRICE_ITEM, 1 },
+        { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1 },
+    };
+    std::vector<ReturnCode_t> codes( records.size() );
+    std::vector<ReturnCode_t> expected = { OK, INVALID_SKU, NO_PRICE_DEFINED, ITEM_CONFLICT, INVALID_ARG,
+                                           INVALID_ARG, INVALID_ARG, INVALID_SKU, OK };
+
+    ASSERT_EQ( ERROR, batch.addToCartBatch( records.data(), records.size(), codes.data() ) );
+    ASSERT_EQ( expected, codes );
+    ASSERT_NEAR( batch.getPreTaxTotal(), 2.50, .0001 );
+
+}
+
+TEST_F (BatchScanTest, batchedItemsLockPrice){
+
+    ScanRecord record = { "soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 3 };
+    ReturnCode_t code = ERROR;
+
+    ASSERT_EQ( OK, batch.addToCartBatch( &record, 1, &code ) );
+    ASSERT_EQ( OK, code );
+    ASSERT_EQ( PRICE_UPDATE_NOT_AVAILABLE, batch.setItemPrice( "soup", 2.00 ) );
+    ASSERT_EQ( OK, batch.removeFromCart( "soup", 3 ) );
+
+}
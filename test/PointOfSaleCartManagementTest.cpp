@@ -107,3 +107,105 @@ TEST (CartManagementTest, removeItemNegativeWeight){
 
 }
 
+
+TEST (CartManagementTest, totalTracksEachScanAndVoid){
+
+    PointOfSale sale;
+
+    sale.setItemPrice( "Cookies", 1.5 );
+    sale.setPerPoundPrice( "Bananas", 2.0 );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 0.0, .01 );
+
+    ASSERT_EQ( OK, sale.addToCart( "Cookies", 2 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 3.0, .01 );
+
+    ASSERT_EQ( OK, sale.addToCart( "Bananas", 1.5 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 6.0, .01 );
+
+    ASSERT_EQ( OK, sale.removeFromCart( "Cookies", 1 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 4.5, .01 );
+
+    // failed operations must leave the total untouched
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( "Cookies", 4 ) );
+    ASSERT_EQ( INVALID_ARG, sale.addToCart( "Bananas", -1.0 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 4.5, .01 );
+
+    ASSERT_EQ( OK, sale.removeFromCart( "Bananas", 1.5 ) );
+    ASSERT_EQ( OK, sale.removeFromCart( "Cookies", 1 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 0.0, .01 );
+
+}
+
+TEST (CartManagementTest, totalTracksDiscountChanges){
+
+    PointOfSale sale;
+
+    sale.setItemPrice( "Cookies", 1.0 );
+    ASSERT_EQ( OK, sale.addToCart( "Cookies", 6 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 6.0, .01 );
+
+    // discounts can be changed while the item is in the cart
+    ASSERT_EQ( OK, sale.applyGetXForYDiscount( "Cookies", 3, 2.0 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 4.0, .01 );
+
+    ASSERT_EQ( OK, sale.applyBuyXGetYAtDiscount( "Cookies", 2, 1, 0.5 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 5.0, .01 );
+
+}
+
+TEST (CartManagementTest, newTransactionEmptiesCart){
+
+    PointOfSale sale;
+
+    sale.setItemPrice( "Cookies", 1.0 );
+    sale.setPerPoundPrice( "Bananas", 2.0 );
+    sale.applyGetXForYDiscount( "Cookies", 3, 2.0 );
+
+    ASSERT_EQ( OK, sale.addToCart( "Cookies", 4 ) );
+    ASSERT_EQ( OK, sale.addToCart( "Bananas", 1.5 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 6.0, .01 );
+
+    sale.newTransaction();
+    ASSERT_NEAR( sale.getPreTaxTotal(), 0.0, .01 );
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( "Cookies", 1 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( "Bananas", 0.5 ) );
+
+    // the configuration is kept and the next customer starts from nothing
+    ASSERT_EQ( OK, sale.addToCart( "Cookies", 3 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 2.0, .01 );
+
+    // prices can be changed between customers, as no items are in the cart
+    sale.newTransaction();
+    ASSERT_EQ( OK, sale.setPerPoundPrice( "Bananas", 3.0 ) );
+    ASSERT_EQ( OK, sale.addToCart( "Bananas", 1.0 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 3.0, .01 );
+
+}
+
+TEST (CartManagementTest, newTransactionWithBatchAndRefresh){
+
+    Catalog catalog;
+    Cart cart( catalog );
+
+    catalog.setItemPrice( "Cookies", 1.0 );
+    catalog.setItemPrice( "Soup", 2.0 );
+    ASSERT_EQ( OK, cart.addToCart( "Cookies", 2 ) );
+    ASSERT_EQ( OK, cart.addToCart( "Soup", 1 ) );
+
+    cart.newTransaction();
+    ASSERT_FALSE( cart.isInCart( "Cookies" ) );
+
+    ScanRecord records[] = { { "Soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 3 } };
+    ReturnCode_t codes[1];
+    ASSERT_EQ( OK, cart.addToCartBatch( records, 1, codes ) );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 6.0, .01 );
+
+    // lines left from the earlier customer must not come back when every line is priced
+    catalog.setItemPrice( "Soup", 2.5 );
+    cart.refreshAll();
+    cart.refreshItem( "Cookies" );
+    ASSERT_NEAR( cart.getPreTaxTotal(), 7.5, .01 );
+    ASSERT_FALSE( cart.isInCart( "Cookies" ) );
+    ASSERT_TRUE( cart.isInCart( "Soup" ) );
+
+}
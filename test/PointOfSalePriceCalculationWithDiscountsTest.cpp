@@ -1,3 +1,5 @@
+#include <climits>
+
 #include "gtest/gtest.h"
 #include "PointOfSale.h"
 
@@ -378,3 +380,23 @@ TEST_F (PriceCalculationWithDiscountsTest, buyNGetMOffMultipleDiscountsMultipleD
     ASSERT_NEAR( pSale->getPreTaxTotal(), 21.0, .01 );
 
 }
+
+TEST_F (PriceCalculationWithDiscountsTest, priceTablesKeepTheSameTotals){
+
+    ASSERT_EQ( INVALID_ARG, pSale->setPriceTables( -1, 10 ) );
+    ASSERT_EQ( INVALID_ARG, pSale->setPriceTables( static_cast<int>( MAX_PRICE_TABLE_AMOUNT ) + 1, 10 ) );
+    ASSERT_EQ( INVALID_ARG, pSale->setPriceTables( INT_MAX, 10 ) );
+    ASSERT_EQ( OK, pSale->setPriceTables( static_cast<int>( MAX_PRICE_TABLE_AMOUNT ), 10 ) );
+    ASSERT_EQ( OK, pSale->setPriceTables( 8, 10 ) );
+
+    ASSERT_EQ( OK, pSale->applyGetXForYDiscount( "Chips", 3, 3.00 ) );
+    ASSERT_EQ( OK, pSale->addToCart( "Chips", 7 ) ); // 6 + 2, from the table
+    ASSERT_NEAR( pSale->getPreTaxTotal(), 8.0, .01 );
+
+    ASSERT_EQ( OK, pSale->addToCart( "Chips", 5 ) ); // 12, beyond the table
+    ASSERT_NEAR( pSale->getPreTaxTotal(), 12.0, .01 );
+
+    ASSERT_EQ( OK, pSale->removeFromCart( "Chips", 4 ) ); // 6 + 4, from the table
+    ASSERT_NEAR( pSale->getPreTaxTotal(), 10.0, .01 );
+
+}
@@ -0,0 +1,137 @@
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+
+TEST (SkuHandleTest, unknownSkuHasNoHandle){
+
+    PointOfSale sale;
+    ASSERT_EQ( INVALID_SKU_HANDLE, sale.resolveSku( "soup" ) );
+    ASSERT_EQ( INVALID_SKU_HANDLE, sale.resolveSku( "" ) );
+
+}
+
+TEST (SkuHandleTest, handleIsStableAsCatalogGrows){
+
+    PointOfSale sale;
+    ASSERT_EQ( OK, sale.setItemPrice( "soup", 1.25 ) );
+    SkuHandle soup = sale.resolveSku( "soup" );
+    ASSERT_NE( INVALID_SKU_HANDLE, soup );
+
+    // registering many more items must not move the existing one
+    for(int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ( OK, sale.setItemPrice( "item" + std::to_string(i), 1.0 ) );
+    }
+
+    ASSERT_EQ( soup, sale.resolveSku( "soup" ) );
+
+    // updating the price keeps the handle as well
+    ASSERT_EQ( OK, sale.setItemPrice( "soup", 1.50 ) );
+    ASSERT_EQ( soup, sale.resolveSku( "soup" ) );
+
+}
+
+TEST (SkuHandleTest, handleScansMatchStringScans){
+
+    PointOfSale by_string;
+    PointOfSale by_handle;
+
+    for(PointOfSale* sale : { &by_string, &by_handle })
+    {
+        sale->setItemPrice( "soup", 1.25 );
+        sale->setPerPoundPrice( "beef", 4.00 );
+        sale->applyGetXForYDiscount( "soup", 3, 3.00 );
+    }
+
+    ASSERT_EQ( OK, by_string.addToCart( "soup", 4 ) );
+    ASSERT_EQ( OK, by_string.addToCart( "beef", 1.5 ) );
+    ASSERT_EQ( OK, by_string.removeFromCart( "soup", 1 ) );
+
+    SkuHandle soup = by_handle.resolveSku( "soup" );
+    SkuHandle beef = by_handle.resolveSku( "beef" );
+    ASSERT_EQ( OK, by_handle.addToCart( soup, 4 ) );
+    ASSERT_EQ( OK, by_handle.addToCart( beef, 1.5 ) );
+    ASSERT_EQ( OK, by_handle.removeFromCart( soup, 1 ) );
+
+    ASSERT_NEAR( by_string.getPreTaxTotal(), 9.00, .01 );
+    ASSERT_NEAR( by_handle.getPreTaxTotal(), by_string.getPreTaxTotal(), .001 );
+
+}
+
+TEST (SkuHandleTest, handleOfWrongTypeConflicts){
+
+    PointOfSale sale;
+    sale.setItemPrice( "soup", 1.25 );
+    sale.setPerPoundPrice( "beef", 4.00 );
+
+    ASSERT_EQ( ITEM_CONFLICT, sale.addToCart( sale.resolveSku( "soup" ), 1.0 ) );
+    ASSERT_EQ( ITEM_CONFLICT, sale.addToCart( sale.resolveSku( "beef" ), 1 ) );
+    ASSERT_EQ( ITEM_CONFLICT, sale.setPerPoundPrice( sale.resolveSku( "soup" ), 2.00 ) );
+    ASSERT_EQ( ITEM_CONFLICT, sale.setItemPrice( sale.resolveSku( "beef" ), 2.00 ) );
+
+}
+
+TEST (SkuHandleTest, invalidHandle){
+
+    PointOfSale sale;
+    ASSERT_EQ( NO_PRICE_DEFINED, sale.addToCart( INVALID_SKU_HANDLE, 1 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( INVALID_SKU_HANDLE, 1.0 ) );
+    ASSERT_EQ( INVALID_SKU, sale.setItemPrice( INVALID_SKU_HANDLE, 1.00 ) );
+
+}
+
+TEST (SkuHandleTest, handleNotFromCatalog){
+
+    PointOfSale sale;
+    sale.setItemPrice( "soup", 1.25 );
+
+    // a handle past the end of the catalog was never handed out
+    SkuHandle bogus = sale.resolveSku( "soup" ) + 10;
+    ASSERT_EQ( INVALID_SKU, sale.addToCart( bogus, 1 ) );
+    ASSERT_EQ( INVALID_SKU, sale.setItemPrice( bogus, 1.00 ) );
+
+}
+
+TEST (SkuHandleTest, priceLockedOnceScannedByHandle){
+
+    PointOfSale sale;
+    sale.setItemPrice( "soup", 1.25 );
+    SkuHandle soup = sale.resolveSku( "soup" );
+
+    ASSERT_EQ( OK, sale.setMarkdown( soup, 0.25 ) );
+    ASSERT_EQ( OK, sale.addToCart( soup, 2 ) );
+
+    ASSERT_EQ( PRICE_UPDATE_NOT_AVAILABLE, sale.setItemPrice( soup, 2.00 ) );
+    ASSERT_EQ( PRICE_UPDATE_NOT_AVAILABLE, sale.setItemPrice( "soup", 2.00 ) );
+    ASSERT_EQ( PRICE_UPDATE_NOT_AVAILABLE, sale.setMarkdown( soup, 0.50 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 2.00, .01 );
+
+}
+
+TEST (SkuHandleTest, lockedPriceCheckedLikeCatalog){
+
+    PointOfSale sale;
+    sale.setItemPrice( "soup", 1.25 );
+    sale.setPerPoundPrice( "beef", 5.00 );
+    SkuHandle soup = sale.resolveSku( "soup" );
+    SkuHandle beef = sale.resolveSku( "beef" );
+
+    ASSERT_EQ( OK, sale.addToCart( soup, 1 ) );
+    ASSERT_EQ( OK, sale.addToCart( beef, 1.5 ) );
+
+    // prices the catalog would refuse are reported as such, whichever entry point is used
+    for(double price : { 0.0, -1.0, 0.00001, std::numeric_limits<double>::quiet_NaN(),
+                         std::numeric_limits<double>::infinity() })
+    {
+        ASSERT_EQ( INVALID_PRICE, sale.setItemPrice( soup, price ) );
+        ASSERT_EQ( INVALID_PRICE, sale.setItemPrice( "soup", price ) );
+        ASSERT_EQ( INVALID_PRICE, sale.setPerPoundPrice( beef, price ) );
+        ASSERT_EQ( INVALID_PRICE, sale.setPerPoundPrice( "beef", price ) );
+    }
+
+    ASSERT_EQ( ITEM_CONFLICT, sale.setPerPoundPrice( soup, 2.00 ) );
+    ASSERT_EQ( PRICE_UPDATE_NOT_AVAILABLE, sale.setPerPoundPrice( beef, 6.00 ) );
+
+}
@@ -0,0 +1,103 @@
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ItemStore.h"
+#include "PricingKernel.h"
+
+static const PricingKernel_t KERNELS[] = { SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL };
+
+// Builds a store covering every type of discount, with and without limits
+template <class T>
+static void fillStore( ItemStore<T>& items, std::vector<Quantity>& amounts, size_t count, double top_price )
+{
+    std::mt19937 generator( 7 );
+    std::uniform_int_distribution<int> pick( 0, 5 );
+    std::uniform_int_distribution<int> small( 1, 9 );
+    std::uniform_real_distribution<double> price( 0.01, top_price );
+
+    for(size_t i = 0; i < count; i++)
+    {
+        CatalogItem<T> item;
+        item.setPrice( price(generator) );
+        item.applyMarkdown( (i % 3 == 0) ? 0.01 : 0.0 );
+
+        switch(pick(generator))
+        {
+            case 1: item.applyGetXforPriceDiscount( (T)small(generator), 1.00 ); break;
+            case 2: item.applyGetXforPriceDiscount( (T)small(generator), 2.50, (T)(small(generator) * 3) ); break;
+            case 3: item.applyBuyXGetYDiscount( (T)small(generator), (T)small(generator), 1.0 / small(generator) ); break;
+            case 4: item.applyBuyXGetYDiscount( (T)small(generator), (T)small(generator), 0.3, (T)(small(generator) * 4) ); break;
+            default: break;
+        }
+
+        items.append( item );
+        amounts.push_back( (i % 13 == 0) ? 0 : std::uniform_int_distribution<Quantity>( 0, 40000 )( generator ) );
+    }
+}
+
+template <class T>
+static void checkKernels( const ItemStore<T>& items, const std::vector<Quantity>& amounts )
+{
+    // every count up to a few lanes past a vector exercises the left over lines
+    for(size_t count : { (size_t)0, (size_t)1, (size_t)3, (size_t)5, (size_t)7, amounts.size() })
+    {
+        Money expected = 0;
+        std::vector<Money> lines( count );
+        for(uint32_t i = 0; i < count; i++)
+        {
+            ASSERT_EQ( OK, items.get( i ).computePreTax( amounts[i], &lines[i] ) );
+            expected += lines[i];
+        }
+
+        for(PricingKernel_t kernel : KERNELS)
+        {
+            std::vector<Money> totals( count );
+            ASSERT_EQ( expected, items.computeTotals( amounts.data(), totals.data(), count, kernel ) );
+            ASSERT_EQ( lines, totals );
+        }
+    }
+}
+
+TEST (PricingKernelTest, scalarAlwaysSupported){
+
+    ASSERT_TRUE( isPricingKernelSupported( SCALAR_KERNEL ) );
+    ASSERT_TRUE( isPricingKernelSupported( getPricingKernel() ) );
+
+}
+
+TEST (PricingKernelTest, fixedPriceKernelsMatchCatalogItem){
+
+    ItemStore<int> items;
+    std::vector<Quantity> amounts;
+
+    fillStore( items, amounts, 1001, 50.0 );
+    checkKernels( items, amounts );
+
+}
+
+TEST (PricingKernelTest, weightBasedKernelsMatchCatalogItem){
+
+    ItemStore<double> items;
+    std::vector<Quantity> amounts;
+
+    fillStore( items, amounts, 1001, 50.0 );
+    checkKernels( items, amounts );
+
+}
+
+TEST (PricingKernelTest, valuesBeyondExactRangeMatchCatalogItem){
+
+    ItemStore<int> items;
+    std::vector<Quantity> amounts;
+
+    // large prices and amounts push the products past 2^53 and onto the scalar kernel
+    fillStore( items, amounts, 64, 900000000.0 );
+    for(size_t i = 0; i < amounts.size(); i++)
+    {
+        amounts[i] *= 100000;
+    }
+
+    checkKernels( items, amounts );
+
+}
@@ -0,0 +1,178 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Catalog.h"
+#include "StoreEngine.h"
+#include "PricingPool.h"
+
+class PricingPoolTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       std::shared_ptr<Catalog> catalog = std::make_shared<Catalog>();
+
+       catalog->setItemPrice( "Soup", 1.50 );
+       catalog->setItemPrice( "Chips", 2.00 );
+       catalog->setPerPoundPrice( "Beef", 3.50 );
+       catalog->applyGetXForYDiscount( "Chips", 3, 5.00 );
+
+       engine.reset( new StoreEngine( catalog ) );
+   }
+
+   std::unique_ptr<StoreEngine> engine;
+};
+
+TEST_F (PricingPoolTest, pricesCartsLikeALane){
+
+    const size_t CARTS = 200;
+
+    // cart i holds i % 7 chips, one soup and a pound of beef
+    std::vector<std::vector<ScanRecord>> carts( CARTS );
+    std::vector<std::vector<ReturnCode_t>> codes( CARTS );
+    std::vector<Money> totals( CARTS, 0 );
+
+    PricingPool pool( *engine, 4 );
+    ASSERT_EQ( 4u, pool.getWorkerCount() );
+
+    for(size_t i = 0; i < CARTS; i++)
+    {
+        carts[i].push_back( { "Chips", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, static_cast<double>( i % 7 ) } );
+        carts[i].push_back( { "Soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1.0 } );
+        carts[i].push_back( { "Beef", INVALID_SKU_HANDLE, WEIGHT_BASED_ITEM, 1.0 } );
+        carts[i].push_back( { "Cookies", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1.0 } );
+        codes[i].resize( carts[i].size() );
+
+        pool.submitCart( carts[i].data(), carts[i].size(), codes[i].data(), &totals[i],
+                         (i % 2 == 0) ? INTERACTIVE_PRIORITY : BATCH_PRIORITY );
+    }
+    pool.wait();
+
+    std::unique_ptr<Lane> lane = engine->openLane();
+    for(size_t i = 0; i < CARTS; i++)
+    {
+        lane->newTransaction();
+        lane->addToCart( "Chips", static_cast<int>( i % 7 ) );
+        lane->addToCart( "Soup", 1 );
+        lane->addToCart( "Beef", 1.0 );
+
+        ASSERT_EQ( lane->getPreTaxTotalMoney(), totals[i] );
+        ASSERT_EQ( NO_PRICE_DEFINED, codes[i][3] );
+    }
+
+}
+
+TEST_F (PricingPoolTest, interactiveTasksRunBeforeQueuedBatchTasks){
+
+    PricingPool pool( *engine, 1 );
+    std::mutex gate;
+    std::vector<TaskPriority_t> order;
+
+    // hold the only worker while a mix of tasks is queued behind it
+    gate.lock();
+    pool.submit( [&gate]( Lane& ){ std::lock_guard<std::mutex> lock( gate ); }, BATCH_PRIORITY );
+
+    for(int i = 0; i < 10; i++)
+    {
+        TaskPriority_t priority = (i < 5) ? BATCH_PRIORITY : INTERACTIVE_PRIORITY;
+        pool.submit( [&order, priority]( Lane& ){ order.push_back( priority ); }, priority );
+    }
+
+    gate.unlock();
+    pool.wait();
+
+    ASSERT_EQ( 10u, order.size() );
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        ASSERT_EQ( (i < 5) ? INTERACTIVE_PRIORITY : BATCH_PRIORITY, order[i] );
+    }
+
+}
+
+TEST_F (PricingPoolTest, idleWorkersStealQueuedTasks){
+
+    PricingPool pool( *engine, 2 );
+    std::atomic<bool> child_done( false );
+
+    // the child stays on the queue of the worker running the parent, which is waiting on it,
+    // so the child can only run once the other worker steals it
+    pool.submit( [&pool, &child_done]( Lane& )
+    {
+        pool.submit( [&child_done]( Lane& ){ child_done.store( true ); }, INTERACTIVE_PRIORITY );
+        while(!child_done.load())
+        {
+            std::this_thread::yield();
+        }
+    }, BATCH_PRIORITY );
+
+    pool.wait();
+
+    ASSERT_TRUE( child_done.load() );
+    ASSERT_GE( pool.getStolenCount(), 1u );
+
+}
+
+TEST_F (PricingPoolTest, tasksSeeLatestCatalog){
+
+    PricingPool pool( *engine, 2 );
+    Money total = 0;
+
+    ASSERT_EQ( OK, engine->update( []( Catalog& catalog ){ return catalog.setItemPrice( "Soup", 3.00 ); } ) );
+
+    pool.submit( [&total]( Lane& lane )
+    {
+        lane.addToCart( "Soup", 2 );
+        total = lane.getPreTaxTotalMoney();
+    }, INTERACTIVE_PRIORITY );
+    pool.wait();
+
+    ASSERT_EQ( 60000, total );
+
+}
+
+TEST_F (PricingPoolTest, waitCoversNestedTasks){
+
+    const int ROUNDS = 1000;
+    const int PARENTS = 2;
+    const int CHILDREN = 64;
+
+    PricingPool pool( *engine, 4 );
+
+    // each parent waits for its children to be stolen by the idle workers and run before finishing,
+    // so wait returning early would find a parent that has not finished yet
+    for(int round = 0; round < ROUNDS; round++)
+    {
+        std::atomic<int> finished( 0 );
+        std::vector<std::atomic<int>> children( PARENTS );
+
+        for(int parent = 0; parent < PARENTS; parent++)
+        {
+            children[parent].store( 0 );
+            pool.submit( [&pool, &finished, &children, parent, CHILDREN]( Lane& )
+            {
+                for(int child = 0; child < CHILDREN; child++)
+                {
+                    pool.submit( [&children, parent]( Lane& ){ children[parent]++; },
+                                 (child % 2 == 0) ? INTERACTIVE_PRIORITY : BATCH_PRIORITY );
+                }
+                while(children[parent].load() < CHILDREN)
+                {
+                    std::this_thread::yield();
+                }
+
+                std::this_thread::yield();
+                finished++;
+            }, BATCH_PRIORITY );
+        }
+
+        pool.wait();
+        ASSERT_EQ( PARENTS, finished.load() ) << "round " << round;
+    }
+
+}
@@ -0,0 +1,126 @@
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+#include "ReplayLog.h"
+
+static const char* RECORDED =
+    "# time_us,event,sku,value\n"
+    "0,setItemPrice,Soup,1.50\n"
+    "5,setPerPoundPrice,Beef,3.50\n"
+    "10,addToCart,Soup,3\n"
+    "20,addToCart,Beef,1.25\n"
+    "30,getPreTaxTotal,,8.88\n"
+    "40,removeFromCart,Soup,1\n"
+    "\n"
+    "50,getPreTaxTotal,,7.375\n"
+    "60,getPreTaxTotal\n"
+    "70,newTransaction\n"
+    "80,getPreTaxTotal,,0.00\n";
+
+TEST (ReplayLogTest, recordedTotalsMatch){
+
+    std::istringstream input( RECORDED );
+    ReplayLog log;
+    PointOfSale sale;
+    ReplayReport report;
+
+    ASSERT_EQ( OK, log.loadStream( input, 0 ) );
+    ASSERT_EQ( 10u, log.size() );
+
+    log.replay( sale, false, &report );
+
+    ASSERT_EQ( 10u, report.events );
+    ASSERT_EQ( 3u, report.totals_checked );
+    ASSERT_TRUE( report.mismatches.empty() );
+    ASSERT_EQ( 0u, report.calls_failed );
+    ASSERT_LE( report.latency_p50, report.latency_p99 );
+    ASSERT_LE( report.latency_p999, report.latency_max );
+
+}
+
+TEST (ReplayLogTest, changedTotalIsReported){
+
+    std::istringstream input( "0,setItemPrice,Soup,1.50\n1,addToCart,Soup,2\n2,getPreTaxTotal,,3.01\n" );
+    ReplayLog log;
+    PointOfSale sale;
+    ReplayReport report;
+
+    ASSERT_EQ( OK, log.loadStream( input, 0 ) );
+    log.replay( sale, true, &report );
+
+    ASSERT_EQ( 1u, report.mismatches.size() );
+    ASSERT_EQ( 3u, report.mismatches[0].line );
+    ASSERT_EQ( 30100, report.mismatches[0].expected );
+    ASSERT_EQ( 30000, report.mismatches[0].actual );
+
+}
+
+TEST (ReplayLogTest, failedCallsAreCounted){
+
+    std::istringstream input( "0,setItemPrice,Soup,1.50\n"
+                              "1,setItemPrice,Free,-1.00\n"
+                              "2,addToCart,Cookies,1\n"
+                              "3,addToCart,Soup,2\n"
+                              "4,removeFromCart,Soup,5\n"
+                              "5,addToCart,Cookies,2\n"
+                              "6,getPreTaxTotal,,3.00\n" );
+    ReplayLog log;
+    PointOfSale sale;
+    ReplayReport report;
+
+    ASSERT_EQ( OK, log.loadStream( input, 0 ) );
+    log.replay( sale, false, &report );
+
+    ASSERT_TRUE( report.mismatches.empty() );
+    ASSERT_EQ( 4u, report.calls_failed );
+    ASSERT_EQ( 1u, report.failed[REPLAY_SET_ITEM_PRICE] );
+    ASSERT_EQ( 2u, report.failed[REPLAY_ADD_TO_CART] );
+    ASSERT_EQ( 1u, report.failed[REPLAY_REMOVE_FROM_CART] );
+    ASSERT_EQ( 0u, report.failed[REPLAY_GET_PRE_TAX_TOTAL] );
+    ASSERT_STREQ( "addToCart", ReplayLog::getEventName( REPLAY_ADD_TO_CART ) );
+
+}
+
+TEST (ReplayLogTest, malformedEventsRejected){
+
+    const char* malformed[] = { "0,scanItem,Soup,1\n", "x,addToCart,Soup,1\n", "0,addToCart,,1\n", "0,addToCart,Soup\n",
+                                "0,addToCart,Soup,1e20\n", "0,getPreTaxTotal,,abc\n", "0,addToCart,Soup,1,2\n" };
+
+    for(const char* text : malformed)
+    {
+        std::istringstream input( std::string( "0,setItemPrice,Soup,1.50\n" ) + text );
+        ReplayLog log;
+        size_t line = 0;
+
+        ASSERT_EQ( ERROR, log.loadStream( input, &line ) ) << text;
+        ASSERT_EQ( 2u, line ) << text;
+        ASSERT_EQ( 0u, log.size() );
+    }
+
+    ReplayLog log;
+    ASSERT_EQ( INVALID_ARG, log.loadFile( ::testing::TempDir() + "missing/replay.log", 0 ) );
+
+}
+
+TEST (ReplayLogTest, outOfOrderTimesRejected){
+
+    std::istringstream ordered( "10,setItemPrice,Soup,1.50\n10,addToCart,Soup,1\n20,getPreTaxTotal,,1.50\n" );
+    ReplayLog log;
+    size_t line = 0;
+
+    ASSERT_EQ( OK, log.loadStream( ordered, &line ) );
+    ASSERT_EQ( 3u, log.size() );
+
+    // an event recorded before the one ahead of it is rejected with its line
+    std::istringstream reversed( "10,setItemPrice,Soup,1.50\n20,addToCart,Soup,1\n\n5,getPreTaxTotal,,1.50\n" );
+    ASSERT_EQ( ERROR, log.loadStream( reversed, &line ) );
+    ASSERT_EQ( 4u, line );
+    ASSERT_EQ( 0u, log.size() );
+
+    std::istringstream huge( "1e30,newTransaction\n" );
+    ASSERT_EQ( ERROR, log.loadStream( huge, &line ) );
+    ASSERT_EQ( 1u, line );
+
+}
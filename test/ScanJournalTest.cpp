@@ -0,0 +1,214 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "PointOfSale.h"
+#include "ScanJournal.h"
+
+class ScanJournalTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       path = ::testing::TempDir() + "scan_journal_test.bin";
+       std::remove( path.c_str() );
+   }
+
+   void TearDown( ) override
+   {
+       std::remove( path.c_str() );
+   }
+
+   // the same prices are configured every time the lane starts
+   static void configure( PointOfSale& sale )
+   {
+       sale.setItemPrice( "Soup", 1.50 );
+       sale.setItemPrice( "Chips", 2.00 );
+       sale.setPerPoundPrice( "Beef", 3.50 );
+       sale.applyGetXForYDiscount( "Chips", 3, 5.00 );
+   }
+
+   static long fileSize( const std::string& path )
+   {
+       FILE* file = std::fopen( path.c_str(), "rb" );
+       std::fseek( file, 0, SEEK_END );
+       long length = std::ftell( file );
+       std::fclose( file );
+       return length;
+   }
+
+   std::string path;
+};
+
+TEST_F (ScanJournalTest, restartRebuildsCart){
+
+    Money total;
+
+    {
+        PointOfSale sale;
+        configure( sale );
+        ASSERT_EQ( OK, sale.openJournal( path ) );
+
+        sale.addToCart( "Chips", 4 );
+        sale.addToCart( sale.resolveSku( "Soup" ), 3 );
+        sale.addToCart( "Beef", 2.37 );
+        sale.removeFromCart( "Beef", 0.5 );
+        sale.removeFromCart( sale.resolveSku( "Chips" ), 1 );
+        sale.addToCart( "Cookies", 1 );
+
+        ASSERT_EQ( OK, sale.syncJournal() );
+        total = sale.getPreTaxTotalMoney();
+    }
+
+    PointOfSale restarted;
+    configure( restarted );
+    ASSERT_EQ( OK, restarted.openJournal( path ) );
+
+    ASSERT_EQ( total, restarted.getPreTaxTotalMoney() );
+    ASSERT_EQ( OK, restarted.removeFromCart( "Chips", 3 ) );
+    ASSERT_EQ( ITEM_NOT_IN_CART, restarted.removeFromCart( "Chips", 1 ) );
+
+}
+
+TEST_F (ScanJournalTest, newTransactionEmptiesJournal){
+
+    {
+        PointOfSale sale;
+        configure( sale );
+        ASSERT_EQ( OK, sale.openJournal( path ) );
+
+        sale.addToCart( "Soup", 2 );
+        sale.newTransaction();
+        sale.addToCart( "Chips", 1 );
+        ASSERT_EQ( OK, sale.syncJournal() );
+    }
+
+    PointOfSale restarted;
+    configure( restarted );
+    ASSERT_EQ( OK, restarted.openJournal( path ) );
+
+    ASSERT_NEAR( restarted.getPreTaxTotal(), 2.00, .01 );
+
+}
+
+TEST_F (ScanJournalTest, handleScansReplayedBySku){
+
+    {
+        PointOfSale sale;
+        configure( sale );
+        ASSERT_EQ( OK, sale.openJournal( path ) );
+
+        ASSERT_EQ( OK, sale.addToCart( sale.resolveSku( "Soup" ), 3 ) );
+        ASSERT_EQ( OK, sale.addToCart( sale.resolveSku( "Beef" ), 2.0 ) );
+        ASSERT_EQ( OK, sale.removeFromCart( sale.resolveSku( "Soup" ), 1 ) );
+        ASSERT_EQ( OK, sale.syncJournal() );
+    }
+
+    // the items are registered in another order, so every handle now refers to a different item
+    PointOfSale restarted;
+    restarted.setPerPoundPrice( "Lamb", 9.00 );
+    restarted.setItemPrice( "Chips", 2.00 );
+    restarted.setItemPrice( "Soup", 1.50 );
+    restarted.setPerPoundPrice( "Beef", 3.50 );
+    ASSERT_EQ( OK, restarted.openJournal( path ) );
+
+    ASSERT_NEAR( restarted.getPreTaxTotal(), 2 * 1.50 + 2 * 3.50, .01 );
+
+}
+
+TEST_F (ScanJournalTest, unrecordedScanIsTakenBack){
+
+    PointOfSale sale;
+    std::string sku( 70000, 'x' );
+
+    configure( sale );
+    ASSERT_EQ( OK, sale.setItemPrice( sku, 1.00 ) );
+    ASSERT_EQ( OK, sale.openJournal( path ) );
+    ASSERT_EQ( OK, sale.addToCart( "Soup", 1 ) );
+
+    // the journal can not hold a SKU this long, so neither call may change the cart
+    ASSERT_EQ( INVALID_ARG, sale.addToCart( sku, 2 ) );
+    ASSERT_EQ( INVALID_ARG, sale.addToCart( sale.resolveSku( sku ), 2 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 1.50, .01 );
+    ASSERT_EQ( ITEM_NOT_IN_CART, sale.removeFromCart( sku, 1 ) );
+
+    ScanRecord records[2] = { { "Chips", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 3.0 },
+                              { sku, INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1.0 } };
+    ReturnCode_t codes[2];
+    ASSERT_EQ( ERROR, sale.addToCartBatch( records, 2, codes ) );
+    ASSERT_EQ( OK, codes[0] );
+    ASSERT_EQ( INVALID_ARG, codes[1] );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 1.50 + 5.00, .01 );
+
+    ASSERT_EQ( OK, sale.newTransaction() );
+
+}
+
+TEST_F (ScanJournalTest, tornEntryIsDropped){
+
+    {
+        PointOfSale sale;
+        configure( sale );
+        ASSERT_EQ( OK, sale.openJournal( path, std::chrono::microseconds( 0 ) ) );
+
+        sale.addToCart( "Soup", 1 );
+        sale.addToCart( "Chips", 1 );
+    }
+
+    // the last entry is cut short, as if the process stopped while writing it
+    ASSERT_EQ( 0, truncate( path.c_str(), fileSize( path ) - 3 ) );
+
+    {
+        PointOfSale restarted;
+        configure( restarted );
+        ASSERT_EQ( OK, restarted.openJournal( path ) );
+        ASSERT_NEAR( restarted.getPreTaxTotal(), 1.50, .01 );
+
+        restarted.addToCart( "Beef", 1.0 );
+        ASSERT_EQ( OK, restarted.syncJournal() );
+    }
+
+    // entries written after the torn one was dropped are read back
+    PointOfSale again;
+    configure( again );
+    ASSERT_EQ( OK, again.openJournal( path ) );
+    ASSERT_NEAR( again.getPreTaxTotal(), 5.00, .01 );
+
+}
+
+TEST_F (ScanJournalTest, groupCommitSharesFlushes){
+
+    ScanJournal journal;
+    std::vector<JournalEntry> entries;
+
+    ASSERT_EQ( OK, journal.open( path, std::chrono::microseconds( 200000 ), &entries ) );
+    ASSERT_TRUE( entries.empty() );
+
+    for(int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ( OK, journal.append( JOURNAL_ADD, { "Soup", INVALID_SKU_HANDLE, FIXED_PRICE_ITEM, 1.0 } ) );
+    }
+    ASSERT_EQ( OK, journal.sync() );
+    ASSERT_LE( journal.getSyncCount(), 2u );
+
+}
+
+TEST_F (ScanJournalTest, rejectsOtherFiles){
+
+    PointOfSale sale;
+
+    FILE* file = std::fopen( path.c_str(), "wb" );
+    ASSERT_TRUE( file != 0 );
+    std::fputs( "sku,type,price\nSoup,each,1.50\n", file );
+    std::fclose( file );
+
+    ASSERT_EQ( ERROR, sale.openJournal( path ) );
+    ASSERT_EQ( INVALID_ARG, sale.openJournal( ::testing::TempDir() + "missing/journal.bin" ) );
+    ASSERT_EQ( ERROR, sale.syncJournal() );
+
+}
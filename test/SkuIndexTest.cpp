@@ -0,0 +1,75 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "SkuIndex.h"
+
+TEST (SkuIndexTest, findMissingSku){
+
+    SkuIndex index;
+
+    ASSERT_EQ( 0u, index.size() );
+    ASSERT_TRUE( index.find( "Soup" ) == 0 );
+
+}
+
+TEST (SkuIndexTest, findInsertedSkus){
+
+    SkuIndex index;
+    SkuEntry soup = { FIXED_PRICE_ITEM, 4 };
+    SkuEntry beef = { WEIGHT_BASED_ITEM, 4 };
+
+    index.insert( "Soup", soup );
+    index.insert( "Beef", beef );
+
+    ASSERT_EQ( 2u, index.size() );
+    ASSERT_EQ( FIXED_PRICE_ITEM, index.find( "Soup" )->type );
+    ASSERT_EQ( WEIGHT_BASED_ITEM, index.find( "Beef" )->type );
+    ASSERT_EQ( 4u, index.find( "Beef" )->index );
+
+    // prefixes and different lengths of a key must not match it
+    ASSERT_TRUE( index.find( "Sou" ) == 0 );
+    ASSERT_TRUE( index.find( "Soups" ) == 0 );
+    ASSERT_TRUE( index.find( "Soup", 3 ) == 0 );
+
+}
+
+TEST (SkuIndexTest, entriesSurviveGrowth){
+
+    SkuIndex index;
+
+    for(uint32_t i = 0; i < 10000; i++)
+    {
+        SkuEntry entry = { (i % 2) ? WEIGHT_BASED_ITEM : FIXED_PRICE_ITEM, i };
+        index.insert( "SKU" + std::to_string(i), entry );
+    }
+
+    ASSERT_EQ( 10000u, index.size() );
+    for(uint32_t i = 0; i < 10000; i++)
+    {
+        const SkuEntry* entry = index.find( "SKU" + std::to_string(i) );
+        ASSERT_TRUE( entry != 0 );
+        ASSERT_EQ( i, entry->index );
+    }
+    ASSERT_TRUE( index.find( "SKU10000" ) == 0 );
+
+}
+
+TEST (SkuIndexTest, reserveKeepsEntries){
+
+    SkuIndex index;
+    SkuEntry soup = { FIXED_PRICE_ITEM, 0 };
+
+    index.insert( "Soup", soup );
+    index.reserve( 5000 );
+
+    for(uint32_t i = 1; i < 5000; i++)
+    {
+        SkuEntry entry = { WEIGHT_BASED_ITEM, i };
+        index.insert( "SKU" + std::to_string(i), entry );
+    }
+
+    ASSERT_EQ( 5000u, index.size() );
+    ASSERT_EQ( 0u, index.find( "Soup" )->index );
+    ASSERT_EQ( 4999u, index.find( "SKU4999" )->index );
+
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "DiscountPolicy.h"
+#include "ItemStore.h"
+#include "PointOfSale.h"
+
+// Exact cost, in units of 1 / (units * RATE_SCALE) of a Money unit, of selling a portion of the amount using a discount
+static __int128 portionCost( const Discount& discount, Quantity portion, Money net, Quantity units )
+{
+    __int128 full = static_cast<__int128>( net ) * portion * RATE_SCALE;
+
+    if(const BundleDiscount* bundle = std::get_if<BundleDiscount>( &discount ))
+    {
+        Quantity bundles = std::min( portion, bundle->limit ) / bundle->size;
+        return full - static_cast<__int128>( net ) * bundles * bundle->size * RATE_SCALE +
+               static_cast<__int128>( bundle->bundle_price ) * bundles * units * RATE_SCALE;
+    }
+
+    const BuyXGetYDiscount& buy = std::get<BuyXGetYDiscount>( discount );
+    Quantity eligible = std::min( portion, buy.limit );
+    Quantity cycle = buy.buy + buy.get;
+    Quantity cycles = eligible / cycle;
+    Quantity discounted = cycles * buy.get + std::max<Quantity>( eligible - cycles * cycle - buy.buy, 0 );
+    return full - static_cast<__int128>( net ) * discounted * buy.rate;
+}
+
+// Tries every portion of each amount up to the most for each discount in turn, rounding the cheapest totals once
+static std::vector<Money> cheapestByEnumeration( const std::vector<Discount>& discounts, Quantity most, Money net,
+                                                 Quantity units )
+{
+    __int128 scale = static_cast<__int128>( units ) * RATE_SCALE;
+
+    std::vector<__int128> best( most + 1 );
+    for(Quantity left = 0; left <= most; left++)
+    {
+        best[left] = static_cast<__int128>( net ) * left * RATE_SCALE;
+    }
+
+    for(const Discount& discount : discounts)
+    {
+        std::vector<__int128> costs( most + 1 );
+        for(Quantity portion = 0; portion <= most; portion++)
+        {
+            costs[portion] = portionCost( discount, portion, net, units );
+        }
+
+        std::vector<__int128> updated( best );
+        for(Quantity left = 0; left <= most; left++)
+        {
+            for(Quantity portion = 0; portion <= left; portion++)
+            {
+                updated[left] = std::min( updated[left], best[left - portion] + costs[portion] );
+            }
+        }
+        best = updated;
+    }
+
+    std::vector<Money> cheapest( most + 1 );
+    for(Quantity amount = 0; amount <= most; amount++)
+    {
+        cheapest[amount] = static_cast<Money>( (best[amount] + scale / 2) / scale );
+    }
+    return cheapest;
+}
+
+// Sizes are whole multiples of the given step and limits of the step times the given spread, amounts go up to
+// the given most
+template <class T>
+static void checkAgainstEnumeration( Quantity step, Quantity spread, Quantity most )
+{
+    const Quantity units = QuantityTraits<T>::UNITS;
+
+    std::mt19937 generator( 11 );
+    std::uniform_int_distribution<Quantity> small( 1, 6 );
+    std::uniform_int_distribution<int> coin( 0, 1 );
+
+    for(int round = 0; round < 300; round++)
+    {
+        Money net = std::uniform_int_distribution<Money>( 1, 50000 )( generator );
+        StackedDiscount stack = {};
+        std::vector<Discount> discounts;
+
+        int count = std::uniform_int_distribution<int>( 2, 3 )( generator );
+        for(int i = 0; i < count; i++)
+        {
+            Quantity limit = coin( generator ) ? NO_LIMIT : small( generator ) * step * spread;
+            if(coin( generator ))
+            {
+                // bundles priced either side of buying the items separately
+                BundleDiscount bundle = { small( generator ) * step, limit,
+                                          std::uniform_int_distribution<Money>( 1, net * 6 )( generator ) };
+                stack.bundles[stack.bundle_count++] = bundle;
+                discounts.push_back( bundle );
+            }
+            else
+            {
+                BuyXGetYDiscount buy = { small( generator ) * step - 1, small( generator ) * step, limit,
+                                         std::uniform_int_distribution<int64_t>( 1, RATE_SCALE )( generator ) };
+                stack.buy_x_get_y[stack.buy_x_get_y_count++] = buy;
+                discounts.push_back( buy );
+            }
+        }
+
+        std::vector<Money> cheapest = cheapestByEnumeration( discounts, most, net, units );
+        for(Quantity amount = 0; amount <= most; amount += 1 + amount / 8)
+        {
+            ASSERT_EQ( cheapest[amount], stack.price<T>( amount, net ) ) << "round " << round << " amount " << amount;
+        }
+    }
+}
+
+TEST (StackedDiscountTest, fixedPriceMatchesEnumeration){
+
+    checkAgainstEnumeration<int>( 1, 3, 40 );
+
+}
+
+TEST (StackedDiscountTest, weightBasedMatchesEnumeration){
+
+    // pounds are held in thousandths, so the costs are rounded from fractions of the price per pound
+    checkAgainstEnumeration<double>( 4, 3, 60 );
+
+}
+
+TEST (StackedDiscountTest, largeAmountsMatchEnumeration){
+
+    // well past the range covered by dynamic programming, with limits both short of the amount and beyond it
+    checkAgainstEnumeration<int>( 1, 12, 300 );
+    checkAgainstEnumeration<double>( 2, 8, 300 );
+
+}
+
+TEST (StackedDiscountTest, largeWeightIsPricedInBoundedRange){
+
+    PointOfSale sale;
+
+    ASSERT_EQ( OK, sale.setPerPoundPrice( "Rice", 1.00 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Rice", 1.0, 1.0, 0.5 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Rice", 2.0, 1.0, 0.9 ) );
+
+    // every three pounds but the last two are bought two get one at 90% off, the last two one get one half off
+    ASSERT_EQ( OK, sale.addToCart( "Rice", 200000.0 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 140000.10, .0001 );
+
+    // a limit short of the amount leaves the rest to the other discount
+    ASSERT_EQ( OK, sale.setPerPoundPrice( "Beans", 1.00 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Beans", 1.0, 1.0, 0.5 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Beans", 2.0, 1.0, 0.9, 30000.0 ) );
+    ASSERT_EQ( OK, sale.addToCart( "Beans", 1000000.0 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 140000.10 + 21000.00 + 970000.00 * 0.75, .0001 );
+
+}
+
+TEST (StackedDiscountTest, stackTooWideIsRefused){
+
+    CatalogItem<double> item;
+
+    ASSERT_EQ( OK, item.setPrice( 1.00 ) );
+    ASSERT_EQ( OK, item.addBuyXGetYDiscount( 1.234, 1.0, 0.5 ) );
+
+    // cycles of 2.234 and 3.345 pounds only line up every 7473 pounds
+    ASSERT_EQ( INVALID_DISCOUNT, item.addBuyXGetYDiscount( 2.345, 1.0, 0.5 ) );
+    ASSERT_EQ( BUY_X_GET_Y_FOR_Z_LIMIT_W, getDiscountType( item.getDiscount() ) );
+
+}
+
+TEST (StackedDiscountTest, cheapestCombinationIsCharged){
+
+    PointOfSale sale;
+
+    ASSERT_EQ( OK, sale.setItemPrice( "Chips", 2.00 ) );
+    ASSERT_EQ( OK, sale.addGetXForYDiscount( "Chips", 3, 5.00 ) );
+    ASSERT_EQ( OK, sale.addBuyXGetYAtDiscount( "Chips", 1, 1, 0.5 ) );
+    ASSERT_EQ( OK, sale.addToCart( "Chips", 4 ) );
+
+    // two cycles of buy one get one half off beat a bundle and a single
+    ASSERT_NEAR( sale.getPreTaxTotal(), 6.00, .0001 );
+
+    // a bundle takes three of seven, and buy one get one the other four
+    ASSERT_EQ( OK, sale.addToCart( "Chips", 3 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 5.00 + 6.00, .0001 );
+
+    // applying a discount replaces all of them
+    ASSERT_EQ( OK, sale.applyGetXForYDiscount( "Chips", 3, 5.00 ) );
+    ASSERT_NEAR( sale.getPreTaxTotal(), 10.00 + 2.00, .0001 );
+
+}
+
+TEST (StackedDiscountTest, limitedNumberOfEachType){
+
+    CatalogItem<int> item;
+
+    ASSERT_EQ( OK, item.setPrice( 1.00 ) );
+    for(size_t i = 0; i < MAX_STACKED_DISCOUNTS; i++)
+    {
+        ASSERT_EQ( OK, item.addGetXforPriceDiscount( 2 + static_cast<int>( i ), 1.50 + i ) );
+    }
+    ASSERT_EQ( INVALID_DISCOUNT, item.addGetXforPriceDiscount( 9, 5.00 ) );
+    ASSERT_EQ( OK, item.addBuyXGetYDiscount( 1, 1, 0.25, 8 ) );
+
+    const StackedDiscount& stack = *std::get<SharedStackedDiscount>( item.getDiscount() ).stack;
+    ASSERT_EQ( MAX_STACKED_DISCOUNTS, stack.bundle_count );
+    ASSERT_EQ( 1u, stack.buy_x_get_y_count );
+
+    // invalid values and empty discounts leave the stack as it was
+    ASSERT_EQ( INVALID_DISCOUNT, item.addBuyXGetYDiscount( 1, 1, 1.5 ) );
+    ASSERT_EQ( OK, item.addGetXforPriceDiscount( 0, 1.00 ) );
+    ASSERT_EQ( STACKED_DISCOUNTS, getDiscountType( item.getDiscount() ) );
+    ASSERT_EQ( 1u, std::get<SharedStackedDiscount>( item.getDiscount() ).stack->buy_x_get_y_count );
+
+}
+
+TEST (StackedDiscountTest, kernelsHandLinesToScalar){
+
+    ItemStore<int> items;
+    std::vector<Quantity> amounts;
+
+    for(int i = 0; i < 23; i++)
+    {
+        CatalogItem<int> item;
+        item.setPrice( 1.25 + i );
+        if(i % 2 == 0)
+        {
+            item.addGetXforPriceDiscount( 3, 2.50 + i, 9 );
+            item.addBuyXGetYDiscount( 2, 1, 0.5 );
+        }
+
+        items.append( item );
+        amounts.push_back( i * 3 );
+    }
+
+    Money expected = 0;
+    std::vector<Money> lines( amounts.size() );
+    for(uint32_t i = 0; i < amounts.size(); i++)
+    {
+        ASSERT_EQ( OK, items.computePreTax( i, amounts[i], &lines[i] ) );
+        expected += lines[i];
+    }
+
+    for(PricingKernel_t kernel : { SCALAR_KERNEL, SSE42_KERNEL, AVX2_KERNEL })
+    {
+        std::vector<Money> totals( amounts.size() );
+        ASSERT_EQ( expected, items.computeTotals( amounts.data(), totals.data(), amounts.size(), kernel ) );
+        ASSERT_EQ( lines, totals );
+    }
+
+}
@@ -0,0 +1,317 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Catalog.h"
+#include "StoreEngine.h"
+
+class StoreEngineTest : public ::testing::Test {
+
+protected:
+
+   void SetUp( ) override
+   {
+       std::shared_ptr<Catalog> catalog = std::make_shared<Catalog>();
+
+       catalog->setItemPrice( "Soup", 1.50 );
+       catalog->setItemPrice( "Chips", 2.00 );
+       catalog->setPerPoundPrice( "Beef", 3.50 );
+       catalog->setMarkdown( "Beef", 0.50 );
+       catalog->applyGetXForYDiscount( "Chips", 3, 5.00, 6 );
+
+       for(int i = 0; i < 1000; i++)
+       {
+           catalog->setItemPrice( "SKU" + std::to_string(i), 1.00 + i * 0.01 );
+       }
+
+       engine.reset( new StoreEngine( catalog ) );
+   }
+
+   // checks out the same customer several times on a lane, giving the total of each
+   static void checkout( Lane& lane, int customers, std::vector<Money>* pTotals )
+   {
+       for(int customer = 0; customer < customers; customer++)
+       {
+           lane.newTransaction();
+           lane.addToCart( "Soup", 2 );
+           lane.addToCart( "Chips", 7 );
+           lane.addToCart( "Beef", 3.25 );
+           lane.removeFromCart( "Beef", 0.25 );
+
+           for(int i = 0; i < 1000; i += 37)
+           {
+               lane.addToCart( lane.resolveSku( "SKU" + std::to_string(i) ), 1 );
+           }
+
+           pTotals->push_back( lane.getPreTaxTotalMoney() );
+       }
+   }
+
+   std::unique_ptr<StoreEngine> engine;
+};
+
+TEST_F (StoreEngineTest, lanesAreIndependent){
+
+    std::unique_ptr<Lane> first = engine->openLane();
+    std::unique_ptr<Lane> second = engine->openLane();
+
+    ASSERT_EQ( OK, first->addToCart( "Soup", 2 ) );
+    ASSERT_EQ( OK, second->addToCart( "Beef", 2.0 ) );
+    ASSERT_EQ( NO_PRICE_DEFINED, second->addToCart( "Cookies", 1 ) );
+
+    ASSERT_NEAR( first->getPreTaxTotal(), 3.0, .01 );
+    ASSERT_NEAR( second->getPreTaxTotal(), 6.0, .01 );
+
+    first->newTransaction();
+    ASSERT_NEAR( first->getPreTaxTotal(), 0.0, .01 );
+    ASSERT_NEAR( second->getPreTaxTotal(), 6.0, .01 );
+
+}
+
+TEST_F (StoreEngineTest, laneOutlivesEngine){
+
+    std::unique_ptr<Lane> lane = engine->openLane();
+    engine.reset();
+
+    ASSERT_EQ( OK, lane->addToCart( "Chips", 3 ) );
+    ASSERT_NEAR( lane->getPreTaxTotal(), 5.0, .01 );
+
+}
+
+TEST_F (StoreEngineTest, concurrentLanesMatchSingleLane){
+
+    const int THREADS = 8;
+    const int CUSTOMERS = 50;
+
+    std::vector<Money> expected;
+    std::unique_ptr<Lane> reference = engine->openLane();
+    checkout( *reference, 1, &expected );
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::vector<std::vector<Money>> totals( THREADS );
+    std::vector<std::thread> threads;
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        lanes.push_back( engine->openLane() );
+    }
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        threads.emplace_back( checkout, std::ref( *lanes[i] ), CUSTOMERS, &totals[i] );
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        ASSERT_EQ( static_cast<size_t>( CUSTOMERS ), totals[i].size() );
+        for(Money total : totals[i])
+        {
+            ASSERT_EQ( expected[0], total );
+        }
+    }
+
+}
+
+TEST_F (StoreEngineTest, customerKeepsVersionUntilNextTransaction){
+
+    std::unique_ptr<Lane> lane = engine->openLane();
+
+    ASSERT_EQ( OK, lane->addToCart( "Soup", 2 ) );
+    ASSERT_EQ( OK, engine->update( []( Catalog& catalog ){ return catalog.setItemPrice( "Soup", 3.00 ); } ) );
+    ASSERT_EQ( 2u, engine->getVersion() );
+
+    // the customer being checked out keeps the price they started with
+    ASSERT_EQ( OK, lane->addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( lane->getPreTaxTotal(), 4.50, .01 );
+    ASSERT_EQ( 1u, lane->getVersion() );
+
+    // a lane opened after the change gets the new price straight away
+    std::unique_ptr<Lane> later = engine->openLane();
+    ASSERT_EQ( OK, later->addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( later->getPreTaxTotal(), 3.00, .01 );
+
+    lane->newTransaction();
+    ASSERT_EQ( 2u, lane->getVersion() );
+    ASSERT_EQ( OK, lane->addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( lane->getPreTaxTotal(), 3.00, .01 );
+
+}
+
+TEST_F (StoreEngineTest, failedUpdateIsNotPublished){
+
+    std::unique_ptr<Lane> lane = engine->openLane();
+
+    // the first change is discarded along with the one that failed
+    ReturnCode_t code = engine->update( []( Catalog& catalog )
+    {
+        catalog.setItemPrice( "Soup", 3.00 );
+        return catalog.setMarkdown( "Chips", 5.00 );
+    } );
+
+    ASSERT_EQ( INVALID_PRICE, code );
+    ASSERT_EQ( 1u, engine->getVersion() );
+
+    lane->newTransaction();
+    ASSERT_EQ( OK, lane->addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( lane->getPreTaxTotal(), 1.50, .01 );
+
+}
+
+TEST_F (StoreEngineTest, replacedVersionsFreedOnceLanesMoveOn){
+
+    std::unique_ptr<Lane> busy = engine->openLane();
+    std::unique_ptr<Lane> other = engine->openLane();
+
+    ASSERT_EQ( OK, busy->addToCart( "Chips", 1 ) );
+    ASSERT_EQ( OK, other->addToCart( "Chips", 1 ) );
+    for(int i = 0; i < 3; i++)
+    {
+        ASSERT_EQ( OK, engine->update( [i]( Catalog& catalog ){ return catalog.setItemPrice( "Soup", 2.00 + i ); } ) );
+    }
+
+    // both customers are still priced against the first version, so nothing can be freed
+    ASSERT_EQ( 3u, engine->getRetiredCount() );
+
+    busy->newTransaction();
+    other.reset();
+    engine->reclaim();
+    ASSERT_EQ( 0u, engine->getRetiredCount() );
+    ASSERT_EQ( 4u, busy->getVersion() );
+
+    ASSERT_EQ( OK, busy->addToCart( "Soup", 1 ) );
+    ASSERT_NEAR( busy->getPreTaxTotal(), 4.00, .01 );
+
+}
+
+TEST_F (StoreEngineTest, idleLanesDoNotHoldVersions){
+
+    const int UPDATES = 100;
+
+    std::unique_ptr<Lane> unused = engine->openLane();
+    std::unique_ptr<Lane> finished = engine->openLane();
+
+    ASSERT_EQ( OK, finished->addToCart( "Soup", 1 ) );
+    finished->newTransaction();
+
+    // neither lane has a customer, so every replaced version is freed as soon as it is replaced
+    for(int i = 0; i < UPDATES; i++)
+    {
+        ASSERT_EQ( OK, engine->update( [i]( Catalog& catalog ){ return catalog.setItemPrice( "Soup", 2.00 + i * 0.01 ); } ) );
+        ASSERT_EQ( 0u, engine->getRetiredCount() );
+        ASSERT_NE( INVALID_SKU_HANDLE, unused->resolveSku( "Soup" ) );
+    }
+
+    // the next customer on either lane gets the latest version
+    ASSERT_EQ( static_cast<uint64_t>( UPDATES + 1 ), unused->getVersion() );
+    ASSERT_EQ( OK, unused->addToCart( "Soup", 1 ) );
+    ASSERT_EQ( 29900, unused->getPreTaxTotalMoney() );
+    ASSERT_EQ( 0, finished->getPreTaxTotalMoney() );
+    ASSERT_EQ( OK, finished->addToCart( "Soup", 1 ) );
+    ASSERT_EQ( 29900, finished->getPreTaxTotalMoney() );
+
+}
+
+TEST_F (StoreEngineTest, lanesNeverSeeHalfAnUpdate){
+
+    const int THREADS = 4;
+    const int CUSTOMERS = 500;
+    const int UPDATES = 50;
+
+    // every later version v sells both Soup and Chips at 1.00 + v cents, so each customer's
+    // total is fixed by the version they were priced against
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::vector<int> mismatches( THREADS, 0 );
+    std::vector<std::thread> threads;
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        lanes.push_back( engine->openLane() );
+    }
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        threads.emplace_back( [&lanes, &mismatches, i, CUSTOMERS]()
+        {
+            Lane& lane = *lanes[i];
+            for(int customer = 0; customer < CUSTOMERS; customer++)
+            {
+                lane.newTransaction();
+                lane.addToCart( "Soup", 1 );
+                lane.addToCart( "Chips", 1 );
+
+                Money version = static_cast<Money>( lane.getVersion() );
+                Money expected = (version == 1) ? 35000 : 2 * (10000 + 100 * version);
+                if(lane.getPreTaxTotalMoney() != expected)
+                {
+                    mismatches[i]++;
+                }
+            }
+        } );
+    }
+
+    for(int update = 0; update < UPDATES; update++)
+    {
+        double price = 1.00 + (update + 2) * 0.01;
+        EXPECT_EQ( OK, engine->update( [price]( Catalog& catalog )
+        {
+            catalog.setItemPrice( "Soup", price );
+            return catalog.setItemPrice( "Chips", price );
+        } ) );
+    }
+
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for(int i = 0; i < THREADS; i++)
+    {
+        ASSERT_EQ( 0, mismatches[i] );
+    }
+    ASSERT_EQ( static_cast<uint64_t>( UPDATES + 1 ), engine->getVersion() );
+
+}
+
+TEST_F (StoreEngineTest, concurrentWritersKeepEveryChange){
+
+    const int WRITERS = 4;
+    const int UPDATES = 100;
+
+    // each update adds its own sku, so a version copied before another writer published would drop one
+    std::vector<std::thread> writers;
+    for(int writer = 0; writer < WRITERS; writer++)
+    {
+        writers.emplace_back( [this, writer, UPDATES]()
+        {
+            for(int update = 0; update < UPDATES; update++)
+            {
+                std::string sku = "Writer" + std::to_string( writer ) + "-" + std::to_string( update );
+                EXPECT_EQ( OK, engine->update( [&sku]( Catalog& catalog ){ return catalog.setItemPrice( sku, 1.00 ); } ) );
+            }
+        } );
+    }
+
+    for(std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    ASSERT_EQ( static_cast<uint64_t>( WRITERS * UPDATES + 1 ), engine->getVersion() );
+
+    std::shared_ptr<const Catalog> catalog = engine->getCatalog();
+    for(int writer = 0; writer < WRITERS; writer++)
+    {
+        for(int update = 0; update < UPDATES; update++)
+        {
+            ASSERT_TRUE( catalog->isFixedItem( "Writer" + std::to_string( writer ) + "-" + std::to_string( update ) ) );
+        }
+    }
+
+}
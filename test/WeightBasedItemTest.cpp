@@ -272,4 +272,28 @@ TEST (WeightBasedItemTest, buyNGetMOffWithMarkdownWithLimit){
     ASSERT_EQ( OK, item.computePreTax( &tax ));
     ASSERT_NEAR( tax, 18, .01 ); // 12 + 6
 
-}
\ No newline at end of file
+}
+
+TEST (WeightBasedItemTest, buyNGetMOffSmallIncrementLargeWeight){
+
+    double tax = 0.0;
+    CartItem<double> item;
+    ASSERT_EQ( OK, item.setPrice(2.0));
+    ASSERT_EQ( OK, item.addToCart( 1000.0 ) );
+    ASSERT_EQ( OK, item.applyBuyXGetYDiscount( 0.01, 0.01, 0.5 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 1500.0, .05 ); // half of the weight is discounted by half
+
+}
+
+TEST (WeightBasedItemTest, buyNForXSmallIncrementLargeWeight){
+
+    double tax = 0.0;
+    CartItem<double> item;
+    ASSERT_EQ( OK, item.setPrice(2.0));
+    ASSERT_EQ( OK, item.addToCart( 1000.0 ) );
+    ASSERT_EQ( OK, item.applyGetXforPriceDiscount( 0.25, 0.25, 500.0 ) );
+    ASSERT_EQ( OK, item.computePreTax( &tax ));
+    ASSERT_NEAR( tax, 1500.0, .05 ); // first 500 pounds at 1.00, rest at 2.00
+
+}
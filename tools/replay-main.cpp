@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Money.h"
+#include "PointOfSale.h"
+#include "ReplayLog.h"
+
+// Replays recorded PointOfSale logs against the library, checking every recorded total and the result of
+// every call, and reporting the throughput and latency of the calls. Each log is replayed on its own new
+// PointOfSale.
+//
+//     PointOfSale_replay [--paced] [--repeat N] log...
+//
+// Each line of a log is time_us,event,sku,value, see ReplayLog. Times must never decrease. An amount with a
+// decimal point is a weight in pounds and one without is a count of items, so a weight of two pounds is 2.0.
+//
+// Exits with 0 when every total matched and every call returned OK, 1 when any total did not match or any
+// call failed, and 2 when a log could not be read.
+
+static void usage()
+{
+    std::fprintf( stderr, "usage: PointOfSale_replay [--paced] [--repeat N] log...\n"
+                          "  --paced     wait until each event is due instead of replaying as fast as possible\n"
+                          "  --repeat N  replay each log N times and report every pass\n"
+                          "each line of a log is time_us,event,sku,value with times that never decrease;\n"
+                          "an amount with a decimal point is a weight in pounds (2.0), without one a count (2)\n" );
+}
+
+int main( int argc, char** argv )
+{
+    bool paced = false;
+    long repeat = 1;
+    std::vector<std::string> paths;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp( argv[i], "--paced" ) == 0)
+        {
+            paced = true;
+        }
+        else if(std::strcmp( argv[i], "--repeat" ) == 0 && i + 1 < argc)
+        {
+            repeat = std::strtol( argv[++i], 0, 10 );
+        }
+        else if(argv[i][0] == '-' || repeat < 1)
+        {
+            usage();
+            return 2;
+        }
+        else
+        {
+            paths.push_back( argv[i] );
+        }
+    }
+
+    if(paths.empty() || repeat < 1)
+    {
+        usage();
+        return 2;
+    }
+
+    int status = 0;
+    for(const std::string& path : paths)
+    {
+        ReplayLog log;
+        size_t line = 0;
+
+        ReturnCode_t code = log.loadFile( path, &line );
+        if(code == INVALID_ARG)
+        {
+            std::fprintf( stderr, "%s: cannot be opened\n", path.c_str() );
+            return 2;
+        }
+        if(code != OK)
+        {
+            std::fprintf( stderr, "%s:%zu: malformed event\n", path.c_str(), line );
+            return 2;
+        }
+
+        for(long pass = 0; pass < repeat; pass++)
+        {
+            PointOfSale sale;
+            ReplayReport report;
+            log.replay( sale, paced, &report );
+
+            std::printf( "%s: %zu events in %.3f s, %.0f events/s\n", path.c_str(), report.events, report.seconds,
+                         report.events_per_second );
+            std::printf( "  latency ns: p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n", report.latency_p50,
+                         report.latency_p90, report.latency_p99, report.latency_p999, report.latency_max );
+            std::printf( "  totals: %zu checked, %zu mismatched\n", report.totals_checked, report.mismatches.size() );
+            std::printf( "  calls: %zu failed\n", report.calls_failed );
+
+            for(size_t op = 0; op < REPLAY_OP_COUNT; op++)
+            {
+                if(report.failed[op] > 0)
+                {
+                    std::printf( "    %s: %zu failed\n", ReplayLog::getEventName( static_cast<ReplayOp_t>( op ) ),
+                                 report.failed[op] );
+                    status = 1;
+                }
+            }
+
+            for(const ReplayMismatch& mismatch : report.mismatches)
+            {
+                std::printf( "  %s:%zu: expected %.4f, got %.4f\n", path.c_str(), mismatch.line,
+                             toDollars( mismatch.expected ), toDollars( mismatch.actual ) );
+                status = 1;
+            }
+        }
+    }
+
+    return status;
+}